@@ -102,6 +102,90 @@ typedef enum {
   HDSTYPE_STRUCTURE
 } hdstype_t;
 
+/* Properties of a conversion between two hdstype_t values, as
+   returned by dat1ConvFlags() */
+#define HDS__CONV_EXISTS   0x01  /* Conversion is possible */
+#define HDS__CONV_LOSSLESS 0x02  /* All input values are exactly representable */
+#define HDS__CONV_IDENTITY 0x04  /* Same representation in memory and file */
+#define HDS__CONV_CHAR     0x08  /* Converted by dat1CvtChar rather than HDF5 */
+#define HDS__CONV_LOGICAL  0x10  /* Converted by dat1CvtLogical rather than HDF5 */
+
+/* Expected pattern of access to mapped data, as set by datMapAdvise() */
+typedef enum {
+  HDS__ADV_DEFAULT = 0, /* Chosen from the size of the data */
+  HDS__ADV_NORMAL,      /* No particular pattern */
+  HDS__ADV_SEQUENTIAL,  /* Read from start to end */
+  HDS__ADV_RANDOM,      /* Random access */
+  HDS__ADV_WILLNEED,    /* Whole region needed soon */
+  HDS__ADV_HUGEPAGE     /* Back the mapping with huge pages */
+} hds_advice_t;
+
+/* Operations that are timed when statistics are gathered (see hdsstats.c,
+   which holds their names in the same order) */
+typedef enum {
+  HDS__STAT_DATANNUL = 0,
+  HDS__STAT_DATBASIC,
+  HDS__STAT_DATCELL,
+  HDS__STAT_DATCOPY,
+  HDS__STAT_DATERASE,
+  HDS__STAT_DATFIND,
+  HDS__STAT_DATGET,
+  HDS__STAT_DATGETBATCH,
+  HDS__STAT_DATGETREGION,
+  HDS__STAT_DATINDEX,
+  HDS__STAT_DATMAP,
+  HDS__STAT_DATNEW,
+  HDS__STAT_DATPREFETCH,
+  HDS__STAT_DATPUT,
+  HDS__STAT_DATPUTBATCH,
+  HDS__STAT_DATSLICE,
+  HDS__STAT_DATUNMAP,
+  HDS__STAT_HDSNEW,
+  HDS__STAT_HDSOPEN,
+  HDS__STAT_H5DREAD,    /* Reading primitive data from HDF5 */
+  HDS__STAT_H5DWRITE,   /* Writing primitive data to HDF5 */
+  HDS__STAT_MMAP,       /* Mapping primitive data from the file */
+  HDS__STAT_CONVERT,    /* Conversions done by HDS rather than HDF5 */
+  HDS__STAT_LOCKWAIT,   /* Waiting for a Handle mutex held by another thread */
+  HDS__STAT_MAX
+} hds_stat_t;
+
+/* Kinds of transfer counted for each container file by dat1CountIO */
+typedef enum {
+  HDS__IO_READ = 0,     /* Primitive data read from the file */
+  HDS__IO_WRITE,        /* Primitive data written to the file */
+  HDS__IO_MMAP,         /* Primitive mapped directly from the file */
+  HDS__IO_UNMAP,        /* ... and unmapped again */
+  HDS__IO_COPYMAP,      /* Primitive mapped by copying it into memory */
+  HDS__IO_UNCOPYMAP     /* ... and unmapped again */
+} hds_io_t;
+
+/* Run time metrics that are always kept (see hdsstats.c). Reported by
+   hdsInfoI and hdsMetrics. */
+typedef struct HdsMetrics {
+  size_t nhandle;         /* Number of Handles in existence */
+  size_t nmmap;           /* Number of primitives mapped from the file */
+  size_t ncopymap;        /* Number of primitives mapped by copying */
+  size_t bytes_mmap;      /* Bytes currently mapped from the file */
+  size_t bytes_copymap;   /* Bytes currently mapped by copying */
+  size_t nlockwait;       /* Number of waits for a Handle mutex */
+  uint64_t lockwait_ns;   /* Total time spent waiting for Handle mutexes */
+  size_t nconvert[HDSTYPE_STRUCTURE][HDSTYPE_STRUCTURE]; /* Elements
+                             converted, indexed by [from][to] type */
+} HdsMetrics;
+
+/* Start and finish timing an operation. "t" is a uint64_t that is zero
+   unless statistics are being gathered or operations traced, and
+   "nbytes" and "handle" (the Handle of the object concerned, or NULL)
+   are only evaluated if they are. "hds1StatsOn" holds the following
+   flags. */
+#define HDS__STATS_COUNT 1     /* Gathering statistics (STATS) */
+#define HDS__STATS_TRACE 2     /* Tracing operations (HDS_TRACE_FILE) */
+extern int hds1StatsOn;
+#define HDS1_STATS_BEGIN(t) ((t) = (hds1StatsOn ? hds1StatsTime() : 0))
+#define HDS1_STATS_END(id,t,nbytes,handle) \
+  do { if (t) hds1StatsAdd( (id), (t), (nbytes), (handle) ); } while (0)
+
 /* Which shell should be used when expanding environment
    variables. Not all HDS supported shells are supported
    by this library.
@@ -139,6 +223,17 @@ typedef enum {
 #define HDS__ATTR_ROOT_NAME "HDS_ROOT_NAME"
 #define HDS__ATTR_ROOT_PRIMITIVE "HDS_ROOT_IS_PRIMITIVE"
 
+/* Totals of the data transferred to and from a container file, held in
+   its top level Handle and reported by hdsShow("DATA"). */
+typedef struct HdsFileIO {
+   size_t nread;            /* Number of reads */
+   size_t nwrite;           /* Number of writes */
+   size_t bytes_read;       /* Number of bytes read */
+   size_t bytes_written;    /* Number of bytes written */
+   size_t bytes_mmap;       /* Bytes currently mapped directly from the file */
+   size_t bytes_copymap;    /* Bytes currently mapped by copying */
+} HdsFileIO;
+
 /* This structure  contains information about an HDF5 object (group or
    dataset) that is common to all the locators that refer to the object. */
 typedef struct Handle {
@@ -159,11 +254,31 @@ typedef struct Handle {
                                before using the locator */
    struct Handle *check;    /* Used to test validity of the Handle */
    hdsbool_t erase;         /* Erase file after it is closed? */
+   hdsbool_t toplevel;      /* Describes the top-level object in the file? */
+   char *path;              /* Cached HDS path of the object (or NULL) */
+   int nlev;                /* Number of levels in "path" */
+   char *file;              /* Cached file name (top level Handle only) */
+   int nwrites;             /* Number of background writes pending (see
+                               hdsasync.c) */
+   int nwrites_file;        /* Number of background writes pending to any
+                               object in the file (top level Handle only,
+                               see hdsasync.c) */
+   unsigned long nwritten;  /* Incremented before each write to the object,
+                               so that stale prefetches can be detected
+                               (see hdsasync.c) */
+   HdsFileIO io;            /* Data transferred (top level Handle only).
+                               Guarded by "mutex". */
+   hid_t fd_file_id;        /* HDF5 file for which "fd" was obtained, or 0
+                               (top level Handle only, see dat1Advise.c).
+                               Guarded by "mutex". */
+   int fd;                  /* File descriptor of the container file, or -1
+                               if the file driver does not provide one */
 } Handle;
 
 /* Preliminary definition of (currently undefined) structures used in the
    following HDSLoc structure. */
 struct HdsFile;
+struct HdsAsyncIO;
 struct LOC;
 
 /* Private definition of the HDS locator struct */
@@ -193,6 +308,11 @@ typedef struct LOC {
   hdsbool_t uses_true_mmap;  /* Indicates that we have true mmap [datMap only] */
   int fdmap;  /* File descriptor for mapped data (can free if >0) [datMap only] */
   char maptype[DAT__SZTYP+1]; /* HDS type string used for memory mapping [datMap only] */
+  hdsbool_t isbasic; /* Mapped as raw bytes by datBasic [datMap only] */
+  struct HdsAsyncIO *prefetch; /* Pending asynchronous read [datPrefetch only] */
+  hds_advice_t advice; /* Expected access pattern [datMapAdvise only] */
+  hdsbool_t ishuge;  /* Buffer allocated by hds1HugeAlloc [datMap only] */
+  size_t datasize;   /* Bytes of data counted as mapped by dat1CountIO [datMap only] */
   char grpname[DAT__SZGRP+1]; /* Name of group associated with locator */
 } HDSLoc;
 
@@ -207,6 +327,31 @@ typedef struct HdsFile {
    UT_hash_handle hh;  /* Mandatory for UTHASH */
 } HdsFile;
 
+/* A read or write performed by the I/O thread in hdsasync.c. Reads are
+   requested by datPrefetch and claimed by datGet or datMap. Writes are
+   handed over by datUnmap when write-behind is enabled and are freed by
+   the I/O thread once complete. */
+typedef struct HdsAsyncIO {
+   pthread_mutex_t mutex;   /* Guards "done" and "status" [reads only] */
+   pthread_cond_t cond;     /* Signalled when a read has completed */
+   hdsbool_t writing;       /* Is this a write? */
+   hdsbool_t done;          /* Has the read completed? */
+   int status;              /* Status of the transfer */
+   hid_t dataset_id;        /* Dataset (a reference of its own) */
+   hid_t filespace_id;      /* Copy of the locator's dataspace selection */
+   hid_t memtype;           /* Data type in memory */
+   hid_t dxpl;              /* Transfer property list (from dat1XferProps) */
+   unsigned long nwritten;  /* Value of the Handle's "nwritten" when a read
+                               was queued */
+   char type[DAT__SZTYP+1]; /* Normalised HDS type string for "memtype" */
+   void *buffer;            /* Data buffer (from cnfMalloc) */
+   size_t nbytes;           /* Size of "buffer" in bytes */
+   Handle *handle;          /* Handle for the object being transferred */
+   Handle *top;             /* Top level Handle of its file [writes only] */
+   char name[DAT__SZNAM+1]; /* Name of the object being written */
+   struct HdsAsyncIO *next; /* Next request in the queue */
+} HdsAsyncIO;
+
 /* This structure contains information about data types.
    Values are obtained by use dat1TypeInfo(). */
 typedef struct HdsTypeInfo {
@@ -289,6 +434,11 @@ dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type,
              const char * name_str, hid_t * dataset_id, hid_t *dataspace_id, int *status );
 
 hid_t dat1Reopen( hid_t file_id, unsigned int flags, hid_t fapl, int *status );
+hid_t dat1GroupProps( hid_t loc_id, int *status );
+hid_t dat1XferProps( int *status );
+
+void dat1FileProps( const char *fname, hdsbool_t create, hid_t *fcpl,
+                    hid_t *fapl, int *status );
 hid_t dat1RetrieveContainer( const HDSLoc *locator, int * status );
 hid_t dat1RetrieveIdentifier( const HDSLoc * locator, int * status );
 
@@ -299,6 +449,40 @@ void dat1DumpLoc( const char *text, const HDSLoc * locator, int * status );
 hdstype_t
 dat1Type( const HDSLoc *locator, int * status );
 
+int
+dat1ConvFlags( hdstype_t intype, hdstype_t outtype );
+
+void
+dat1BatchIO( const char *func, const HDSLoc *locator, hdsbool_t writing,
+             size_t nitem, HDSBatchItem items[], int *status );
+
+hdstype_t
+dat1TypeStr( hid_t objid, char type_str[DAT__SZTYP+1], int *status );
+
+void *
+dat1MmapDataset( HDSLoc *locator, hdsmode_t accmode, unsigned intent,
+                 haddr_t offset, size_t nbytes, int *isreg,
+                 void **regpntr, size_t *actbytes, int *status );
+
+void
+dat1Advise( const HDSLoc *locator, void *mapped, size_t maplen,
+            haddr_t offset, size_t nbytes, int *status );
+
+void
+dat1CountIO( Handle *handle, hds_io_t type, size_t nbytes );
+
+void
+dat1BasicIO( const HDSLoc *locator, hdsbool_t writing, void *buffer,
+             int *status );
+
+void
+dat1RecreatePrim( const char *func, HDSLoc *locator, hid_t h5type,
+                  int ndim, const hdsdim dims[], int *status );
+
+HDSLoc *
+dat1ObjectLoc( const char *func, const HDSLoc *locator1, Handle *parent,
+               const char *name, hid_t objid, int *status );
+
 int
 dat1IsStructure( const HDSLoc * locator, int * status );
 
@@ -386,6 +570,95 @@ hds1FreeHdsFile( HdsFile *hdsFile, int *status );
 void
 hds1ShowFiles( hdsbool_t listfiles, hdsbool_t listlocs, int * status );
 
+void
+hds1ShowData( int * status );
+
+void
+hds1PrefetchQueue( HdsAsyncIO *prefetch, int *status );
+
+hdsbool_t
+hds1PrefetchTake( HDSLoc *locator, const char *type, void **buffer,
+                  size_t *nbytes );
+
+void
+hds1PrefetchDiscard( HDSLoc *locator );
+
+hdsbool_t
+hds1WriteBehind( HDSLoc *locator, int *status );
+
+void
+hds1WriteWait( const Handle *handle, int *status );
+
+void
+hds1WriteWaitFile( const Handle *handle, int *status );
+
+void
+hds1WriteNote( Handle *handle );
+
+hdsbool_t
+hds1ChunkIO( const HDSLoc *locator, hid_t h5type, hdsbool_t writing,
+             void *buffer, int *status );
+
+void *
+hds1WindowMap( size_t nbytes, int prot, int flags, int fd, off_t off );
+
+int
+hds1Munmap( void *addr, size_t nbytes );
+
+void *
+hds1HugeAlloc( size_t nbytes, size_t *actbytes );
+
+int
+hds1HugeFree( void *buf, size_t actbytes );
+
+size_t
+hds1HugeCount( void );
+
+uint64_t
+hds1StatsTime( void );
+
+void
+hds1StatsAdd( hds_stat_t stat, uint64_t start, size_t nbytes,
+              const Handle *handle );
+
+void
+hds1StatsSpan( hds_stat_t stat, uint64_t start, uint64_t end, size_t nbytes,
+               const Handle *handle );
+
+void
+hds1StatsEnable( hdsbool_t enable );
+
+size_t
+hds1StatsShow( hdsbool_t reset );
+
+void
+hds1MetricsHandle( int delta );
+
+void
+hds1MetricsMap( hds_io_t type, size_t nbytes );
+
+void
+hds1MetricsConvert( hdstype_t from, hdstype_t to, size_t nelem );
+
+uint64_t
+hds1MetricsClock( void );
+
+void
+hds1MetricsLockWait( uint64_t start );
+
+void
+hds1MetricsCopy( HdsMetrics *copy );
+
+hdsbool_t
+hds1TraceStart( void );
+
+void
+hds1TraceAdd( const char *name, uint64_t start, uint64_t end, size_t nbytes,
+              const Handle *handle );
+
+void
+hds1TraceWrite( void );
+
 int
 hds1CountFiles();
 
@@ -451,6 +724,23 @@ void dat1Getenv( const char *varname, int def, int *val );
 hdsbool_t hds1GetUseMmap();
 hdsbool_t hds1GetLockCheck();
 hds_shell_t hds1GetShell();
+hdsbool_t hds1GetCompact();
+int hds1GetPageBuf();
+int hds1GetWriteBehind();
+int hds1GetHugePage();
+hdsbool_t hds1GetStats();
+int hds1GetChunk();
+int hds1GetCompress();
+int hds1GetChunkCache();
+int hds1GetMdCache();
+int hds1GetSieveBuf();
+int hds1GetNblocks();
+int hds1GetNcom();
+int hds1GetInal();
+int hds1GetHyperVec();
+int hds1GetChunkIO();
+int hds1TuneFile( const char *fname, const char *param, int value );
+int hds1TuneObject( hid_t objid, const char *param, int value );
 
 int dat1Annul( HDSLoc *locator, int * status );
 hid_t dat1GetParentID( hid_t objid, hdsbool_t allow_root, int *status );
@@ -464,7 +754,11 @@ dat1NeedsRootName( hid_t objid, hdsbool_t wantprim, char * rootname, size_t root
 
 Handle *dat1Handle( const HDSLoc *parent_loc, const char *name, int
 rdonly, int * status );
+Handle *dat1HandleChild( Handle *parent, const char *name, int rdonly,
+                         int * status );
 Handle *dat1EraseHandle( Handle *parent, const char *name, int * status );
+char *dat1HandlePath( Handle *handle, hid_t objid, int asfile, int *nlev, int *status );
+void dat1MoveHandle( Handle *handle, Handle *newparent, const char *name, int *status );
 Handle *dat1FreeHandle( Handle *handle, int *status );
 int dat1ValidateLocator( const char *func, int checklock, const HDSLoc *loc, int rdonly, int *status );
 Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly, int *result, int *status );
@@ -0,0 +1,239 @@
+/*
+*+
+*  Name:
+*     dat1Advise
+
+*  Purpose:
+*     Give the kernel a hint about how mapped data will be accessed
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1Advise( const HDSLoc *locator, void *mapped, size_t maplen,
+*                 haddr_t offset, size_t nbytes, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Primitive locator. Its "advice" component holds the access
+*        pattern requested by datMapAdvise.
+*     mapped = void * (Given)
+*        Page-aligned start of a region obtained from mmap(), or NULL if
+*        the data are to be read into ordinary memory.
+*     maplen = size_t (Given)
+*        Length of the mapped region in bytes. Ignored if "mapped" is NULL.
+*     offset = haddr_t (Given)
+*        Offset of the contiguous dataset within the file. HADDR_UNDEF if
+*        the dataset is not stored contiguously.
+*     nbytes = size_t (Given)
+*        Number of bytes of data that will be accessed.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     If "mapped" is not NULL, madvise() is called for the mapped region.
+*     Otherwise, posix_fadvise() is called for the part of the file that is
+*     about to be read. If no access pattern has been requested for the
+*     locator using datMapAdvise, large arrays are expected to be read from
+*     start to end (SEQUENTIAL) and nothing is done for smaller arrays,
+*     for which the default behaviour of the kernel is adequate and the
+*     cost of the extra system calls would not be repaid.
+
+*  Notes:
+*     - The hints are only advisory and any failure to apply them is
+*       ignored. Patterns not supported by the operating system are
+*       silently skipped.
+*     - posix_fadvise() is only used when the file descriptor can be
+*       obtained from the HDF5 file driver. The descriptor is cached in
+*       the top level Handle of the file, so the file driver is only
+*       queried once for each open file.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* Arrays at least this big default to sequential access. Smaller arrays
+   are given no advice unless it was requested. */
+#define DAT1_ADVISE_SEQBYTES (4*1024*1024)
+
+static int dat1AdviseFd( const HDSLoc *locator, int *status );
+
+void
+dat1Advise( const HDSLoc *locator, void *mapped, size_t maplen,
+            haddr_t offset, size_t nbytes, int *status ) {
+  hds_advice_t advice;
+
+  if (*status != SAI__OK) return;
+
+  advice = locator->advice;
+  if (advice == HDS__ADV_DEFAULT) {
+    if (nbytes < DAT1_ADVISE_SEQBYTES) return;
+    advice = HDS__ADV_SEQUENTIAL;
+  }
+
+  if (mapped) {
+    int madv = -1;
+    switch (advice) {
+    case HDS__ADV_NORMAL:
+      madv = MADV_NORMAL;
+      break;
+    case HDS__ADV_SEQUENTIAL:
+      madv = MADV_SEQUENTIAL;
+      break;
+    case HDS__ADV_RANDOM:
+      madv = MADV_RANDOM;
+      break;
+    case HDS__ADV_WILLNEED:
+      madv = MADV_WILLNEED;
+      break;
+#ifdef MADV_HUGEPAGE
+    case HDS__ADV_HUGEPAGE:
+      madv = MADV_HUGEPAGE;
+      break;
+#endif
+    default:
+      break;
+    }
+    if (madv >= 0) (void)madvise( mapped, maplen, madv );
+
+  } else if (offset != HADDR_UNDEF) {
+#ifdef POSIX_FADV_NORMAL
+    int fadv = -1;
+    int fd = -1;
+
+    switch (advice) {
+    case HDS__ADV_NORMAL:
+      fadv = POSIX_FADV_NORMAL;
+      break;
+    case HDS__ADV_SEQUENTIAL:
+      fadv = POSIX_FADV_SEQUENTIAL;
+      break;
+    case HDS__ADV_RANDOM:
+      fadv = POSIX_FADV_RANDOM;
+      break;
+    case HDS__ADV_WILLNEED:
+      fadv = POSIX_FADV_WILLNEED;
+      break;
+    default:
+      /* Huge pages only make sense for a mapping */
+      break;
+    }
+    if (fadv < 0) return;
+
+    fd = dat1AdviseFd( locator, status );
+    if (fd >= 0) (void)posix_fadvise( fd, (off_t)offset, (off_t)nbytes, fadv );
+#endif
+  }
+
+}
+
+/* Return the file descriptor for the container file, or -1 if it is not
+   available. The descriptor is obtained from the HDF5 file driver the
+   first time it is needed for an open file, and is then cached in the top
+   level Handle. The HDF5 file identifier is cached with it so that the
+   descriptor is obtained afresh if the file is re-opened. */
+static int dat1AdviseFd( const HDSLoc *locator, int *status ) {
+  Handle *top;
+  hid_t fapl_id = -1;
+  hid_t fdriv_id = -1;
+  void * file_handle = NULL;
+  hdsbool_t cached;
+  int fd = -1;
+
+  if (*status != SAI__OK || locator->file_id <= 0) return -1;
+
+  top = dat1TopHandle( locator->handle, status );
+  if (!top) return -1;
+
+  pthread_mutex_lock( &(top->mutex) );
+  cached = ( top->fd_file_id == locator->file_id );
+  if (cached) fd = top->fd;
+  pthread_mutex_unlock( &(top->mutex) );
+  if (cached) return fd;
+
+  /* Only the POSIX and STDIO drivers give us a descriptor */
+  fapl_id = H5Fget_access_plist( locator->file_id );
+  if (fapl_id < 0) return -1;
+  fdriv_id = H5Pget_driver( fapl_id );
+  if (fdriv_id == H5FD_SEC2 || fdriv_id == H5FD_STDIO) {
+    if (H5Fget_vfd_handle( locator->file_id, fapl_id, &file_handle ) >= 0 &&
+        file_handle) {
+      if (fdriv_id == H5FD_SEC2) {
+        fd = *((int *)file_handle);
+      } else {
+        fd = fileno( (FILE *)file_handle );
+      }
+    }
+  }
+  H5Pclose( fapl_id );
+
+  pthread_mutex_lock( &(top->mutex) );
+  top->fd_file_id = locator->file_id;
+  top->fd = fd;
+  pthread_mutex_unlock( &(top->mutex) );
+
+  return fd;
+}
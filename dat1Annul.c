@@ -167,6 +167,12 @@ int dat1Annul( HDSLoc *locator, int * status ) {
 /* Annul the supplied locator. */
    dat1Anloc( locator, status );
 
+/* Any writes to the file still being made in the background, including
+   those started by unmapping locators that have just been annulled, must
+   be completed before it is closed. This is where errors from them are
+   reported if nothing else has waited for them. */
+   if( tophandle ) hds1WriteWaitFile( tophandle, status );
+
 /* If required, close all HDF5 identifiers associated with the file. */
    if( file_id ) dat1CloseAllIds( file_id, status );
 
@@ -226,6 +232,9 @@ static void dat1Anloc( HDSLoc *locator, int * status ) {
 /* Sort out any memory mapping */
    datUnmap( locator, status );
 
+/* Wait for any background read to finish before closing the dataset */
+   hds1PrefetchDiscard( locator );
+
 /* Free HDF5 resources. We zero them out so that unregistering the locator
    does not cause confusion */
    if( locator->dtype ){
@@ -0,0 +1,158 @@
+/*
+*+
+*  Name:
+*     dat1BasicIO
+
+*  Purpose:
+*     Read or write the stored bytes of a primitive without conversion
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1BasicIO( const HDSLoc *locator, hdsbool_t writing, void *buffer,
+*                       int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Primitive locator. May refer to a slice.
+*     writing = hdsbool_t (Given)
+*        If true, copy the buffer into the dataset. Otherwise copy the
+*        dataset into the buffer.
+*     buffer = void * (Given and Returned)
+*        Buffer holding the bytes of every selected element, in the order
+*        they are stored. Each element occupies the number of bytes used in
+*        the file (see datLen).
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Transfers the elements of a primitive using the data type of the
+*     dataset itself as the memory type, so that HDF5 performs no type
+*     conversion. This gives datBasic the raw stored bytes whenever the
+*     dataset can not be memory mapped directly (for example, because it is
+*     chunked or compressed, or is a slice).
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+void
+dat1BasicIO( const HDSLoc *locator, hdsbool_t writing, void *buffer,
+             int *status ) {
+
+  hid_t h5type = 0;
+  hid_t mem_dataspace_id = 0;
+  hid_t dxpl = H5P_DEFAULT;
+  hssize_t npoints = 0;
+  hsize_t h5dims[1];
+  uint64_t tstage = 0;
+
+  if (*status != SAI__OK) return;
+
+  CALLHDFE( hid_t, h5type,
+           H5Dget_type( locator->dataset_id ),
+           DAT__HDF5E,
+           emsRep("dat1BasicIO_1", "Error obtaining data type of dataset",
+                  status)
+           );
+
+  /* The memory buffer is a simple vector of the selected elements */
+  CALLHDFE( hssize_t, npoints,
+           H5Sget_select_npoints( locator->dataspace_id ),
+           DAT__HDF5E,
+           emsRep("dat1BasicIO_2", "Error obtaining number of selected elements",
+                  status)
+           );
+  h5dims[0] = npoints;
+  CALLHDFE( hid_t, mem_dataspace_id,
+           H5Screate_simple( 1, h5dims, NULL ),
+           DAT__HDF5E,
+           emsRep("dat1BasicIO_3", "Error allocating in-memory dataspace",
+                  status)
+           );
+
+  dxpl = dat1XferProps( status );
+  HDS1_STATS_BEGIN( tstage );
+  if (writing) {
+    hds1WriteNote( locator->handle );
+    if (!hds1ChunkIO( locator, h5type, HDS_TRUE, buffer, status )) {
+      CALLHDFQ( H5Dwrite( locator->dataset_id, h5type, mem_dataspace_id,
+                          locator->dataspace_id, dxpl, buffer ) );
+    }
+    dat1CountIO( locator->handle, HDS__IO_WRITE, npoints * H5Tget_size( h5type ) );
+    HDS1_STATS_END( HDS__STAT_H5DWRITE, tstage, npoints * H5Tget_size( h5type ),
+                    locator->handle );
+  } else {
+    if (!hds1ChunkIO( locator, h5type, HDS_FALSE, buffer, status )) {
+      CALLHDFQ( H5Dread( locator->dataset_id, h5type, mem_dataspace_id,
+                         locator->dataspace_id, dxpl, buffer ) );
+    }
+    dat1CountIO( locator->handle, HDS__IO_READ, npoints * H5Tget_size( h5type ) );
+    HDS1_STATS_END( HDS__STAT_H5DREAD, tstage, npoints * H5Tget_size( h5type ),
+                    locator->handle );
+  }
+
+ CLEANUP:
+  if (h5type > 0) H5Tclose( h5type );
+  if (mem_dataspace_id > 0) H5Sclose( mem_dataspace_id );
+}
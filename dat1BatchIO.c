@@ -0,0 +1,394 @@
+/*
+*+
+*  Name:
+*     dat1BatchIO
+
+*  Purpose:
+*     Read or write a list of primitive components of a structure
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1BatchIO( const char *func, const HDSLoc *locator, hdsbool_t writing,
+*                  size_t nitem, HDSBatchItem items[], int *status );
+
+*  Arguments:
+*     func = const char * (Given)
+*        Name of the calling public routine, for error messages.
+*     locator = const HDSLoc * (Given)
+*        Locator for the structure containing the components. If the
+*        structure is an array a single cell must have been selected.
+*     writing = hdsbool_t (Given)
+*        If true the values are written to the components, otherwise they
+*        are read from them.
+*     nitem = size_t (Given)
+*        Number of elements in "items".
+*     items = HDSBatchItem [] (Given and Returned)
+*        The components to access. The "status" field of each item is
+*        returned set to the status of that item.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Implements datGetBatch and datPutBatch. The structure locator is
+*     validated once and each component is then accessed directly through
+*     its HDF5 dataset, without creating a locator for it. The component's
+*     Handle is still created and locked as datFind would do, so thread
+*     locking is respected. Memory data types are only created once for
+*     each distinct type string.
+
+*  Notes:
+*     - Components needing a conversion that HDS does itself (to or from
+*       _CHAR or _LOGICAL, or reading into a shorter string) go through
+*       datFind and datGet or datPut.
+*     - Every item is attempted even if earlier ones fail. If any fail,
+*       "status" is set to the status of the first failure. Its error
+*       messages are retained and those of later failures are annulled.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* Number of distinct memory types remembered within one call */
+#define DAT1_NTYPCACHE 8
+
+typedef struct {
+  const char *type_str;   /* Type string as supplied by the caller */
+  hid_t h5type;           /* Corresponding HDF5 memory type */
+  hdstype_t hdstype;      /* Corresponding HDS type */
+} TypeCache;
+
+static void dat1BatchItem( const char *func, const HDSLoc *locator,
+                           int rdonly, hdsbool_t writing, HDSBatchItem *item,
+                           hid_t memtype, hdstype_t memhdstype, int *status );
+
+void
+dat1BatchIO( const char *func, const HDSLoc *locator, hdsbool_t writing,
+             size_t nitem, HDSBatchItem items[], int *status ) {
+
+  TypeCache cache[DAT1_NTYPCACHE];
+  hdsdim sdims[DAT__MXDIM];
+  size_t ncache = 0;
+  size_t nbad = 0;
+  size_t ifirst = 0;
+  size_t i;
+  size_t j;
+  unsigned intent = 0;
+  int lockinfo = 0;
+  int rdonly;
+
+  if (*status != SAI__OK) return;
+
+  /* Validate input locator. Writing requires a read-write lock. */
+  dat1ValidateLocator( func, 1, locator, !writing, status );
+  if (*status != SAI__OK) return;
+
+  if (!dat1IsStructure( locator, status )) {
+    if (*status == SAI__OK) {
+      *status = DAT__OBJIN;
+      emsRepf("dat1BatchIO_1", "%s: Input object is not a structure",
+              status, func );
+    }
+    return;
+  }
+
+  if (dat1GetStructureDims( locator, DAT__MXDIM, sdims, status ) > 0) {
+    if (*status == SAI__OK) {
+      *status = DAT__OBJIN;
+      emsRepf("dat1BatchIO_2", "%s: Input object is an array of structures. "
+              "Use datCell to select a single element.", status, func );
+    }
+    return;
+  }
+
+  if (writing) {
+    CALLHDFQ( H5Fget_intent( locator->file_id, &intent ) );
+    if (intent == H5F_ACC_RDONLY) {
+      *status = DAT__ACCON;
+      emsRepf("dat1BatchIO_3", "%s: Can not write to a file opened for "
+              "read-only access", status, func );
+      goto CLEANUP;
+    }
+  }
+
+  /* Components are locked in the same way as the structure */
+  dat1HandleLock( locator->handle, 1, 0, 0, &lockinfo, status );
+  rdonly = ( lockinfo == 3 );
+
+  for (i = 0; i < nitem && *status == SAI__OK; i++) {
+    HDSBatchItem *item = &items[i];
+    hid_t memtype = 0;
+    hdstype_t memhdstype = HDSTYPE_NONE;
+    hdsbool_t cached = HDS_FALSE;
+    int istat = SAI__OK;
+
+    emsMark();
+
+    /* Look for the memory type among those already created */
+    for (j = 0; j < ncache; j++) {
+      if (strcmp( cache[j].type_str, item->type ) == 0) {
+        memtype = cache[j].h5type;
+        memhdstype = cache[j].hdstype;
+        cached = HDS_TRUE;
+        break;
+      }
+    }
+
+    if (!cached) {
+      char normtypestr[DAT__SZTYP+1];
+      if (!dau1CheckType( 1, item->type, &memtype, normtypestr,
+                          sizeof(normtypestr), &istat ) && istat == SAI__OK) {
+        istat = DAT__TYPIN;
+        emsRepf("dat1BatchIO_4", "%s: Data type for '%s' must be a primitive "
+                "type and not '%s'", &istat, func, item->name, normtypestr );
+      }
+      memhdstype = dau1HdsType( memtype, &istat );
+      if (istat == SAI__OK && ncache < DAT1_NTYPCACHE) {
+        cache[ncache].type_str = item->type;
+        cache[ncache].h5type = memtype;
+        cache[ncache].hdstype = memhdstype;
+        ncache++;
+        cached = HDS_TRUE;
+      }
+    }
+
+    dat1BatchItem( func, locator, rdonly, writing, item, memtype, memhdstype,
+                   &istat );
+    if (!cached && memtype > 0) H5Tclose( memtype );
+
+    /* Keep the error report from the first failure only */
+    item->status = istat;
+    if (istat != SAI__OK) {
+      if (nbad++ == 0) {
+        ifirst = i;
+      } else {
+        emsAnnul( &istat );
+      }
+    }
+    emsRlse();
+  }
+
+  if (nbad > 0 && *status == SAI__OK) {
+    *status = items[ifirst].status;
+    emsRepf("dat1BatchIO_5", "%s: %zu of %zu components could not be %s. "
+            "The first was '%s'.", status, func, nbad, nitem,
+            (writing ? "written" : "read"), items[ifirst].name );
+  }
+
+ CLEANUP:
+  for (j = 0; j < ncache; j++) H5Tclose( cache[j].h5type );
+  return;
+}
+
+/* Read or write a single component */
+static void dat1BatchItem( const char *func, const HDSLoc *locator,
+                           int rdonly, hdsbool_t writing, HDSBatchItem *item,
+                           hid_t memtype, hdstype_t memhdstype, int *status ) {
+  char cleanname[DAT__SZNAM+1];
+  char filetypestr[DAT__SZTYP+1];
+  hsize_t h5dims[DAT__MXDIM];
+  Handle *handle = NULL;
+  HDSLoc *comploc = NULL;
+  hid_t dataset_id = 0;
+  hid_t filetype = 0;
+  hid_t space_id = 0;
+  hid_t dxpl = H5P_DEFAULT;
+  hdstype_t filehdstype;
+  int convflags;
+  int lockinfo = 0;
+  int fndim;
+  int slow;
+  int i;
+
+  if (*status != SAI__OK) return;
+
+  dau1CheckName( item->name, 1, cleanname, sizeof(cleanname), status );
+  if (*status != SAI__OK) return;
+
+  dataset_id = H5Dopen2( locator->group_id, cleanname, H5P_DEFAULT );
+  if (dataset_id < 0) {
+    dataset_id = 0;
+    if (H5Lexists( locator->group_id, cleanname, H5P_DEFAULT ) > 0) {
+      *status = DAT__OBJIN;
+      emsRepf("dat1BatchItem_1", "%s: Component '%s' is not primitive",
+              status, func, cleanname );
+    } else {
+      *status = DAT__OBJNF;
+      emsRepf("dat1BatchItem_2", "%s: Component '%s' not found",
+              status, func, cleanname );
+    }
+    goto CLEANUP;
+  }
+
+  /* Lock the component as datFind would, without creating a locator */
+  handle = dat1HandleChild( locator->handle, cleanname, 0, status );
+  dat1HandleLock( handle, 2, 0, rdonly, &lockinfo, status );
+  if (handle) hds1WriteWait( handle, status );
+  if (!lockinfo && *status == SAI__OK) {
+    *status = DAT__THREAD;
+    emsRepf("dat1BatchItem_3", "%s: Component '%s' cannot be locked - "
+            "another thread already has a conflicting lock on it.",
+            status, func, cleanname );
+  }
+  if (*status != SAI__OK) goto CLEANUP;
+
+  /* Check the shape */
+  CALLHDFE( hid_t, space_id,
+            H5Dget_space( dataset_id ),
+            DAT__HDF5E,
+            emsRepf("dat1BatchItem_4", "%s: Error obtaining shape of '%s'",
+                    status, func, cleanname )
+            );
+  fndim = H5Sget_simple_extent_ndims( space_id );
+  if (fndim > DAT__MXDIM) fndim = DAT__MXDIM;
+  if (fndim > 0) H5Sget_simple_extent_dims( space_id, h5dims, NULL );
+  if (fndim != item->ndim) {
+    *status = DAT__DIMIN;
+    emsRepf("dat1BatchItem_5", "%s: Supplied no. of axes (%d) for '%s' is "
+            "incorrect - it should be %d.", status, func, item->ndim,
+            cleanname, fndim );
+    goto CLEANUP;
+  }
+  for (i = 0; i < fndim; i++) {
+    if ((hsize_t)item->dims[i] != h5dims[fndim - 1 - i]) {
+      *status = DAT__DIMIN;
+      emsRepf("dat1BatchItem_6", "%s: Supplied dimension (%" HDS_DIM_FORMAT
+              ") on axis %d of '%s' is incorrect - it should be %zu.",
+              status, func, item->dims[i], i+1, cleanname,
+              (size_t)h5dims[fndim - 1 - i] );
+      goto CLEANUP;
+    }
+  }
+
+  if (!writing) {
+    H5D_space_status_t dstatus = 0;
+    CALLHDFQ( H5Dget_space_status( dataset_id, &dstatus ) );
+    if (dstatus != H5D_SPACE_STATUS_ALLOCATED &&
+        dstatus != H5D_SPACE_STATUS_PART_ALLOCATED) {
+      *status = DAT__UNSET;
+      emsRepf("dat1BatchItem_7", "%s: Primitive object '%s' is undefined. "
+              "Nothing to get.", status, func, cleanname );
+      goto CLEANUP;
+    }
+  }
+
+  /* Only let HDF5 transfer the data if it can do any conversion */
+  filehdstype = dat1TypeStr( dataset_id, filetypestr, status );
+  if (writing) {
+    convflags = dat1ConvFlags( memhdstype, filehdstype );
+  } else {
+    convflags = dat1ConvFlags( filehdstype, memhdstype );
+  }
+  slow = ( convflags & (HDS__CONV_CHAR|HDS__CONV_LOGICAL) ) ? 1 : 0;
+  if (!slow && !writing && filehdstype == HDSTYPE_CHAR) {
+    CALLHDFE( hid_t, filetype,
+              H5Dget_type( dataset_id ),
+              DAT__HDF5E,
+              emsRepf("dat1BatchItem_8", "%s: Error obtaining data type of '%s'",
+                      status, func, cleanname )
+              );
+    if (H5Tget_size( filetype ) > H5Tget_size( memtype )) slow = 1;
+  }
+  if (*status != SAI__OK) goto CLEANUP;
+
+  if (slow) {
+    datFind( locator, cleanname, &comploc, status );
+    if (writing) {
+      datPut( comploc, item->type, item->ndim, item->dims, item->values,
+              status );
+    } else {
+      datGet( comploc, item->type, item->ndim, item->dims, item->values,
+              status );
+    }
+    datAnnul( &comploc, status );
+  } else if (writing) {
+    dxpl = dat1XferProps( status );
+    hds1WriteNote( handle );
+    CALLHDFQ( H5Dwrite( dataset_id, memtype, H5S_ALL, H5S_ALL, dxpl,
+                        item->values ) );
+    dat1CountIO( handle, HDS__IO_WRITE, H5Sget_select_npoints( space_id ) *
+                 H5Tget_size( memtype ) );
+    if (memhdstype != filehdstype) {
+      hds1MetricsConvert( memhdstype, filehdstype,
+                          H5Sget_select_npoints( space_id ) );
+    }
+  } else {
+    dxpl = dat1XferProps( status );
+    CALLHDFQ( H5Dread( dataset_id, memtype, H5S_ALL, H5S_ALL, dxpl,
+                       item->values ) );
+    dat1CountIO( handle, HDS__IO_READ, H5Sget_select_npoints( space_id ) *
+                 H5Tget_size( memtype ) );
+    if (memhdstype != filehdstype) {
+      hds1MetricsConvert( filehdstype, memhdstype,
+                          H5Sget_select_npoints( space_id ) );
+    }
+  }
+
+ CLEANUP:
+  if (filetype > 0) H5Tclose( filetype );
+  if (space_id > 0) H5Sclose( space_id );
+  if (dataset_id > 0) H5Dclose( dataset_id );
+  return;
+}
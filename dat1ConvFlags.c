@@ -0,0 +1,129 @@
+/*
+*+
+*  Name:
+*     dat1ConvFlags
+
+*  Purpose:
+*     Look up the properties of a conversion between two HDS types
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     flags = dat1ConvFlags( hdstype_t intype, hdstype_t outtype );
+
+*  Arguments:
+*     intype = hdstype_t (Given)
+*        Type of the values being converted.
+*     outtype = hdstype_t (Given)
+*        Type required.
+
+*  Returned Value:
+*     flags = int
+*        Bitwise OR of the HDS__CONV_* flags describing the conversion.
+*        Zero if the conversion is not possible.
+
+*  Description:
+*     Returns the properties of a conversion from one HDS type to another,
+*     taken from a fixed table. The flags indicate whether the conversion
+*     is possible at all, whether every input value can be represented
+*     exactly in the output type, whether the values are stored in the same
+*     way in memory and in the file (so that they can be copied or memory
+*     mapped without conversion), and whether HDS has to perform the
+*     conversion itself rather than leaving it to HDF5.
+
+*  Notes:
+*     - HDS__CONV_IDENTITY and HDS__CONV_LOSSLESS for _CHAR to _CHAR
+*       additionally require the two string lengths to be the same. The
+*       caller must check that.
+*     - _LOGICAL is not an identity conversion since the values are held in
+*       8 bits in the file and 32 bits in memory.
+*     - Conversions to and from a structure are never possible.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "hds1.h"
+#include "dat1.h"
+
+/* Shorthands used to keep the table readable */
+#define X_ HDS__CONV_EXISTS
+#define L_ (HDS__CONV_EXISTS|HDS__CONV_LOSSLESS)
+#define I_ (HDS__CONV_EXISTS|HDS__CONV_LOSSLESS|HDS__CONV_IDENTITY)
+#define C_ (HDS__CONV_EXISTS|HDS__CONV_CHAR)
+#define G_ (HDS__CONV_EXISTS|HDS__CONV_LOGICAL)
+
+/* Indexed by [intype][outtype] in hdstype_t order */
+static const unsigned char dat1ConvTable[HDSTYPE_STRUCTURE+1][HDSTYPE_STRUCTURE+1] = {
+  /*             NONE BYTE UBYT WORD UWRD INT  I64  REAL DBLE LOG  CHAR STRC */
+  /* NONE    */ { 0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0 },
+  /* BYTE    */ { 0,   I_,  X_,  L_,  X_,  L_,  L_,  L_,  L_,  G_,  C_,  0 },
+  /* UBYTE   */ { 0,   X_,  I_,  L_,  L_,  L_,  L_,  L_,  L_,  G_,  C_,  0 },
+  /* WORD    */ { 0,   X_,  X_,  I_,  X_,  L_,  L_,  L_,  L_,  G_,  C_,  0 },
+  /* UWORD   */ { 0,   X_,  X_,  X_,  I_,  L_,  L_,  L_,  L_,  G_,  C_,  0 },
+  /* INTEGER */ { 0,   X_,  X_,  X_,  X_,  I_,  L_,  X_,  L_,  G_,  C_,  0 },
+  /* INT64   */ { 0,   X_,  X_,  X_,  X_,  X_,  I_,  X_,  X_,  G_,  C_,  0 },
+  /* REAL    */ { 0,   X_,  X_,  X_,  X_,  X_,  X_,  I_,  L_,  G_,  C_,  0 },
+  /* DOUBLE  */ { 0,   X_,  X_,  X_,  X_,  X_,  X_,  X_,  I_,  G_,  C_,  0 },
+  /* LOGICAL */ { 0,   G_,  G_,  G_,  G_,  G_,  G_,  G_,  G_,  L_,  C_,  0 },
+  /* CHAR    */ { 0,   C_,  C_,  C_,  C_,  C_,  C_,  C_,  C_,  C_,  I_,  0 },
+  /* STRUCT  */ { 0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0 }
+};
+
+int
+dat1ConvFlags( hdstype_t intype, hdstype_t outtype ) {
+  if ((int)intype < 0 || intype > HDSTYPE_STRUCTURE ||
+      (int)outtype < 0 || outtype > HDSTYPE_STRUCTURE) return 0;
+  return dat1ConvTable[intype][outtype];
+}
@@ -0,0 +1,141 @@
+/*
+*+
+*  Name:
+*     dat1CountIO
+
+*  Purpose:
+*     Add a transfer to the I/O totals of a container file
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1CountIO( Handle *handle, hds_io_t type, size_t nbytes );
+
+*  Arguments:
+*     handle = Handle * (Given)
+*        Handle for any object in the container file. May be NULL, in which
+*        case nothing is done.
+*     type = hds_io_t (Given)
+*        The kind of transfer (HDS__IO_READ, HDS__IO_WRITE, HDS__IO_MMAP,
+*        HDS__IO_UNMAP, HDS__IO_COPYMAP or HDS__IO_UNCOPYMAP).
+*     nbytes = size_t (Given)
+*        Number of bytes of data transferred, mapped or unmapped.
+
+*  Description:
+*     Updates the totals held in the top level Handle of the file, which are
+*     reported by hdsShow("DATA"). Reads and writes are counted and their
+*     sizes added up. Mapping a primitive adds to the number of bytes
+*     currently mapped and unmapping it subtracts the same amount again.
+*     Mapping and unmapping are also added to the process-wide run time
+*     metrics (see hdsMetrics).
+
+*  Notes:
+*     - No status argument is used, so that this can be called while
+*       cleaning up and from the I/O thread.
+*     - The mutex of the top level Handle is locked while the totals are
+*       updated.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <pthread.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+void dat1CountIO( Handle *handle, hds_io_t type, size_t nbytes ) {
+
+/* Local Variables: */
+   Handle *top = handle;
+
+   if( !top ) return;
+
+/* The totals are kept in the top level Handle */
+   while( top->parent ) top = top->parent;
+
+   pthread_mutex_lock( &(top->mutex) );
+   switch( type ) {
+   case HDS__IO_READ:
+      top->io.nread++;
+      top->io.bytes_read += nbytes;
+      break;
+   case HDS__IO_WRITE:
+      top->io.nwrite++;
+      top->io.bytes_written += nbytes;
+      break;
+   case HDS__IO_MMAP:
+      top->io.bytes_mmap += nbytes;
+      break;
+   case HDS__IO_UNMAP:
+      top->io.bytes_mmap -= ( nbytes < top->io.bytes_mmap ? nbytes :
+                              top->io.bytes_mmap );
+      break;
+   case HDS__IO_COPYMAP:
+      top->io.bytes_copymap += nbytes;
+      break;
+   case HDS__IO_UNCOPYMAP:
+      top->io.bytes_copymap -= ( nbytes < top->io.bytes_copymap ? nbytes :
+                                 top->io.bytes_copymap );
+      break;
+   }
+   pthread_mutex_unlock( &(top->mutex) );
+
+   if( type != HDS__IO_READ && type != HDS__IO_WRITE ) {
+      hds1MetricsMap( type, nbytes );
+   }
+}
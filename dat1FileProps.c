@@ -0,0 +1,263 @@
+/*
+*+
+*  Name:
+*     dat1FileProps
+
+*  Purpose:
+*     Obtain HDF5 property lists for creating or opening a container file
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     dat1FileProps( const char *fname, hdsbool_t create, hid_t *fcpl,
+*                    hid_t *fapl, int *status );
+
+*  Arguments:
+*     fname = const char * (Given)
+*        Path to the container file (including file extension).
+*     create = hdsbool_t (Given)
+*        True if the file is about to be created, false if an existing
+*        file is about to be opened.
+*     fcpl = hid_t * (Returned)
+*        File creation property list. Only used if "create" is true and
+*        may be NULL otherwise. Returned as H5P_DEFAULT if no special
+*        properties are required.
+*     fapl = hid_t * (Returned)
+*        File access property list. Returned as H5P_DEFAULT if no special
+*        properties are required.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Returns the property lists that should be used when creating or
+*     opening the named container file, based on the current HDS tuning
+*     parameters. If the COMPACT tuning parameter is set, new files are
+*     created with paged file-space aggregation using a page size equal to
+*     the block size of the filesystem holding the file. All metadata is
+*     then packed into whole pages rather than being scattered across the
+*     file in small blocks. Groups and attributes are also written in the
+*     compact (HDF5 1.8 or later) object header format, so that small
+*     structures hold their links and their CLASS and HDS_STRUCTURE_DIMS
+*     attributes directly in the object header.
+*
+*     If the PAGEBUF tuning parameter is non-zero, the file access property
+*     list includes an HDF5 page buffer of the requested size (in KiB). On
+*     opening a paged file, the metadata is then read a whole page at a
+*     time and retained, so a traversal of a deep hierarchy needs only a
+*     few large reads.
+*
+*     The CHUNKCACHE, MDCACHE and SIEVEBUF tuning parameters set the sizes
+*     of the HDF5 chunk cache, metadata cache and sieve buffer, and INAL
+*     sets the size of the blocks in which space for metadata is
+*     allocated in a new file. Each of these tuning parameters, and
+*     COMPACT and PAGEBUF, may be given a different value for this file
+*     in a tuning file (see hdsTune).
+
+*  Notes:
+*     - Any property list that is not H5P_DEFAULT must be closed by the
+*     caller using H5Pclose.
+*     - HDF5 will refuse to open a file that was not created with paged
+*     aggregation if a page buffer is requested. Callers should retry
+*     using H5P_DEFAULT if an open using the returned "fapl" fails.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+#include <libgen.h>
+#include <sys/statvfs.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* Limits on the file space page size. HDF5 requires at least 512 bytes. */
+#define MIN_PAGE_SIZE 4096
+#define MAX_PAGE_SIZE 1048576
+
+void dat1FileProps( const char *fname, hdsbool_t create, hid_t *fcpl,
+                    hid_t *fapl, int *status ) {
+  hsize_t pagesize = MIN_PAGE_SIZE;
+  size_t pagebuf = 0;
+  size_t chunkcache = 0;
+  size_t mdcache = 0;
+  size_t sievebuf = 0;
+  hsize_t inal = 0;
+  hdsbool_t compact = HDS_FALSE;
+  hid_t lfcpl = H5P_DEFAULT;
+  hid_t lfapl = H5P_DEFAULT;
+
+  if (fcpl) *fcpl = H5P_DEFAULT;
+  *fapl = H5P_DEFAULT;
+  if (*status != SAI__OK) return;
+
+  if (create) {
+    compact = hds1TuneFile( fname, "COMPACT", hds1GetCompact() );
+    inal = (hsize_t)hds1TuneFile( fname, "INAL", hds1GetInal() ) * 512;
+  }
+  pagebuf = (size_t)hds1TuneFile( fname, "PAGEBUF", hds1GetPageBuf() ) * 1024;
+  chunkcache = (size_t)hds1TuneFile( fname, "CHUNKCACHE",
+                                     hds1GetChunkCache() ) * 1024;
+  mdcache = (size_t)hds1TuneFile( fname, "MDCACHE", hds1GetMdCache() ) * 1024;
+  sievebuf = (size_t)hds1TuneFile( fname, "SIEVEBUF", hds1GetSieveBuf() ) * 1024;
+
+  /* Nothing to do if the defaults are being used */
+  if (!compact && pagebuf == 0 && chunkcache == 0 && mdcache == 0 &&
+      sievebuf == 0 && inal == 0) return;
+
+  /* Use the block size of the filesystem that will hold the file as the
+     file space page size. */
+  if (compact) {
+    struct statvfs fsinfo;
+    char *dirbuf = MEM_MALLOC( strlen(fname) + 1 );
+    if (dirbuf) {
+      strcpy( dirbuf, fname );
+      if (statvfs( dirname(dirbuf), &fsinfo ) == 0 &&
+          fsinfo.f_bsize > pagesize) {
+        pagesize = fsinfo.f_bsize;
+        if (pagesize > MAX_PAGE_SIZE) pagesize = MAX_PAGE_SIZE;
+      }
+      MEM_FREE( dirbuf );
+    }
+  }
+
+  CALLHDFE( hid_t, lfapl,
+            H5Pcreate( H5P_FILE_ACCESS ),
+            DAT__HDF5E,
+            emsRepf("dat1FileProps_1", "Error creating file access properties for '%s'",
+                    status, fname )
+            );
+
+  if (compact) {
+    CALLHDFE( hid_t, lfcpl,
+              H5Pcreate( H5P_FILE_CREATE ),
+              DAT__HDF5E,
+              emsRepf("dat1FileProps_2", "Error creating file creation properties for '%s'",
+                      status, fname )
+              );
+
+    /* Aggregate all metadata (and small raw data) into whole pages */
+    CALLHDFQ( H5Pset_file_space_strategy( lfcpl, H5F_FSPACE_STRATEGY_PAGE,
+                                          0, (hsize_t)1 ) );
+    CALLHDFQ( H5Pset_file_space_page_size( lfcpl, pagesize ) );
+    CALLHDFQ( H5Pset_meta_block_size( lfapl, (inal > pagesize ? inal : pagesize) ) );
+
+    /* Compact link storage and compact attribute storage both require
+       the object header format introduced in HDF5 1.8, and paged
+       aggregation the 1.10 format. The upper bound stops newer libraries
+       using formats that 1.10 can not read. */
+    CALLHDFQ( H5Pset_libver_bounds( lfapl, H5F_LIBVER_V18, H5F_LIBVER_V110 ) );
+
+    /* The page buffer can not be smaller than one page */
+    if (pagebuf > 0 && pagebuf < pagesize) pagebuf = pagesize;
+  }
+
+  /* A page buffer can only be used with a new file if it is paged */
+  if (pagebuf > 0 && (compact || !create)) {
+    CALLHDFQ( H5Pset_page_buffer_size( lfapl, pagebuf, 0, 0 ) );
+  }
+
+  /* The HDS Classic initial allocation is the nearest equivalent to the
+     size of the blocks in which HDF5 allocates space for metadata */
+  if (inal > 0 && !compact) {
+    CALLHDFQ( H5Pset_meta_block_size( lfapl, inal ) );
+  }
+
+  /* Only the size of the chunk cache is changed */
+  if (chunkcache > 0) {
+    int mdc_nelmts;
+    size_t rdcc_nslots;
+    size_t rdcc_nbytes;
+    double rdcc_w0;
+    CALLHDFQ( H5Pget_cache( lfapl, &mdc_nelmts, &rdcc_nslots, &rdcc_nbytes,
+                            &rdcc_w0 ) );
+    CALLHDFQ( H5Pset_cache( lfapl, mdc_nelmts, rdcc_nslots, chunkcache,
+                            rdcc_w0 ) );
+  }
+
+  /* The metadata cache starts at the requested size, and may still be
+     resized by HDF5 */
+  if (mdcache > 0) {
+    H5AC_cache_config_t config;
+    config.version = H5AC__CURR_CACHE_CONFIG_VERSION;
+    CALLHDFQ( H5Pget_mdc_config( lfapl, &config ) );
+    config.set_initial_size = 1;
+    config.initial_size = mdcache;
+    if (config.max_size < mdcache) config.max_size = mdcache;
+    if (config.min_size > mdcache) config.min_size = mdcache;
+    CALLHDFQ( H5Pset_mdc_config( lfapl, &config ) );
+  }
+
+  if (sievebuf > 0) {
+    CALLHDFQ( H5Pset_sieve_buf_size( lfapl, sievebuf ) );
+  }
+
+  if (fcpl) {
+    *fcpl = lfcpl;
+    lfcpl = H5P_DEFAULT;
+  }
+  *fapl = lfapl;
+  lfapl = H5P_DEFAULT;
+
+ CLEANUP:
+  if (lfcpl != H5P_DEFAULT && lfcpl > 0) H5Pclose( lfcpl );
+  if (lfapl != H5P_DEFAULT && lfapl > 0) H5Pclose( lfapl );
+  return;
+}
@@ -96,11 +96,14 @@ Handle *dat1FreeHandle( Handle *handle, int *status ) {
 
 /* Free the memory used by components of the Handle structure. */
       if( handle->name ) MEM_FREE( handle->name );
+      if( handle->path ) MEM_FREE( handle->path );
+      if( handle->file ) MEM_FREE( handle->file );
       if( handle->children ) MEM_FREE( handle->children );
       if( handle->read_lockers ) MEM_FREE( handle->read_lockers );
 
 /* Destroy the mutex */
       pthread_mutex_destroy( &(handle->mutex) );
+      hds1MetricsHandle( -1 );
 
 /* Fill the handles with zeros in case any other points to the same
    handle exist. */
@@ -0,0 +1,134 @@
+/*
+*+
+*  Name:
+*     dat1GroupProps
+
+*  Purpose:
+*     Return the creation properties for a new structure
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1GroupProps( hid_t loc_id, int *status );
+
+*  Arguments:
+*     loc_id = hid_t (Given)
+*        Any HDF5 object in the container file in which the structure is to
+*        be created.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned Value:
+*     hid_t
+*        Group creation property list. H5P_DEFAULT if no special properties
+*        are required.
+
+*  Description:
+*     Returns the group creation property list that should be used for a new
+*     structure or structure array cell. If the NCOM tuning parameter is set
+*     (globally or for this container file) to the expected number of
+*     components, the storage for the names of the components is sized to
+*     hold that many. For groups in the original HDF5 format, the local heap
+*     holding the names is given an initial size large enough for them. For
+*     groups in the compact format (see the COMPACT tuning parameter), HDF5
+*     is given an estimate of the number of links and the length of their
+*     names. The number of links at which a group changes between compact
+*     and dense storage is left at the HDF5 default.
+
+*  Notes:
+*     - Any property list that is not H5P_DEFAULT must be closed by the
+*     caller using H5Pclose.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* HDF5 limits on link storage hints */
+#define MAX_LINK_HINT 65535
+
+hid_t dat1GroupProps( hid_t loc_id, int *status ) {
+  hid_t gcpl = H5P_DEFAULT;
+  int ncom;
+
+  if (*status != SAI__OK) return gcpl;
+
+  ncom = hds1TuneObject( loc_id, "NCOM", hds1GetNcom() );
+  if (ncom <= 0) return gcpl;
+  if (ncom > MAX_LINK_HINT) ncom = MAX_LINK_HINT;
+
+  CALLHDFE( hid_t, gcpl,
+            H5Pcreate( H5P_GROUP_CREATE ),
+            DAT__HDF5E,
+            emsRep("dat1GroupProps_1", "Error creating group creation properties",
+                   status )
+            );
+
+  CALLHDFQ( H5Pset_local_heap_size_hint( gcpl, (size_t)ncom * (DAT__SZNAM + 1) ) );
+  CALLHDFQ( H5Pset_est_link_info( gcpl, ncom, DAT__SZNAM ) );
+
+  return gcpl;
+
+ CLEANUP:
+  if (gcpl != H5P_DEFAULT && gcpl > 0) H5Pclose( gcpl );
+  return H5P_DEFAULT;
+}
@@ -115,158 +115,16 @@
 Handle *dat1Handle( const HDSLoc *parent_loc, const char *name, int rdonly,
                     int * status ){
 
-
 /* Local Variables; */
-   char *ext;
-   char *lname = NULL;
-   Handle *child;
    Handle *parent;
-   Handle *result = NULL;
-   int ichild;
-   int lock_status;
-   int ichild_unused;
 
 /* Return immediately if an error has already occurred. */
-   if( *status != SAI__OK ) return result;
-
-/* Get a local copy of "Name" without any trailing ".sdf". */
-   if( name ) {
-      lname = MEM_CALLOC( strlen( name ) + 1, sizeof(char) );
-      if( !lname ) {
-         *status = DAT__NOMEM;
-         emsRep("dat1Handle", "Could not allocate memory for the "
-                "component name in an HDS Handle", status );
-      } else {
-         strcpy( lname, name );
-         ext = strstr( lname, DAT__FLEXT );
-         if( ext ) *ext = 0;
-      }
-   }
+   if( *status != SAI__OK ) return NULL;
 
 /* Get the handle for the parent object (if any), and validate it. */
    parent = parent_loc ? parent_loc->handle : NULL;
    if( parent_loc ) dat1ValidateHandle( "dat1Handle", parent, status );
 
-/* If a parent Handle is available, search through the Handles for any
-   known child objects to see if the requested component within the parent
-   (identified by 'lname') is already known and therefore already has an
-   associated Handle structure. If it does, return a pointer to the child
-   Handle structure. Note "nchild" is the size of the "children" array -
-   this is not necessarily the same as the actual number of active
-   children since this array may contain some NULL pointers. */
-   ichild_unused = -1;
-   if( parent && lname ) {
-      for( ichild = 0; ichild < parent->nchild; ichild++ ) {
-         child = parent->children[ichild];
-         if( !child ){
-            ichild_unused = ichild;
-         } else if( !dat1ValidateHandle( "dat1Handle", child, status ) ){
-            break;
-         } else if( !strcmp( child->name, lname ) ) {
-            result = child;
-            break;
-         }
-      }
-   }
-
-/* If we need to create a new Handle... */
-   if( !result && *status == SAI__OK ) {
-
-/* Allocate the memory, filling it with zeros (NULLs). Report an error
-   if the memory could not be allocated */
-      result = MEM_CALLOC( 1, sizeof(*result) );
-      if( !result ) {
-         *status = DAT__NOMEM;
-         emsRep("dat1Handle", "Could not allocate memory for HDS Handle",
-                status );
-
-/* If the memory for the new Handle was allocated succesfully... */
-      } else {
-
-/* Create links between the new Handle and any supplied parent. */
-         result->parent = parent;
-         if( parent ) {
-
-/* If an used slot in the children array was found, we re-used it.
-   Otherwise we extend the children array. */
-            if( ichild_unused == - 1) {
-               ichild_unused = parent->nchild++;
-               parent->children = MEM_REALLOC( parent->children,
-                                               parent->nchild*sizeof(Handle *) );
-            }
-
-            if( !parent->children ) {
-               *status = DAT__NOMEM;
-               emsRep("dat1Handle", "Could not reallocate memory for "
-                      "child links in an HDS Handle", status );
-            } else {
-               parent->children[ ichild_unused ] = result;
-            }
-
-         }
-
-/* Store the component name. Nullify "lname" to indicate the memory is
-   now part of the Handle structure and should not be freed below. */
-         result->name = lname;
-         lname = NULL;
-
-/* Initialise a mutex that is used to serialise access to the values
-   stored in the handle. */
-         if( *status == SAI__OK &&
-             pthread_mutex_init( &(result->mutex), NULL ) != 0 ) {
-            *status = DAT__MUTEX;
-            emsRep( " ", "Failed to initialise POSIX mutex for a new Handle.",
-                    status );
-         }
-
-/* Initialise the Handle to indicate it is currently unlocked. */
-         result->docheck = 1;
-         result->nwrite_lock = 0;
-         result->nread_lock = 0;
-         result->read_lockers = NULL;
-         result->maxreaders = 0;
-
-/* The address of the Handle is stored in the "check" component. This is
-   used later to check that the handle is still valid (i.e. has not been
-   freed). */
-         result->check = result;
-
-/* If a parent was supplied, see if the current thread has a read or
-   write lock on the parent object. We give the same sort of lock to the
-   new Handle below (ignoring the supplied value for "rdonly"). If lock
-   checks are not being performed, arbitrarily assume a read-only lock
-   (not that it will make any difference). */
-         if( parent && parent->docheck ) {
-            dat1HandleLock( parent, 1, 0, 0, &lock_status, status );
-            if( lock_status == 1 ) {
-               rdonly = 0;
-            } else if( lock_status == 3 ) {
-               rdonly = 1;
-            } else if( !hds1GetLockCheck() ) {
-               rdonly = 1;
-            } else if( *status == SAI__OK ) {
-               *status = DAT__FATAL;
-               emsRepf( " ", "dat1Handle: Unexpected lock value (%d) for "
-                        "object '%s' - parent of '%s' (internal HDS "
-                        "programming error).", status, lock_status,
-                        parent->name, name );
-            }
-         }
-
-/* Lock the new Handle for use by the current thread. The type of lock
-   (read-only or read-write) is inherited from the parent (if there is a
-   parent) or supplied by the caller. */
-         dat1HandleLock( result, 2, 0, rdonly, &lock_status, status );
-      }
-   }
-
-/* Free the local copy of the name, unless it has been transferred to a new
-   Handle (in which case "lname" will be NULL). */
-   if( lname ) MEM_FREE( lname );
-
-/* If an error occurred, free the resources used by the Handle. */
-   if( *status != SAI__OK ) result = dat1FreeHandle( result, status );
-
-/* Return the Handle pointer */
-   return result;
+/* Find or create the Handle for the named component within the parent. */
+   return dat1HandleChild( parent, name, rdonly, status );
 }
@@ -200,6 +200,9 @@ Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly,
    int j;
    Handle *error_handle = NULL;
    int child_result;
+   uint64_t twait = 0;
+   uint64_t twaitend = 0;
+   uint64_t tblock;
 
 /* initialise */
    *result = 0;
@@ -222,8 +225,17 @@ Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly,
 
 /* For top-level entries to this function, we need to ensure no other thread
    is modifying the details in the handle, so attempt to lock the handle's
-   mutex. */
-   if( top_level ) pthread_mutex_lock( &(handle->mutex) );
+   mutex. Time any wait if the mutex is held by another thread. The wait
+   is recorded once the mutex has been released again. */
+   if( top_level ) {
+      if( pthread_mutex_trylock( &(handle->mutex) ) != 0 ) {
+         HDS1_STATS_BEGIN( twait );
+         tblock = hds1MetricsClock();
+         pthread_mutex_lock( &(handle->mutex) );
+         hds1MetricsLockWait( tblock );
+         if( twait ) twaitend = hds1StatsTime();
+      }
+   }
 
 /* Return information about the current lock on the supplied Handle.
    ------------------------------------------------------------------ */
@@ -485,6 +497,7 @@ Handle *dat1HandleLock( Handle *handle, int oper, int recurs, int rdonly,
 /* If this is a top-level entry, unlock the Handle's mutex so that other
    threads can access the values in the Handle. */
    if( top_level ) pthread_mutex_unlock( &(handle->mutex) );
+   if( twait ) hds1StatsSpan( HDS__STAT_LOCKWAIT, twait, twaitend, 0, handle );
 
 /* Return the error handle. */
    return error_handle;
@@ -0,0 +1,244 @@
+/*
+*+
+*  Name:
+*     dat1HandlePath
+
+*  Purpose:
+*     Return the HDS path or file name of the object described by a Handle.
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     char *dat1HandlePath( Handle *handle, hid_t objid, int asfile, int *nlev,
+*                           int *status );
+
+*  Arguments:
+*     handle = Handle * (Given)
+*        Pointer to the Handle.
+*     objid = hid_t (Given)
+*        HDF5 identifier for the object described by "handle". It is only
+*        used if the information is not already cached.
+*     asfile = int (Given)
+*        If true, return the name of the container file rather than the path
+*        of the object within it.
+*     nlev = int * (Returned)
+*        Number of levels in the returned path. Not used (and may be NULL)
+*        if "asfile" is true.
+*     status = int * (Given and Returned)
+*        Pointer to the inherited status value.
+
+*  Returned function value:
+*     Pointer to a newly allocated string holding the path (e.g.
+*     "HDS_TEST.RECORDS(3,2).INTINCELL") or file name. It should be freed
+*     using MEM_FREE when no longer needed. NULL is returned if an error
+*     occurs.
+
+*  Description:
+*     The HDS path of an object is cached in its Handle the first time it is
+*     requested, and the file name is cached in the Handle at the top of the
+*     tree. The path of a component is formed by appending its name to the
+*     cached path of its parent, so only the root name needs to be obtained
+*     from HDF5. This makes hdsTrace (and hence datMsg, datRef and locator
+*     counting with a filter) a simple in-memory operation after the first
+*     call.
+
+*  Notes:
+*     - The path does not include any subscripts describing a slice or cell
+*       of a primitive; those depend on the locator, not the object, and are
+*       added by hdsTrace.
+*     - The cached paths are cleared by dat1MoveHandle when an object is
+*       moved or renamed.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+char *dat1HandlePath( Handle *handle, hid_t objid, int asfile, int *nlev,
+                      int *status ) {
+
+/* Local Variables: */
+   Handle *top;
+   char *parpath = NULL;
+   char *path = NULL;
+   char *result = NULL;
+   char rootname[DAT__SZNAM+1];
+   const char cellroot[] = DAT__CELLNAME "(";
+   int newlev = 0;
+   int parlev = 0;
+   size_t lenstr;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return result;
+
+/* Validate the supplied handle. */
+   if( !dat1ValidateHandle( "dat1HandlePath", handle, status ) ) return result;
+
+/* The file name is cached in the top level Handle. Get it from HDF5 if
+   this is the first request. */
+   if( asfile ) {
+      top = dat1TopHandle( handle, status );
+      if( *status != SAI__OK ) return result;
+
+      pthread_mutex_lock( &(top->mutex) );
+      if( top->file ) {
+         result = MEM_MALLOC( strlen( top->file ) + 1 );
+         if( result ) strcpy( result, top->file );
+      }
+      pthread_mutex_unlock( &(top->mutex) );
+
+      if( !result ) {
+         path = dat1GetFullName( objid, 1, NULL, status );
+         if( path ) {
+            result = MEM_MALLOC( strlen( path ) + 1 );
+            if( result ) strcpy( result, path );
+            pthread_mutex_lock( &(top->mutex) );
+            if( !top->file ) {
+               top->file = path;
+               path = NULL;
+            }
+            pthread_mutex_unlock( &(top->mutex) );
+         }
+      }
+
+/* If the path has already been cached, return a copy of it. */
+   } else {
+      pthread_mutex_lock( &(handle->mutex) );
+      if( handle->path ) {
+         result = MEM_MALLOC( strlen( handle->path ) + 1 );
+         if( result ) strcpy( result, handle->path );
+         newlev = handle->nlev;
+      }
+      pthread_mutex_unlock( &(handle->mutex) );
+
+/* Otherwise, form the path from the parent path and the component name.
+   A cell of a structure array is appended without a dot, and does not
+   count as a new level. */
+      if( !result && handle->parent && !handle->toplevel ) {
+         parpath = dat1HandlePath( handle->parent, objid, 0, &parlev, status );
+         if( parpath ) {
+            lenstr = strlen( parpath ) + strlen( handle->name ) + 2;
+            path = MEM_MALLOC( lenstr );
+            if( path ) {
+               strcpy( path, parpath );
+               if( !strncmp( handle->name, cellroot, strlen( cellroot ) ) ) {
+                  strcat( path, handle->name + strlen( DAT__CELLNAME ) );
+                  newlev = parlev;
+               } else {
+                  strcat( path, "." );
+                  strcat( path, handle->name );
+                  newlev = parlev + 1;
+               }
+            }
+            MEM_FREE( parpath );
+         }
+
+/* If the Handle has no parent (or is the child of a Handle that describes
+   the file rather than an object in it), it describes either the root
+   group, in which case the path is the name stored in the root group, or
+   a primitive stored as the top level object, in which case it is the
+   HDF5 name of the primitive (which must be "objid" since a primitive
+   can not have components). */
+      } else if( !result ) {
+         if( dat1NeedsRootName( objid, HDS_FALSE, rootname, sizeof(rootname),
+                                status ) ) {
+            path = MEM_MALLOC( strlen( rootname ) + 1 );
+            if( path ) strcpy( path, rootname );
+         } else if( *status == SAI__OK ) {
+            parpath = dat1GetFullName( objid, 0, NULL, status );
+            if( parpath ) {
+               path = MEM_MALLOC( strlen( parpath ) + 1 );
+               if( path ) strcpy( path, parpath[0] == '/' ? parpath + 1 : parpath );
+               MEM_FREE( parpath );
+            }
+         }
+         newlev = 1;
+      }
+
+/* Cache the new path, unless another thread got there first, and return
+   a copy. */
+      if( path ) {
+         result = MEM_MALLOC( strlen( path ) + 1 );
+         if( result ) strcpy( result, path );
+         pthread_mutex_lock( &(handle->mutex) );
+         if( !handle->path ) {
+            handle->path = path;
+            handle->nlev = newlev;
+            path = NULL;
+         }
+         pthread_mutex_unlock( &(handle->mutex) );
+      }
+   }
+
+/* Report an error if any memory could not be allocated. */
+   if( !result && *status == SAI__OK ) {
+      *status = DAT__NOMEM;
+      emsRep( " ", "dat1HandlePath: Could not allocate memory for an HDS "
+              "path name", status );
+   }
+
+   if( path ) MEM_FREE( path );
+   if( nlev && !asfile ) *nlev = newlev;
+   return result;
+}
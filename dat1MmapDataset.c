@@ -0,0 +1,314 @@
+/*
+*+
+*  Name:
+*     dat1MmapDataset
+
+*  Purpose:
+*     Memory map the contiguous on-disk extent of a dataset
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void *dat1MmapDataset( HDSLoc *locator, hdsmode_t accmode, unsigned intent,
+*                            haddr_t offset, size_t nbytes, int *isreg,
+*                            void **regpntr, size_t *actbytes, int *status );
+
+*  Arguments:
+*     locator = HDSLoc * (Given and Returned)
+*        Primitive locator. If the mapping succeeds, the locator is flagged as
+*        using a true memory map and any file descriptor opened here is stored
+*        in it so that datUnmap can close it.
+*     accmode = hdsmode_t (Given)
+*        Access mode for the mapped data.
+*     intent = unsigned (Given)
+*        Access intent of the file, as returned by H5Fget_intent.
+*     offset = haddr_t (Given)
+*        Byte offset of the data within the file, as returned by
+*        H5Dget_offset.
+*     nbytes = size_t (Given)
+*        Number of bytes to map.
+*     isreg = int * (Returned)
+*        Result of registering the pointer with CNF.
+*     regpntr = void ** (Returned)
+*        The pointer registered with CNF, which points to the first byte of
+*        the data. NULL if the data could not be mapped.
+*     actbytes = size_t * (Returned)
+*        Number of bytes actually mapped, including the adjustment needed to
+*        start the mapping on a page boundary.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned function value:
+*     The address of the start of the mapping (which is page aligned and so
+*     may precede "regpntr"), or NULL if the data could not be mapped.
+
+*  Description:
+*     Maps the bytes of a dataset directly from the container file. Failure
+*     to map is not an error: NULL is returned and the caller is expected to
+*     fall back to reading the data into memory. The caller is responsible for
+*     deciding whether a direct mapping is appropriate (the dataset must be
+*     contiguous and the stored type must be the type required).
+
+*  Notes:
+*     - This is the common code used by datMap and datBasic.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <stdio.h>
+#include <fcntl.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+#include "f77.h"
+
+static void *
+dat1Mmap( size_t nbytes, int prot, int flags, int fd, off_t offset, int *isreg, void **pntr, size_t * actbytes, int * status );
+
+void *
+dat1MmapDataset( HDSLoc *locator, hdsmode_t accmode, unsigned intent,
+                 haddr_t offset, size_t nbytes, int *isreg,
+                 void **regpntr, size_t *actbytes, int *status ) {
+  void * mapped = NULL;
+  int fd = 0;
+  int flags = 0;
+  int prot = 0;
+  hdsbool_t opened_fd = 0;
+  uint64_t tstage = 0;
+
+  if ( intent == H5F_ACC_RDONLY || accmode == HDSMODE_READ ) {
+    flags |= O_RDONLY;
+    prot = PROT_READ;
+  } else {
+    flags |= O_RDWR;
+    prot = PROT_READ | PROT_WRITE;
+  }
+
+  if (*status == SAI__OK) {
+    /* see what file driver we have */
+    hid_t fapl_id = -1;
+    hid_t fdriv_id = -1;
+    void * file_handle = NULL;
+    herr_t herr = -1;
+    fapl_id = H5Fget_access_plist(locator->file_id);
+    fdriv_id = H5Pget_driver(fapl_id);
+    if (fdriv_id == H5FD_SEC2 || fdriv_id == H5FD_STDIO) {
+      /* If this is a POSIX or STDIO driver we get the handle */
+      herr = H5Fget_vfd_handle( locator->file_id, fapl_id, (void**)&file_handle);
+      if (herr >= 0) {
+        if (fdriv_id == H5FD_SEC2) {
+          fd = *((int *)file_handle);
+        } else if (fdriv_id == H5FD_STDIO) {
+          FILE * fh = (FILE *)file_handle;
+          fd = fileno(fh);
+        }
+      }
+    }
+    if (fapl_id > 0) H5Pclose( fapl_id );
+
+    if (fd == 0) {
+      /* We have to open the file ourselves! */
+      char * fname = NULL;
+      fname = dat1GetFullName( locator->dataset_id, 1, NULL, status );
+      fd = open(fname, flags);
+      opened_fd = 1;
+      if (fname) MEM_FREE(fname);
+    }
+    if (fd > 0) {
+      /* Set up for memory mapping */
+      int mflags = 0;
+      mflags = MAP_SHARED | MAP_FILE;
+      if (*status == SAI__OK) {
+        HDS1_STATS_BEGIN( tstage );
+        mapped = dat1Mmap( nbytes, prot, mflags, fd, offset, isreg, regpntr, actbytes, status );
+        HDS1_STATS_END( HDS__STAT_MMAP, tstage, nbytes, locator->handle );
+        if (*status == SAI__OK) {
+          /* Store the file descriptor in the locator to allow us to close */
+          if (mapped) {
+            if (opened_fd) locator->fdmap = fd;
+            locator->uses_true_mmap = 1;
+          }
+        } else {
+          /* Not currently fatal -- we can try without the file */
+          if (opened_fd) close(fd);
+          emsAnnul(status);
+        }
+      }
+    }
+  }
+
+  return mapped;
+}
+
+static void *
+dat1Mmap( size_t nbytes, int prot, int flags, int fd, off_t offset, int *isreg, void **pntr, size_t *actbytes, int * status ) {
+  void * mapped = NULL;
+  int tries = 0;
+  size_t pagesize = 0;
+  void * where = NULL;
+  off_t off = 0;
+  *pntr = NULL;
+  *isreg = 0;
+
+  if (*status != SAI__OK) return NULL;
+
+  /* We need to know the pagesize */
+  pagesize = sysconf( _SC_PAGESIZE );
+
+  *actbytes = nbytes;
+  if (offset > 0) {
+    /* Calculate the starting offset into the file and round this down to a     */
+    /* multiple of the system page size. Calculate the number of bytes to map,  */
+    /* allowing for this rounding.                                              */
+    off = offset - ( offset % pagesize );
+    *actbytes += ( offset - off );
+  }
+
+  /* Try the window reserved for mappings first, where the pointer can only
+     clash with one registered by other means. Each clash costs a single
+     remapping. */
+  while (!mapped && tries < 100) {
+    tries++;
+    mapped = hds1WindowMap( *actbytes, prot, flags, fd, off );
+    if (!mapped) break;
+    if (mapped == MAP_FAILED) {
+      emsSyser( "MESSAGE", errno );
+      *status = DAT__FILMP;
+      emsRep("datMap_2", "Error mapping some memory: ^MESSAGE", status );
+      mapped = NULL;
+      goto CLEANUP;
+    }
+    *pntr = mapped + (offset - off );
+    *isreg = cnfRegp( *pntr );
+    if (*isreg == -1) {
+      /* Serious internal error */
+      *status = DAT__FILMP;
+      emsRep("datMap_3", "Error registering a pointer for mapped data "
+             " - internal CNF error", status );
+      goto CLEANUP;
+    } else if (*isreg == 0) {
+      hds1Munmap( mapped, *actbytes );
+      mapped = NULL;
+      *pntr = NULL;
+    }
+  }
+
+  /* Otherwise let the kernel choose the address */
+  tries = 0;
+  while (!mapped) {
+    *isreg = 0;
+    tries++;
+    if (*status != SAI__OK) goto CLEANUP;
+
+    /* Get some anonymous memory - we always have to map read/write
+       because we always have to copy data into this space. */
+    //printf("mmap(%p, %zu, %d, %d, %d, %zu -> %zu [%d])\n", where, *actbytes, prot, flags, fd, offset, off, pagesize);
+    mapped = mmap( where, *actbytes, prot, flags, fd, off );
+    if (mapped == MAP_FAILED) {
+      emsSyser( "MESSAGE", errno );
+      *status = DAT__FILMP;
+      emsRep("datMap_2", "Error mapping some memory: ^MESSAGE", status );
+      mapped = NULL;
+      *pntr = NULL;
+      goto CLEANUP;
+    }
+    /* The pointer we register is the one that has been corrected
+       for the shift we applied in the original request */
+    *pntr = mapped + (offset - off );
+
+    /* Must register with CNF so the pointer can be used by Fortran */
+    *isreg = cnfRegp( *pntr );
+    if (*isreg == -1) {
+      /* Serious internal error */
+      *status = DAT__FILMP;
+      emsRep("datMap_3", "Error registering a pointer for mapped data "
+             " - internal CNF error", status );
+      goto CLEANUP;
+    } else if (*isreg == 0) {
+      /* Free the memory and try again */
+      if ( munmap( mapped, *actbytes ) != 0 ) {
+        *status = DAT__FILMP;
+        emsSyser( "MESSAGE", errno );
+        emsRep("datMap_4", "Error unmapping mapped memory following"
+               " failed registration: ^MESSAGE", status);
+        goto CLEANUP;
+      }
+      if (!where) where = mapped;
+      where += pagesize;
+      mapped = NULL;
+      *pntr = NULL;
+    }
+
+    if (!mapped && tries > 100) {
+      *status = DAT__FILMP;
+      emsRepf("datMap_4b", "Failed to register mapped memory with CNF"
+             " after %d attempts", status, tries );
+      goto CLEANUP;
+    }
+
+  }
+ CLEANUP:
+  return mapped;
+}
@@ -0,0 +1,189 @@
+/*
+*+
+*  Name:
+*     dat1MoveHandle
+
+*  Purpose:
+*     Update the tree of Handles after an object has been moved or renamed.
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1MoveHandle( Handle *handle, Handle *newparent, const char *name,
+*                          int *status );
+
+*  Arguments:
+*     handle = Handle * (Given)
+*        Pointer to the Handle for the object that has been moved.
+*     newparent = Handle * (Given)
+*        Pointer to the Handle for the structure that now contains the object.
+*     name = const char * (Given)
+*        The new (cleaned) name of the object within "newparent".
+*     status = int * (Given and Returned)
+*        Pointer to the inherited status value.
+
+*  Description:
+*     Moves the Handle so that it becomes a child of "newparent" with the
+*     given name, so that the Handle tree continues to mirror the HDF5
+*     hierarchy. Any HDS paths cached in the Handle or in the Handles of its
+*     components are cleared, since they will have changed.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+
+#include "dat_err.h"
+
+static void dat1ClearPath( Handle *handle );
+
+void dat1MoveHandle( Handle *handle, Handle *newparent, const char *name,
+                     int *status ) {
+
+/* Local Variables: */
+   Handle *oldparent;
+   char *lname;
+   char *oldname;
+   int ichild;
+   int ichild_unused = -1;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* Validate the supplied handles. */
+   if( !dat1ValidateHandle( "dat1MoveHandle", handle, status ) ) return;
+   if( !dat1ValidateHandle( "dat1MoveHandle", newparent, status ) ) return;
+
+/* Take a copy of the new name. */
+   lname = MEM_MALLOC( strlen( name ) + 1 );
+   if( !lname ) {
+      *status = DAT__NOMEM;
+      emsRep( " ", "Could not allocate memory for the component name in "
+              "an HDS Handle", status );
+      return;
+   }
+   strcpy( lname, name );
+
+/* If the object has moved to a different structure, find a slot in the
+   children array of the new parent, extending the array if there is no
+   unused slot. */
+   oldparent = handle->parent;
+   if( oldparent != newparent ) {
+      for( ichild = 0; ichild < newparent->nchild; ichild++ ) {
+         if( !newparent->children[ ichild ] ) {
+            ichild_unused = ichild;
+            break;
+         }
+      }
+      if( ichild_unused == -1 ) {
+         Handle **children = MEM_REALLOC( newparent->children,
+                                          (newparent->nchild + 1)*sizeof(Handle *) );
+         if( !children ) {
+            *status = DAT__NOMEM;
+            emsRep( " ", "Could not reallocate memory for child links in an "
+                    "HDS Handle", status );
+            MEM_FREE( lname );
+            return;
+         }
+         newparent->children = children;
+         ichild_unused = newparent->nchild++;
+      }
+
+/* Remove the Handle from the children of its old parent, and add it to
+   the new parent. */
+      if( oldparent ) {
+         for( ichild = 0; ichild < oldparent->nchild; ichild++ ) {
+            if( oldparent->children[ ichild ] == handle ) {
+               oldparent->children[ ichild ] = NULL;
+               break;
+            }
+         }
+      }
+      newparent->children[ ichild_unused ] = handle;
+   }
+
+/* Store the new parent and name. This is done while holding the mutex
+   since the timeline tracer (hdstimeline.c) reads them from other
+   threads. */
+   pthread_mutex_lock( &(handle->mutex) );
+   handle->parent = newparent;
+   oldname = handle->name;
+   handle->name = lname;
+   pthread_mutex_unlock( &(handle->mutex) );
+   if( oldname ) MEM_FREE( oldname );
+
+/* The paths of the object and all its components are now stale. */
+   dat1ClearPath( handle );
+}
+
+/* Clear the cached path in a Handle and all its children. */
+static void dat1ClearPath( Handle *handle ) {
+   int ichild;
+
+   pthread_mutex_lock( &(handle->mutex) );
+   if( handle->path ) {
+      MEM_FREE( handle->path );
+      handle->path = NULL;
+   }
+   pthread_mutex_unlock( &(handle->mutex) );
+
+   for( ichild = 0; ichild < handle->nchild; ichild++ ) {
+      if( handle->children[ ichild ] ) dat1ClearPath( handle->children[ ichild ] );
+   }
+}
@@ -138,6 +138,7 @@ dat1New( const HDSLoc    *locator,
   hid_t dataset_id = 0;
   hid_t dataspace_id = 0;
   hid_t cparms = 0;
+  hid_t gcpl = H5P_DEFAULT;
   hid_t h5type = 0;
   hid_t place = 0;
   int isprim;
@@ -191,11 +192,14 @@ dat1New( const HDSLoc    *locator,
       dat1SetAttrString( group_id, HDS__ATTR_ROOT_NAME, cleanname, status );
 
     } else {
+      gcpl = dat1GroupProps( place, status );
       CALLHDFE( hid_t, group_id,
-               H5Gcreate2(place, cleanname, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+               H5Gcreate2(place, cleanname, H5P_DEFAULT, gcpl, H5P_DEFAULT),
                DAT__HDF5E,
                emsRepf("dat1New_4", "Error creating structure/group '%s'", status, cleanname)
                );
+      if (gcpl != H5P_DEFAULT) H5Pclose( gcpl );
+      gcpl = H5P_DEFAULT;
     }
 
     /* Actual data type of the structure/group must be stored in an attribute */
@@ -240,6 +244,10 @@ dat1New( const HDSLoc    *locator,
     HDSLoc *thisloc = dat1AllocLoc( status );
     if (*status == SAI__OK) {
       thisloc->handle = dat1Handle( locator, cleanname, 0, status );
+
+      /* The Handle for the top-level object is a child of the Handle
+         for the file, but its HDS path is not derived from it. */
+      if (!locator->group_id && thisloc->handle) thisloc->handle->toplevel = HDS_TRUE;
       thisloc->dataset_id = dataset_id;
       thisloc->group_id = group_id;
       thisloc->dataspace_id = dataspace_id;
@@ -258,6 +266,7 @@ dat1New( const HDSLoc    *locator,
   if (dataset_id) H5Dclose(dataset_id);
   if (dataspace_id) H5Sclose(dataspace_id);
   if (cparms > 0 && cparms != H5P_DEFAULT) H5Pclose(cparms);
+  if (gcpl > 0 && gcpl != H5P_DEFAULT) H5Pclose(gcpl);
   if (group_id) H5Gclose(group_id);
   return NULL;
 }
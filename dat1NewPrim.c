@@ -38,6 +38,16 @@
 *  Description:
 *     Creates an HDF5 dataset given HDF5-style arguments.
 
+*  Notes:
+*     - If the CHUNK tuning parameter is set, primitive arrays larger
+*       than the given size are stored in chunks of about that size.
+*       Each chunk spans the full extent of the fastest varying
+*       dimensions that fit, so that it holds whole rows or planes.
+*     - Chunked primitives are compressed if the COMPRESS tuning
+*       parameter is set.
+*     - The CHUNK and COMPRESS values given for the container file in a
+*       tuning file, if any, are used in place of the global values.
+
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     {enter_new_authors_here}
@@ -107,6 +117,11 @@
 void dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type,
                   const char * name_str, hid_t * dataset_id, hid_t *dataspace_id, int *status ) {
   hid_t cparms = H5P_DEFAULT;
+  hdsbool_t chunked = HDS_FALSE;
+#if !HDS_USE_CHUNKED_DATASETS
+  hsize_t h5chunk[DAT__MXDIM];
+  size_t chunkbytes = 0;
+#endif
   *dataset_id = 0;
   *dataspace_id = 0;
 
@@ -152,9 +167,44 @@ void dat1NewPrim( hid_t group_id, int ndim, const hsize_t h5dims[], hid_t h5type
     /* We can not find out the optimum chunk size from HDS API so we choose
        the initial size. */
     CALLHDFQ( H5Pset_chunk( cparms, ndim, h5dims ) );
-
+    chunked = HDS_TRUE;
+
+#else
+    /* Otherwise large arrays are chunked only if requested. HDF5 C order
+       puts the fastest varying dimension last. */
+    chunkbytes = (size_t)hds1TuneObject( group_id, "CHUNK",
+                                         hds1GetChunk() ) * 1024;
+    if (chunkbytes > 0) {
+      size_t nbytes = H5Tget_size( h5type );
+      size_t incbytes = nbytes;
+      int i;
+
+      for (i = 0; i < ndim; i++) nbytes *= h5dims[i];
+
+      if (nbytes > chunkbytes) {
+        for (i = ndim - 1; i >= 0; i--) {
+          if (incbytes * h5dims[i] <= chunkbytes) {
+            h5chunk[i] = h5dims[i];
+          } else {
+            h5chunk[i] = chunkbytes / incbytes;
+            if (h5chunk[i] < 1) h5chunk[i] = 1;
+          }
+          incbytes *= h5chunk[i];
+        }
+        CALLHDFQ( H5Pset_chunk( cparms, ndim, h5chunk ) );
+        chunked = HDS_TRUE;
+      }
+    }
 #endif
 
+    /* Chunked primitives may also be compressed */
+    if (chunked) {
+      int compress = hds1TuneObject( group_id, "COMPRESS", hds1GetCompress() );
+      if (compress > 0 && H5Zfilter_avail( H5Z_FILTER_DEFLATE ) > 0) {
+        CALLHDFQ( H5Pset_deflate( cparms, compress ) );
+      }
+    }
+
     /* Create the data space for the dataset */
     CALLHDFE( hid_t, *dataspace_id,
              H5Screate_simple( ndim, h5dims, maxdims ),
@@ -0,0 +1,195 @@
+/*
+*+
+*  Name:
+*     dat1ObjectLoc
+
+*  Purpose:
+*     Create a locator for a component that has already been opened
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     HDSLoc *dat1ObjectLoc( const char *func, const HDSLoc *locator1,
+*                            Handle *parent, const char *name, hid_t objid,
+*                            int *status );
+
+*  Arguments:
+*     func = const char * (Given)
+*        Name of the calling public routine, used in error messages.
+*     locator1 = const HDSLoc * (Given)
+*        Locator for the structure containing the component, or for an
+*        ancestor of that structure within the same file.
+*     parent = Handle * (Given)
+*        Handle for the structure that directly contains the component.
+*        If NULL, the Handle associated with "locator1" is used.
+*     name = const char * (Given)
+*        Cleaned name of the component within "parent". For a cell of a
+*        structure array this is the cell group name.
+*     objid = hid_t (Given)
+*        HDF5 identifier for the open group or dataset. This routine
+*        takes ownership of the identifier, which will be closed when the
+*        returned locator is annulled (or on error).
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned Value:
+*     The new locator, or NULL on error.
+
+*  Description:
+*     Wraps an open HDF5 group or dataset in a new secondary locator,
+*     registering it, associating it with a Handle and locking it for use
+*     by the current thread with the same sort of lock as the parent. This
+*     is the common code for every routine that locates a component within
+*     a structure (datFind, datIterate, etc).
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     18-OCT-2026:
+*        Add "parent" argument so that datFindPath can attach the locator
+*        to a Handle deeper in the tree than "locator1".
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+HDSLoc *
+dat1ObjectLoc( const char *func, const HDSLoc *locator1, Handle *parent,
+               const char *name, hid_t objid, int *status ) {
+
+  HDSLoc * thisloc = NULL;
+  H5I_type_t objtype;
+  int rdonly;
+  int lockinfo;
+
+  if (*status != SAI__OK) {
+    if (objid > 0) H5Oclose( objid );
+    return NULL;
+  }
+
+  /* Make sure we have a supported type */
+  objtype = H5Iget_type( objid );
+  if (objtype != H5I_GROUP && objtype != H5I_DATASET) {
+    *status = DAT__OBJIN;
+    emsRepf("dat1ObjectLoc_1", "%s: Component '%s' exists but is neither group"
+            " nor dataset.", status, func, name);
+    if (objid > 0) H5Oclose( objid );
+    return NULL;
+  }
+
+  /* Create the locator */
+  thisloc = dat1AllocLoc( status );
+  if (*status != SAI__OK) {
+    H5Oclose( objid );
+    return NULL;
+  }
+
+  /* Child locators are not primary by default -- just store the file_id and register  */
+  thisloc->file_id = locator1->file_id;
+  thisloc->hdsFile = locator1->hdsFile;
+  hds1RegLocator( thisloc, status );
+
+  if (objtype == H5I_DATASET) {
+    /* A dataset also needs its data space */
+    thisloc->dataset_id = objid;
+    CALLHDFE( hid_t, thisloc->dataspace_id,
+            H5Dget_space( objid ),
+            DAT__OBJIN,
+            emsRepf("dat1ObjectLoc_2", "%s: Error retrieving data space from primitive named %s",
+                    status, func, name)
+            );
+  } else {
+    thisloc->group_id = objid;
+  }
+
+  /* Store a pointer to the handle for the returned HDF object */
+  if (parent) {
+    thisloc->handle = dat1HandleChild( parent, name, 0, status );
+  } else {
+    parent = locator1->handle;
+    thisloc->handle = dat1Handle( locator1, name, 0, status );
+  }
+
+  /* We have to propagate groupness to the child */
+  if ( (locator1->grpname)[0] != '\0') hdsLink(thisloc, locator1->grpname, status);
+
+  /* Determine if the current thread has a read-only or read-write lock
+     on the parent object. */
+  dat1HandleLock( parent, 1, 0, 0, &lockinfo, status );
+  rdonly = ( lockinfo == 3 );
+
+  /* Attempt to lock the component object for use by the current thread,
+     using the same sort of lock (read-only or read-write) as the
+     parent object. Report an error if this fails. */
+  dat1HandleLock( thisloc->handle, 2, 0, rdonly, &lockinfo, status );
+  if( !lockinfo && *status == SAI__OK ) {
+     *status = DAT__THREAD;
+     emsSetc( "C", name );
+     emsSetc( "A", rdonly ? "read-only" : "read-write" );
+     emsSetc( "F", func );
+     datMsg( "O", locator1 );
+     emsRep( "","^F: requested component ('^C') within HDS object '^O' "
+             "cannot be locked for ^A access - another thread already has "
+             "a conflicting lock on the same component.", status );
+  }
+
+ CLEANUP:
+  if (*status != SAI__OK && thisloc) datAnnul( &thisloc, status );
+  return thisloc;
+}
@@ -0,0 +1,234 @@
+/*
+*+
+*  Name:
+*     dat1RecreatePrim
+
+*  Purpose:
+*     Replace a primitive with a new dataset holding the same bytes
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     void dat1RecreatePrim( const char *func, HDSLoc *locator, hid_t h5type,
+*                            int ndim, const hdsdim dims[], int *status );
+
+*  Arguments:
+*     func = const char * (Given)
+*        Name of the calling public routine, used in error messages.
+*     locator = HDSLoc * (Given and Returned)
+*        Locator for the primitive. On exit it refers to the new dataset.
+*     h5type = hid_t (Given)
+*        HDF5 file data type for the new dataset. If zero, the type of the
+*        existing dataset is used. Must have the same size as the existing
+*        type.
+*     ndim = int (Given)
+*        Number of dimensions for the new dataset. Ignored if "dims" is NULL.
+*     dims = const hdsdim [] (Given)
+*        Dimensions for the new dataset, which must have the same number of
+*        elements as the existing dataset. If NULL, the existing dimensions
+*        are used.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     HDF5 does not allow the data type or the rank of an existing dataset
+*     to be changed. This routine creates a new dataset with the requested
+*     type and shape, copies the stored bytes of the existing dataset into
+*     it without any type conversion, deletes the original and gives the new
+*     dataset its name. The supplied locator is updated to refer to the new
+*     dataset and is given a new Handle, locked in the same way as before.
+
+*  Notes:
+*     - This is the fallback for datMould and datRetyp when the change can
+*       not be made to the metadata alone.
+*     - The data are only read if the original dataset has been written to.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+#include "star/one.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+void
+dat1RecreatePrim( const char *func, HDSLoc *locator, hid_t h5type,
+                  int ndim, const hdsdim dims[], int *status ) {
+
+  HDSLoc * parloc = NULL;
+  hid_t oldtype = 0;
+  hid_t newtype = 0;
+  hid_t new_dataset_id = 0;
+  hid_t new_dataspace_id = 0;
+  hid_t dxpl = H5P_DEFAULT;
+  hsize_t h5dims[DAT__MXDIM];
+  hdsdim curdims[DAT__MXDIM];
+  int curndim = 0;
+  char primname[DAT__SZNAM+1];
+  char tempname[3*DAT__SZNAM+1];
+  hdsbool_t state = HDS_FALSE;
+  void *buffer = NULL;
+  int rdonly;
+  int lockinfo;
+
+  if (*status != SAI__OK) return;
+
+  /* The values copied must include any still being written, and any
+     values prefetched from the old dataset are no longer wanted */
+  hds1WriteWait( locator->handle, status );
+  hds1PrefetchDiscard( locator );
+  hds1WriteNote( locator->handle );
+
+  if (!dims) {
+    datShape( locator, DAT__MXDIM, curdims, &curndim, status );
+    ndim = curndim;
+    dims = curdims;
+  }
+  dat1ImportDims( func, ndim, dims, h5dims, status );
+
+  /* Need enclosing group locator */
+  datParen( locator, &parloc, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  CALLHDFE( hid_t, oldtype,
+           H5Dget_type( locator->dataset_id ),
+           DAT__HDF5E,
+           emsRepf("dat1RecreatePrim_1", "%s: Error obtaining data type of dataset",
+                   status, func)
+           );
+  newtype = (h5type > 0 ? h5type : oldtype);
+
+  /* Create the new dataset with a name related to this dataset but which
+     does not conform to the HDS rules. A left over entry can only be
+     from an earlier failure, so remove it. */
+  datName( locator, primname, status );
+  one_snprintf( tempname, sizeof(tempname), "%s%s", status,
+                "+TEMPORARY_DATASET_", primname );
+  if (*status != SAI__OK) goto CLEANUP;
+  if (H5Lexists( parloc->group_id, tempname, H5P_DEFAULT) > 0) {
+    H5Ldelete( parloc->group_id, tempname, H5P_DEFAULT );
+  }
+
+  dat1NewPrim( parloc->group_id, ndim, h5dims, newtype, tempname,
+               &new_dataset_id, &new_dataspace_id, status );
+
+  /* Copy the stored bytes. Using the file types as the memory types means
+     HDF5 does no conversion in either direction. */
+  datState( locator, &state, status );
+  if (state && *status == SAI__OK) {
+    hssize_t npoints = H5Sget_simple_extent_npoints( locator->dataspace_id );
+    size_t nbytes = H5Tget_size( oldtype ) * (npoints > 0 ? (size_t)npoints : 1);
+
+    buffer = MEM_MALLOC( nbytes );
+    if (!buffer) {
+      *status = DAT__NOMEM;
+      emsRepf("dat1RecreatePrim_2", "%s: Unable to allocate %zu bytes to "
+              "copy primitive '%s'", status, func, nbytes, primname );
+      goto CLEANUP;
+    }
+    dxpl = dat1XferProps( status );
+    CALLHDFQ( H5Dread( locator->dataset_id, oldtype, H5S_ALL, H5S_ALL,
+                       dxpl, buffer ) );
+    CALLHDFQ( H5Dwrite( new_dataset_id, newtype, H5S_ALL, H5S_ALL,
+                        dxpl, buffer ) );
+  }
+  if (*status != SAI__OK) goto CLEANUP;
+
+  /* Determine if the current thread has a read-only or read-write lock
+     on the supplied object referenced by the supplied locator. */
+  dat1HandleLock( locator->handle, 1, 0, 0, &lockinfo, status );
+  rdonly = ( lockinfo == 3 );
+
+  /* Delete the source dataset -- free resources in supplied locator */
+  H5Sclose( locator->dataspace_id );
+  H5Dclose( locator->dataset_id );
+  locator->dataspace_id = new_dataspace_id;
+  locator->dataset_id = new_dataset_id;
+  new_dataspace_id = new_dataset_id = 0;
+  datErase( parloc, primname, status );
+
+  /* Relocate the new dataset */
+  CALLHDFQ(H5Lmove( parloc->group_id, tempname,
+                    parloc->group_id, primname, H5P_DEFAULT, H5P_DEFAULT));
+
+  /* Give it a new handle (the old one will have been erased within
+     datErase above) and lock it in the same way as before. */
+  locator->handle = dat1Handle( parloc, primname, rdonly, status );
+  dat1HandleLock( locator->handle, 2, 0, rdonly, &lockinfo, status );
+  if( !lockinfo && *status == SAI__OK ) {
+     *status = DAT__THREAD;
+     emsSetc( "A", rdonly ? "read-only" : "read-write" );
+     emsSetc( "F", func );
+     emsRep( " ","^F: modified object cannot be locked for ^A "
+             "access.", status );
+  }
+
+ CLEANUP:
+  if (buffer) MEM_FREE( buffer );
+  if (new_dataset_id > 0) {
+    H5Dclose( new_dataset_id );
+    if (parloc) H5Ldelete( parloc->group_id, tempname, H5P_DEFAULT );
+  }
+  if (new_dataspace_id > 0) H5Sclose( new_dataspace_id );
+  if (oldtype > 0) H5Tclose( oldtype );
+  if (parloc) datAnnul( &parloc, status );
+}
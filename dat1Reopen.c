@@ -123,6 +123,10 @@ hid_t dat1Reopen( hid_t file_id, unsigned int flags, hid_t fapl,
    list of file_ids for the same file that have associated locators. */
    hds1GetLocators( file_id, &nloc, &loclist, &file_ids, status );
 
+/* Any writes to the file still being made in the background must be
+   completed before it is closed. */
+   if( nloc > 0 ) hds1WriteWaitFile( loclist[ 0 ]->handle, status );
+
 /* Check that none of the locators are mapped. */
    if( *status == SAI__OK ) {
       loc = loclist;
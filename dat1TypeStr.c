@@ -0,0 +1,172 @@
+/*
+*+
+*  Name:
+*     dat1TypeStr
+
+*  Purpose:
+*     Obtain the HDS type string for an open HDF5 group or dataset
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hdstype_t dat1TypeStr( hid_t objid, char type_str[DAT__SZTYP+1],
+*                            int *status );
+
+*  Arguments:
+*     objid = hid_t (Given)
+*        Identifier for an open HDF5 group or dataset.
+*     type_str = char * (Returned)
+*        Buffer of size DAT__SZTYP+1 to receive the HDS type.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned Value:
+*     The HDS type code. HDSTYPE_STRUCTURE is returned for a group.
+
+*  Description:
+*     Determines the HDS type of an HDF5 object without requiring a locator.
+*     For groups the type is read from the CLASS attribute, and for datasets
+*     it is derived from the HDF5 data type.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "star/one.h"
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+hdstype_t
+dat1TypeStr( hid_t objid, char type_str[DAT__SZTYP+1], int *status ) {
+
+  hdstype_t hdstyp = HDSTYPE_NONE;
+  hid_t h5type = 0;
+  H5I_type_t objtype;
+
+  type_str[0] = '\0';
+  if (*status != SAI__OK) return hdstyp;
+
+  objtype = H5Iget_type( objid );
+
+  if (objtype == H5I_GROUP) {
+    /* Read the type attribute */
+    dat1GetAttrString( objid, HDS__ATTR_STRUCT_TYPE, HDS_TRUE,
+                       "HDF5NATIVEGROUP", type_str, DAT__SZTYP+1, status );
+    if (*status == SAI__OK) hdstyp = HDSTYPE_STRUCTURE;
+    return hdstyp;
+
+  } else if (objtype != H5I_DATASET) {
+    *status = DAT__OBJIN;
+    emsRep("dat1TypeStr_1", "Object is neither a structure nor a primitive",
+           status);
+    return hdstyp;
+  }
+
+  CALLHDFE( hid_t, h5type,
+           H5Dget_type( objid ),
+           DAT__HDF5E,
+           emsRep("dat1TypeStr_2", "datType: Error obtaining data type of dataset", status)
+           );
+
+  hdstyp = dau1HdsType( h5type, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  switch (hdstyp) {
+  case HDSTYPE_INTEGER:
+    one_strlcpy( type_str, "_INTEGER", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_REAL:
+    one_strlcpy( type_str, "_REAL", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_DOUBLE:
+    one_strlcpy( type_str, "_DOUBLE", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_BYTE:
+    one_strlcpy( type_str, "_BYTE", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_UBYTE:
+    one_strlcpy( type_str, "_UBYTE", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_WORD:
+    one_strlcpy( type_str, "_WORD", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_UWORD:
+    one_strlcpy( type_str, "_UWORD", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_LOGICAL:
+    one_strlcpy( type_str, "_LOGICAL", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_INT64:
+    one_strlcpy( type_str, "_INT64", DAT__SZTYP+1, status);
+    break;
+  case HDSTYPE_CHAR:
+    /* Character types include the string length */
+    one_snprintf( type_str, DAT__SZTYP+1, "_CHAR*%zu", status,
+                  H5Tget_size( h5type ) );
+    break;
+  default:
+    *status = DAT__TYPIN;
+    emsRepf("datType_inv","datType: Unknown type associated with dataset/group (%d)",
+            status, hdstyp);
+  }
+
+ CLEANUP:
+  if (h5type > 0) H5Tclose(h5type);
+  return hdstyp;
+}
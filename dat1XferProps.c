@@ -0,0 +1,199 @@
+/*
+*+
+*  Name:
+*     dat1XferProps
+
+*  Purpose:
+*     Return the transfer properties for reading and writing primitives
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hid_t dat1XferProps( int *status );
+
+*  Arguments:
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Returned Value:
+*     hid_t
+*        Dataset transfer property list. H5P_DEFAULT if no special properties
+*        are required. It must not be closed by the caller.
+
+*  Description:
+*     Returns the dataset transfer property list that should be passed to
+*     H5Dread and H5Dwrite. If the NBLOCKS tuning parameter is set, the buffer
+*     in which HDF5 converts data types is given that many 512-byte blocks, so
+*     that large arrays needing conversion are transferred in fewer pieces. If
+*     the HYPERVEC tuning parameter is set, it gives the number of pieces of a
+*     selection that HDF5 handles at once.
+
+*  Notes:
+*     - A property list is created the first time each combination of the
+*       tuning parameters is used, and is kept until the program exits. A
+*       list therefore remains valid for a transfer in progress if the
+*       parameters are changed by another thread.
+*     - No HDF5 routine is called while the cache of lists is locked, since
+*       this may be called from within HDF5 callbacks (e.g. by datIterate)
+*       that hold the HDF5 library lock.
+*     - H5P_DEFAULT is returned if an error occurs.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <pthread.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* Smallest conversion buffer, in 512-byte blocks. Large enough for one
+   element of any HDS type, which HDF5 requires. */
+#define MIN_NBLOCKS 128
+
+/* A property list and the tuning parameter values used to create it */
+typedef struct XferProps {
+  int nblocks;
+  int hypervec;
+  hid_t plist;
+} XferProps;
+
+/* The property lists created so far. Protected by "xfer_mutex". */
+static XferProps *xfer_lists = NULL;
+static size_t nxfer_lists = 0;
+static pthread_mutex_t xfer_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static hid_t dat1FindXferProps( int nblocks, int hypervec );
+
+hid_t dat1XferProps( int *status ) {
+  hid_t dxpl = H5P_DEFAULT;
+  hid_t newlist = 0;
+  XferProps *lists;
+  int nblocks;
+  int hypervec;
+
+  if (*status != SAI__OK) return dxpl;
+
+  nblocks = hds1GetNblocks();
+  hypervec = hds1GetHyperVec();
+  if (nblocks <= 0 && hypervec <= 0) return dxpl;
+  if (nblocks > 0 && nblocks < MIN_NBLOCKS) nblocks = MIN_NBLOCKS;
+
+  dxpl = dat1FindXferProps( nblocks, hypervec );
+  if (dxpl != H5P_DEFAULT) return dxpl;
+
+  CALLHDFE( hid_t, newlist,
+            H5Pcreate( H5P_DATASET_XFER ),
+            DAT__HDF5E,
+            emsRep("dat1XferProps_1", "Error creating dataset transfer properties",
+                   status )
+            );
+  if (nblocks > 0) {
+    CALLHDFQ( H5Pset_buffer( newlist, (size_t)nblocks * 512, NULL, NULL ) );
+  }
+  if (hypervec > 0) {
+    CALLHDFQ( H5Pset_hyper_vector_size( newlist, hypervec ) );
+  }
+
+  /* Another thread may have created the same list in the meantime */
+  dxpl = dat1FindXferProps( nblocks, hypervec );
+  if (dxpl != H5P_DEFAULT) goto CLEANUP;
+
+  pthread_mutex_lock( &xfer_mutex );
+  lists = MEM_REALLOC( xfer_lists, (nxfer_lists + 1) * sizeof(*lists) );
+  if (lists) {
+    xfer_lists = lists;
+    xfer_lists[nxfer_lists].nblocks = nblocks;
+    xfer_lists[nxfer_lists].hypervec = hypervec;
+    xfer_lists[nxfer_lists].plist = newlist;
+    nxfer_lists++;
+    dxpl = newlist;
+    newlist = 0;
+  }
+  pthread_mutex_unlock( &xfer_mutex );
+
+  if (!lists) {
+    *status = DAT__NOMEM;
+    emsRep("dat1XferProps_2", "Unable to allocate memory for dataset "
+           "transfer properties", status );
+  }
+
+ CLEANUP:
+  if (newlist > 0) H5Pclose( newlist );
+  return dxpl;
+}
+
+/* Return the property list created for the given tuning parameter values,
+   or H5P_DEFAULT if there is none yet */
+static hid_t dat1FindXferProps( int nblocks, int hypervec ) {
+  hid_t result = H5P_DEFAULT;
+  size_t i;
+
+  pthread_mutex_lock( &xfer_mutex );
+  for (i = 0; i < nxfer_lists; i++) {
+    if (xfer_lists[i].nblocks == nblocks &&
+        xfer_lists[i].hypervec == hypervec) {
+      result = xfer_lists[i].plist;
+      break;
+    }
+  }
+  pthread_mutex_unlock( &xfer_mutex );
+  return result;
+}
@@ -249,6 +249,12 @@ datAlter( HDSLoc *locator, int ndim, const hdsdim dims[], int *status) {
     /* Copy dimensions and reorder */
     dat1ImportDims( "datAlter", ndim, dims, h5dims, status );
 
+    /* Any values prefetched from the dataset are for the old shape, and
+       the dataset itself may be replaced below */
+    hds1WriteWait( locator->handle, status );
+    hds1PrefetchDiscard( locator );
+    hds1WriteNote( locator->handle );
+
     /* First we simply try the native resize. This will only work
        if the system is using chunked storage and the registered
        upper limit to the bounds is acceptable. If it fails we will
@@ -88,11 +88,14 @@
 #include "hds.h"
 
 int datAnnul( HDSLoc **locator, int * status ) {
+  uint64_t tstart = 0;
 
   /* Sanity check argument */
   if (!locator) return *status;
   if (! *locator) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Begin an entirely new error context as we need to run this
      regardless of external errors */
   emsBegin( status );
@@ -106,5 +109,6 @@ int datAnnul( HDSLoc **locator, int * status ) {
   /* End the error context and return the final status */
   emsEnd( status );
 
+  HDS1_STATS_END( HDS__STAT_DATANNUL, tstart, 0, NULL );
   return *status;
 }
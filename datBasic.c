@@ -37,8 +37,15 @@
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Does not attempt to interpret the bytes.
-*     - Not implemented in HDF5 interface.
+*     - Does not attempt to interpret the bytes. Each element occupies the
+*       number of bytes used to store it in the file (see datLen), which
+*       for _LOGICAL is one byte.
+*     - Where possible (a contiguous dataset in a file opened read-only)
+*       the stored bytes are memory mapped directly, as for datMap.
+*       Otherwise they are read into memory using the stored data type,
+*       so that no conversion takes place, and written back by datUnmap
+*       for UPDATE and WRITE access.
+*     - Release the mapping with datUnmap.
 
 *  History:
 *     2014-10-14 (TIMJ):
@@ -86,6 +93,8 @@
 *-
 */
 
+#include <sys/mman.h>
+
 #include "hdf5.h"
 
 #include "ems.h"
@@ -95,20 +104,165 @@
 #include "dat1.h"
 #include "hds.h"
 
+#include "dat_err.h"
+
+#include "f77.h"
+
 int
 datBasic(const HDSLoc *locator, const char *mode_c, unsigned char **pntr,
          size_t *len, int *status) {
 
+  HDSLoc *loc = (HDSLoc *)locator;  /* Mapping state lives in the locator */
+  hdsmode_t accmode = HDSMODE_UNKNOWN;
+  hid_t h5type = 0;
+  haddr_t offset;
+  hssize_t npoints = 0;
+  hdsbool_t try_mmap = HDS_FALSE;
+  unsigned intent = 0;
+  size_t nbytes = 0;
+  size_t actbytes = 0;
+  void *mapped = NULL;
+  void *regpntr = NULL;
+  int isreg = 0;
+  uint64_t tstart = 0;
+
   *len = 0;
   *pntr = NULL;
 
-  if (*status == SAI__OK) return *status;
+  if (*status != SAI__OK) return *status;
 
-  *status = SAI__ERROR;
-  emsRep("datBasic", "datBasic is not available in HDF5 interface",
-         status);
+  HDS1_STATS_BEGIN( tstart );
 
-  return *status;
+  /* First have to validate the access mode */
+  switch (mode_c[0]) {
+  case 'R':
+  case 'r':
+    accmode = HDSMODE_READ;
+    break;
+  case 'U':
+  case 'u':
+    accmode = HDSMODE_UPDATE;
+    break;
+  case 'W':
+  case 'w':
+    accmode = HDSMODE_WRITE;
+    break;
+  default:
+    *status = DAT__MODIN;
+    emsRepf("datBasic_1", "Unrecognized mode string '%s' for datBasic",
+            status, mode_c);
+    goto CLEANUP;
+  }
 
-}
+  /* Validate input locator. */
+  dat1ValidateLocator( "datBasic", 1, locator, (accmode & HDSMODE_READ), status );
+
+  /* Complete any writes to the object that are still in progress */
+  if (*status == SAI__OK) hds1WriteWait( locator->handle, status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  if (locator->dataset_id <= 0) {
+    *status = DAT__OBJIN;
+    emsRep("datBasic_2", "datBasic: Can only map a primitive", status );
+    goto CLEANUP;
+  }
+
+  /* Values read by datPrefetch are not used here */
+  hds1PrefetchDiscard( loc );
+
+  if (locator->regpntr) {
+    *status = DAT__PRMAP;
+    emsRep("datBasic_3", "datBasic: Primitive is already mapped", status );
+    goto CLEANUP;
+  }
 
+  /* Not allowed to map undefined data in READ or UPDATE mode */
+  if (accmode == HDSMODE_UPDATE || accmode == HDSMODE_READ) {
+    hdsbool_t defined;
+    datState( locator, &defined, status );
+    if (!defined && *status == SAI__OK) {
+      *status = DAT__UNSET;
+      emsRepf("datBasic_4", "Can not map an undefined primitive in mode '%s'",
+              status, mode_c);
+      goto CLEANUP;
+    }
+  }
+
+  /* How did we open this file? */
+  CALLHDFQ( H5Fget_intent( locator->file_id, &intent ));
+  if ((accmode == HDSMODE_UPDATE || accmode == HDSMODE_WRITE) &&
+      intent == H5F_ACC_RDONLY) {
+    *status = DAT__ACCON;
+    emsRepf("datBasic_5", "datBasic: Can not map readonly locator in mode '%s'",
+            status, mode_c);
+    goto CLEANUP;
+  }
+
+  /* Number of bytes as stored */
+  CALLHDFE( hid_t, h5type,
+           H5Dget_type( locator->dataset_id ),
+           DAT__HDF5E,
+           emsRep("datBasic_6", "datBasic: Error obtaining data type of dataset",
+                  status)
+           );
+  CALLHDFE( hssize_t, npoints,
+           H5Sget_select_npoints( locator->dataspace_id ),
+           DAT__HDF5E,
+           emsRep("datBasic_7", "datBasic: Error obtaining number of elements",
+                  status)
+           );
+  nbytes = H5Tget_size( h5type ) * (size_t)npoints;
+
+  /* Map the file directly under the same conditions as datMap. The
+     stored type is by definition the type we want. */
+  offset = H5Dget_offset( locator->dataset_id );
+  try_mmap = ( offset != HADDR_UNDEF && !locator->isslice &&
+               intent == H5F_ACC_RDONLY &&
+               hds1TuneObject( locator->file_id, "MAP", hds1GetUseMmap() ) );
+  if (try_mmap) {
+    mapped = dat1MmapDataset( loc, accmode, intent, offset, nbytes,
+                              &isreg, &regpntr, &actbytes, status );
+  }
+
+  /* Otherwise read the bytes into memory */
+  if (!regpntr) {
+    if (accmode == HDSMODE_WRITE) {
+      regpntr = cnfCalloc( 1, nbytes );
+    } else {
+      regpntr = cnfMalloc( nbytes );
+    }
+    if (!regpntr) {
+      *status = DAT__NOMEM;
+      emsRepf("datBasic_8","datBasic: Unable to allocate %zu bytes of memory",
+              status, nbytes);
+      goto CLEANUP;
+    }
+    if (accmode != HDSMODE_WRITE) dat1BasicIO( locator, HDS_FALSE, regpntr, status );
+  }
+
+ CLEANUP:
+  if (h5type > 0) H5Tclose( h5type );
+
+  if (*status != SAI__OK) {
+    if (mapped) {
+      if (isreg == 1) cnfUregp( regpntr );
+      hds1Munmap( mapped, actbytes );
+      mapped = NULL;
+    } else if (regpntr) {
+      cnfFree( regpntr );
+    }
+    regpntr = NULL;
+  } else {
+    /* Update the locator to reflect the mapped status */
+    loc->pntr = mapped;
+    loc->regpntr = regpntr;
+    loc->bytesmapped = actbytes;
+    loc->accmode = accmode;
+    loc->isbasic = HDS_TRUE;
+    *pntr = regpntr;
+    *len = nbytes;
+  }
+
+  HDS1_STATS_END( HDS__STAT_DATBASIC, tstart, 0, locator->handle );
+  return *status;
+}
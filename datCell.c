@@ -111,9 +111,12 @@ datCell(const HDSLoc *locator1, int ndim, const hdsdim subs[],
   int rdonly;
   char namestr[DAT__SZNAM+1];
   int lockinfo;
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datCell", 1, locator1, 1, status );
 
@@ -258,5 +261,7 @@ datCell(const HDSLoc *locator1, int ndim, const hdsdim subs[],
   } else {
     *locator2 = thisloc;
   }
+  HDS1_STATS_END( HDS__STAT_DATCELL, tstart, 0,
+                  (*status == SAI__OK ? thisloc->handle : locator1->handle) );
   return *status;
 }
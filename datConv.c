@@ -4,7 +4,7 @@
 *     datConv
 
 *  Purpose:
-*     Obsolete routine to check for data conversion
+*     Check whether primitive data can be converted to a given type
 
 *  Language:
 *     Starlink ANSI C
@@ -22,21 +22,23 @@
 *     type_str = const char * (Given)
 *        Target type.
 *     conv = hdsbool_t * (Returned)
-*        True if the data can be converted.
+*        True if the data can be converted to the given type.
 *     status = int* (Given and Returned)
 *        Pointer to global status.
 
 *  Description:
-*     This routine should no longer be used. Originally was
-*     used to determine if primitive data could be converted to
-*     the specified type. HDS can now always do this.
+*     Determines whether the values in a primitive object can be
+*     converted to the specified type, for example by datGet or datMap.
+*     The answer comes from the same fixed conversion table that those
+*     routines use, so no data are accessed.
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Obsolete. Do not use.
+*     - HDS can convert between all the primitive types, so this is
+*       only false if the locator or the type is not primitive.
 
 *  History:
 *     2014-10-17 (TIMJ):
@@ -98,12 +100,36 @@
 int
 datConv(const HDSLoc *locator, const char *type_str, hdsbool_t *conv,
         int *status) {
-  *conv = 1;
+  char normtypestr[DAT__SZTYP+1];
+  hid_t h5type = 0;
+  hdstype_t intype = HDSTYPE_NONE;
+  hdstype_t outtype = HDSTYPE_NONE;
+  int isprim;
+
+  *conv = HDS_FALSE;
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datConv", 1, locator, 1, status );
   if (*status != SAI__OK) return *status;
 
-  *status = DAT__FATAL;
-  emsRep("datConv", "datConv: Obsolete routine. Do not use",
-         status);
+  /* A structure can not be converted but that is not an error */
+  if (locator->dataset_id <= 0) return *status;
+
+  isprim = dau1CheckType( 1, type_str, &h5type, normtypestr,
+                          sizeof(normtypestr), status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  if (isprim) {
+    intype = dat1Type( locator, status );
+    outtype = dau1HdsType( h5type, status );
+    if (*status == SAI__OK) {
+      *conv = ( dat1ConvFlags( intype, outtype ) & HDS__CONV_EXISTS ) ?
+        HDS_TRUE : HDS_FALSE;
+    }
+  }
 
+ CLEANUP:
+  if (h5type > 0) H5Tclose( h5type );
   return *status;
 }
@@ -106,13 +106,19 @@ datCopy( const HDSLoc *locator1, const HDSLoc *locator2,
   char cleanname[DAT__SZNAM+1];
   hid_t parent_id = -1;
   hid_t objid = -1;
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locators. */
   dat1ValidateLocator( "datCopy", 1, locator1, 1, status );
   dat1ValidateLocator( "datCopy", 1, locator2, 0, status );
 
+  /* The copy must include any data still being written */
+  hds1WriteWaitFile( locator1->handle, status );
+
   dau1CheckName( name_str, 1, cleanname, sizeof(cleanname), status );
   if (*status != SAI__OK) return *status;
 
@@ -135,6 +141,7 @@ datCopy( const HDSLoc *locator1, const HDSLoc *locator2,
 
  CLEANUP:
   if (parent_id) H5Gclose(parent_id);
+  HDS1_STATS_END( HDS__STAT_DATCOPY, tstart, 0, locator1->handle );
   return *status;
 
 }
@@ -94,12 +94,18 @@ int
 datErase(const HDSLoc   *locator, const char *name_str, int *status) {
   char groupstr[DAT__SZNAM+1];
   char cleanname[DAT__SZNAM+1];
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datErase", 1, locator, 0, status );
 
+  /* Nothing being erased may still be being written */
+  hds1WriteWaitFile( locator->handle, status );
+
   /* containing locator must refer to a group */
   if (locator->group_id <= 0) {
     *status = DAT__OBJIN;
@@ -124,5 +130,6 @@ datErase(const HDSLoc   *locator, const char *name_str, int *status) {
     emsRepf("datErase_2", "Error deleting component %s in group %s",
             status, name_str, groupstr);
   }
+  HDS1_STATS_END( HDS__STAT_DATERASE, tstart, 0, locator->handle );
   return *status;
 }
@@ -108,14 +108,13 @@ datFind( const HDSLoc   *locator1,
 
   char cleanname[DAT__SZNAM+1];
   HDSLoc * thisloc = NULL;
-  H5O_info_t object_info;
-  int rdonly;
-  int there = 0;
-  int havegroup = 0;
-  int lockinfo;
+  hid_t objid = 0;
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datFind", 1, locator1, 1, status );
   if (*status != SAI__OK) return *status;
@@ -132,113 +131,30 @@ datFind( const HDSLoc   *locator1,
   dau1CheckName( name_str, 1, cleanname, sizeof(cleanname), status );
   if (*status != SAI__OK) return *status;
 
-  /* First ensure that the component exists */
-  datThere( locator1, cleanname, &there, status );
-  if (!there) {
-    if (*status == SAI__OK) {
+  /* Open the component directly. This traverses the link once, rather
+     than checking for existence and then querying the object type
+     before opening it. Only if the open fails do we find out why. */
+  objid = H5Oopen( locator1->group_id, cleanname, H5P_DEFAULT );
+  if (objid < 0) {
+    htri_t exists = H5Lexists( locator1->group_id, cleanname, H5P_DEFAULT );
+    if (exists == 0) {
       *status = DAT__OBJNF;
       emsRepf("datFind_1b", "datFind: Object '%s' not found",
               status, cleanname);
-    }
-    return *status;
-  }
-
-  /* Check the type of the requested object */
-  CALLHDFQ( H5Oget_info_by_name( locator1->group_id, cleanname,
-                                 &object_info, H5P_DEFAULT ) );
-
-  /* Make sure we have a supported type */
-  if (*status == SAI__OK) {
-    H5O_type_t type = object_info.type;
-
-    if (type == H5O_TYPE_GROUP) {
-      havegroup = 1;
-    } else if (type == H5O_TYPE_DATASET) {
-      havegroup = 0;
     } else {
       *status = DAT__OBJIN;
-      emsRepf("datFind_1c", "datFind: Component '%s' exists but is neither group"
-              " nor dataset.", status, cleanname);
-      goto CLEANUP;
-    }
-  }
-
-  /* Create the locator */
-  thisloc = dat1AllocLoc( status );
-  if (*status != SAI__OK) goto CLEANUP;
-
-  /* Child locators are not primary by default -- just store the file_id and register  */
-  thisloc->file_id = locator1->file_id;
-  thisloc->hdsFile = locator1->hdsFile;
-  hds1RegLocator( thisloc, status );
-
-  /* Use the simplification layer to see if we have a dataset of this name */
-  if (!havegroup) {
-    /* we are finding a dataset */
-    hid_t dataset_id;
-    hid_t dataspace_id;
-
-    CALLHDFE( hid_t, dataset_id,
-            H5Dopen2( locator1->group_id, cleanname, H5P_DEFAULT),
-            DAT__OBJIN,
-            emsRepf("datFind_2", "Error opening primitive named %s", status, cleanname)
-            );
-
-    /* and data space */
-    CALLHDFE( hid_t, dataspace_id,
-            H5Dget_space( dataset_id ),
-            DAT__OBJIN,
-            emsRepf("datFind_2b", "Error retrieving data space from primitive named %s",
-                    status, cleanname)
-            );
-
-    if (*status == SAI__OK) {
-      thisloc->dataset_id = dataset_id;
-      thisloc->dataspace_id = dataspace_id;
+      dat1H5EtoEMS( status );
+      emsRepf("datFind_2", "Error opening component %s", status, cleanname);
     }
-  } else {
-    /* Try to open it as a group */
-    hid_t group_id;
-    CALLHDFE( hid_t, group_id,
-            H5Gopen2( locator1->group_id, cleanname, H5P_DEFAULT ),
-            DAT__OBJIN,
-            emsRepf("datFind_3", "Error opening component %s", status, cleanname)
-            );
-    if (*status == SAI__OK) thisloc->group_id = group_id;
-  }
-
-  /* Store a pointer to the handle for the returned HDF object */
-  thisloc->handle = dat1Handle( locator1, cleanname, 0, status );
-
-  /* We have to propagate groupness to the child */
-  if ( (locator1->grpname)[0] != '\0') hdsLink(thisloc, locator1->grpname, status);
-
-  /* Determine if the current thread has a read-only or read-write lock
-     on the parent object, referenced by the supplied locator. */
-  dat1HandleLock( locator1->handle, 1, 0, 0, &lockinfo, status );
-  rdonly = ( lockinfo == 3 );
-
-
-  /* Attempt to lock the component object for use by the current thread,
-     using the same sort of lock (read-only or read-write) as the
-     parent object. Report an error if this fails. */
-
-  dat1HandleLock( thisloc->handle, 2, 0, rdonly, &lockinfo, status );
-  if( !lockinfo && *status == SAI__OK ) {
-     *status = DAT__THREAD;
-     emsSetc( "C", name_str );
-     emsSetc( "A", rdonly ? "read-only" : "read-write" );
-     datMsg( "O", locator1 );
-     emsRep( "","datFind: requested component ('^C') within HDS object '^O' "
-             "cannot be locked for ^A access - another thread already has "
-             "a conflicting lock on the same component.", status );
+    return *status;
   }
 
-  if (*status != SAI__OK) goto CLEANUP;
-  *locator2 = thisloc;
-  return *status;
+  /* Create the locator. This takes ownership of the object and checks
+     that it is a group or a dataset. */
+  thisloc = dat1ObjectLoc( "datFind", locator1, NULL, cleanname, objid, status );
 
- CLEANUP:
-  if (thisloc) datAnnul( &thisloc, status);
+  if (*status == SAI__OK) *locator2 = thisloc;
+  HDS1_STATS_END( HDS__STAT_DATFIND, tstart, 0,
+                  (*status == SAI__OK ? thisloc->handle : locator1->handle) );
   return *status;
 }
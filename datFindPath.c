@@ -0,0 +1,358 @@
+/*
+*+
+*  Name:
+*     datFindPath
+
+*  Purpose:
+*     Find a component given a dot-separated path
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datFindPath( const HDSLoc *locator1, const char *path_str,
+*                  HDSLoc **locator2, int *status );
+
+*  Arguments:
+*     locator1 = const HDSLoc * (Given)
+*        Structure locator.
+*     path_str = const char * (Given)
+*        Path to the required object, relative to "locator1". Component
+*        names are separated by '.' and any component may be followed by
+*        a parenthesised list of cell subscripts, for example
+*        "MORE.SMURF.JCMTSTATE" or "RECORDS(3,2).DATA".
+*     locator2 = HDSLoc ** (Returned)
+*        Locator for the object at the end of the path.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Returns a locator for an object nested arbitrarily deeply below the
+*     supplied structure. The result is the same as a chain of calls to
+*     datFind (and datCell for subscripted components) but the whole path
+*     is resolved by HDF5 in one call and only the final locator is
+*     created. The Handles for the intermediate objects are still created
+*     (or reused) and locked for use by the current thread in the same way
+*     as the parent, so later access to those objects via other locators
+*     behaves exactly as if they had been located individually.
+
+*  Notes:
+*     - Subscripts must identify a single cell; ranges are not supported
+*       (use datSlice on the returned locator instead).
+*     - Subscripts on the final component may refer to either a structure
+*       array or a primitive array. Subscripts on any other component must
+*       refer to a structure array.
+*     - If any component does not exist, DAT__OBJNF is returned and the
+*       error message names the missing component.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* A single parsed component of the path */
+typedef struct {
+  char name[DAT__SZNAM+1];    /* Cleaned component name */
+  int ndim;                   /* Number of subscripts (zero if none) */
+  hdsdim subs[DAT__MXDIM];    /* Cell subscripts */
+  char cellname[128];         /* Name of the cell group (if ndim > 0) */
+} PathComp;
+
+static void dat1ParsePathComp( char *str, PathComp *comp, int *status );
+static void dat1PathLock( Handle *handle, int rdonly, const char *name,
+                          const HDSLoc *locator1, int *status );
+
+int
+datFindPath( const HDSLoc *locator1, const char *path_str,
+             HDSLoc **locator2, int *status ) {
+
+  char *pathbuf = NULL;    /* Modifiable copy of path_str */
+  char *h5path = NULL;     /* Relative HDF5 path to the final component */
+  char *start = NULL;
+  PathComp *comps = NULL;
+  PathComp *last = NULL;
+  size_t ncomp = 1;
+  size_t i;
+  Handle *parent = NULL;
+  HDSLoc *thisloc = NULL;
+  HDSLoc *cellloc = NULL;
+  hid_t objid = 0;
+  int lockinfo;
+  int rdonly;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datFindPath", 1, locator1, 1, status );
+  if (*status != SAI__OK) return *status;
+
+  /* containing locator must refer to a group */
+  if (!dat1IsStructure( locator1, status) ) {
+    if (*status == SAI__OK) {
+      *status = DAT__OBJIN;
+      emsRep("datFindPath_1", "datFindPath: Input object is not a structure",
+             status);
+    }
+    return *status;
+  }
+
+  /* Split the path into its components. Every component can contribute
+     a name and a cell name to the HDF5 path. */
+  for (i = 0; path_str[i] != '\0'; i++) {
+    if (path_str[i] == '.') ncomp++;
+  }
+  pathbuf = MEM_MALLOC( strlen(path_str) + 1 );
+  comps = MEM_CALLOC( ncomp, sizeof(*comps) );
+  h5path = MEM_MALLOC( ncomp * (DAT__SZNAM + sizeof(comps->cellname) + 2) );
+  if (!pathbuf || !comps || !h5path) {
+    *status = DAT__NOMEM;
+    emsRep("datFindPath_2", "datFindPath: Unable to allocate memory for path",
+           status );
+    goto CLEANUP;
+  }
+  strcpy( pathbuf, path_str );
+
+  start = pathbuf;
+  for (i = 0; i < ncomp; i++) {
+    char *dot = strchr( start, '.' );
+    if (dot) *dot = '\0';
+    dat1ParsePathComp( start, &(comps[i]), status );
+    if (comps[i].ndim > 0) {
+      dat1Coords2CellName( comps[i].ndim, comps[i].subs, comps[i].cellname,
+                           sizeof(comps[i].cellname), status );
+    }
+    if (*status != SAI__OK) {
+      emsRepf("datFindPath_3", "datFindPath: Invalid path '%s'", status,
+              path_str );
+      goto CLEANUP;
+    }
+    if (dot) start = dot + 1;
+  }
+  last = &(comps[ncomp-1]);
+
+  /* Form the HDF5 path. Cells of intermediate structure arrays are
+     groups in their own right. Subscripts on the final component are
+     handled by datCell below since it may be a primitive. */
+  h5path[0] = '\0';
+  for (i = 0; i < ncomp; i++) {
+    strcat( h5path, comps[i].name );
+    if (i == ncomp - 1) break;
+    if (comps[i].ndim > 0) {
+      strcat( h5path, "/" );
+      strcat( h5path, comps[i].cellname );
+    }
+    strcat( h5path, "/" );
+  }
+
+  /* Resolve the whole path in one go. Only if that fails do we walk
+     down it to find out which component was at fault. */
+  objid = H5Oopen( locator1->group_id, h5path, H5P_DEFAULT );
+  if (objid < 0) {
+    htri_t exists = 0;
+    objid = 0;
+    h5path[0] = '\0';
+    for (i = 0; i < ncomp; i++) {
+      strcat( h5path, comps[i].name );
+      exists = H5Lexists( locator1->group_id, h5path, H5P_DEFAULT );
+      if (exists == 0) {
+        *status = DAT__OBJNF;
+        emsRepf("datFindPath_4", "datFindPath: Object '%s' not found "
+                "in path '%s'", status, comps[i].name, path_str );
+      } else if (exists < 0) {
+        *status = DAT__OBJIN;
+        emsRepf("datFindPath_5", "datFindPath: Object '%s' in path '%s' "
+                "is not a structure", status,
+                (i > 0 ? comps[i-1].name : comps[i].name), path_str );
+      } else if (comps[i].ndim > 0 && i < ncomp - 1) {
+        strcat( h5path, "/" );
+        strcat( h5path, comps[i].cellname );
+        exists = H5Lexists( locator1->group_id, h5path, H5P_DEFAULT );
+        if (exists == 0) {
+          *status = DAT__SUBIN;
+          emsRepf("datFindPath_6", "datFindPath: Subscripts %s are out of "
+                  "range for object '%s' in path '%s'", status,
+                  strchr( comps[i].cellname, '(' ), comps[i].name, path_str );
+        } else if (exists < 0) {
+          *status = DAT__OBJIN;
+          emsRepf("datFindPath_7", "datFindPath: Object '%s' in path '%s' "
+                  "is not a structure array", status, comps[i].name,
+                  path_str );
+        }
+      }
+      if (*status != SAI__OK) break;
+      strcat( h5path, "/" );
+    }
+
+    /* Everything exists, so report the HDF5 error */
+    if (*status == SAI__OK) {
+      *status = DAT__OBJIN;
+      dat1H5EtoEMS( status );
+      emsRepf("datFindPath_8", "datFindPath: Error opening '%s'", status,
+              path_str );
+    }
+    goto CLEANUP;
+  }
+
+  /* Now walk down the Handle tree, creating Handles for the intermediate
+     objects as required and locking each one in the same way as its
+     parent, exactly as a chain of datFind calls would do. No locators
+     are created for these objects. */
+  parent = locator1->handle;
+  dat1ValidateHandle( "datFindPath", parent, status );
+  dat1HandleLock( parent, 1, 0, 0, &lockinfo, status );
+  rdonly = ( lockinfo == 3 );
+
+  for (i = 0; i < ncomp - 1 && *status == SAI__OK; i++) {
+    parent = dat1HandleChild( parent, comps[i].name, 0, status );
+    dat1PathLock( parent, rdonly, comps[i].name, locator1, status );
+    if (comps[i].ndim > 0) {
+      parent = dat1HandleChild( parent, comps[i].cellname, 0, status );
+      dat1PathLock( parent, rdonly, comps[i].cellname, locator1, status );
+    }
+  }
+
+  /* Create the locator for the final component. This takes ownership of
+     the object. */
+  thisloc = dat1ObjectLoc( "datFindPath", locator1, parent, last->name,
+                           objid, status );
+  objid = 0;
+
+  /* Select the cell, if required */
+  if (last->ndim > 0) {
+    datCell( thisloc, last->ndim, last->subs, &cellloc, status );
+    datAnnul( &thisloc, status );
+    thisloc = cellloc;
+  }
+
+ CLEANUP:
+  if (objid > 0) H5Oclose( objid );
+  if (pathbuf) MEM_FREE( pathbuf );
+  if (comps) MEM_FREE( comps );
+  if (h5path) MEM_FREE( h5path );
+  if (*status != SAI__OK) {
+    if (thisloc) datAnnul( &thisloc, status );
+  } else {
+    *locator2 = thisloc;
+  }
+  return *status;
+}
+
+/* Parse a single path component of the form NAME or NAME(i,j,...) */
+static void dat1ParsePathComp( char *str, PathComp *comp, int *status ) {
+  char *paren = NULL;
+  char *ptr = NULL;
+  char *endptr = NULL;
+  long sub;
+
+  if (*status != SAI__OK) return;
+
+  comp->ndim = 0;
+  paren = strchr( str, '(' );
+  if (paren) *paren = '\0';
+
+  dau1CheckName( str, 1, comp->name, sizeof(comp->name), status );
+  if (*status != SAI__OK || !paren) return;
+
+  ptr = paren + 1;
+  while (1) {
+    sub = strtol( ptr, &endptr, 10 );
+    if (endptr == ptr || sub < 1 || comp->ndim >= DAT__MXDIM) break;
+    comp->subs[comp->ndim++] = (hdsdim)sub;
+    while (isspace(*endptr)) endptr++;
+    ptr = endptr + 1;
+    if (*endptr != ',') break;
+  }
+
+  /* We must have finished at the closing parenthesis with nothing but
+     white space after it. */
+  if (*endptr == ')') {
+    while (isspace(*ptr)) ptr++;
+  }
+  if (*endptr != ')' || *ptr != '\0' || comp->ndim == 0) {
+    *status = DAT__SUBIN;
+    emsRepf("datFindPath_9", "datFindPath: Invalid subscripts for component "
+            "'%s'; a single cell must be specified using 1 to %d positive "
+            "integers", status, comp->name, DAT__MXDIM );
+  }
+}
+
+/* Lock an intermediate Handle for use by the current thread */
+static void dat1PathLock( Handle *handle, int rdonly, const char *name,
+                          const HDSLoc *locator1, int *status ) {
+  int lockinfo;
+
+  if (*status != SAI__OK) return;
+
+  dat1HandleLock( handle, 2, 0, rdonly, &lockinfo, status );
+  if( !lockinfo && *status == SAI__OK ) {
+     *status = DAT__THREAD;
+     emsSetc( "C", name );
+     emsSetc( "A", rdonly ? "read-only" : "read-write" );
+     datMsg( "O", locator1 );
+     emsRep( "","datFindPath: requested component ('^C') below HDS object "
+             "'^O' cannot be locked for ^A access - another thread already "
+             "has a conflicting lock on the same component.", status );
+  }
+}
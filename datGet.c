@@ -108,6 +108,8 @@
 #include "hds.h"
 #include "dat_err.h"
 
+#include "f77.h"
+
 int
 datGet(const HDSLoc *locator, const char *type_str, int ndim,
        const hdsdim dims[], void *values, int *status) {
@@ -119,9 +121,11 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   hdstype_t doconv = HDSTYPE_NONE;
   hdstype_t intype = HDSTYPE_NONE;
   hdstype_t outtype = HDSTYPE_NONE;
+  int convflags = 0;
   hid_t tmptype = 0;
   hid_t h5type = 0;
   hid_t mem_dataspace_id = 0;
+  hid_t dxpl = H5P_DEFAULT;
   hsize_t h5dims[DAT__MXDIM];
   int actdim;
   int defined = 0;
@@ -130,12 +134,17 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   size_t inlen;
   size_t nbin = 0;
   size_t nbout = 0;
+  size_t nbytes = 0;
   size_t nelem = 0;
   size_t outlen;
   void * tmpvalues = NULL;
+  uint64_t tstart = 0;
+  uint64_t tstage = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datGet", 1, locator, 1, status );
 
@@ -147,6 +156,9 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   isprim = dau1CheckType( 1, type_str, &h5type, normtypestr,
                           sizeof(normtypestr), status );
 
+  /* Complete any writes to the object that are still in progress */
+  if (*status == SAI__OK) hds1WriteWait( locator->handle, status );
+
   if (!isprim) {
     if (*status == SAI__OK) {
       *status = DAT__TYPIN;
@@ -190,15 +202,26 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
     goto CLEANUP;
   }
 
+  /* Use the values read by an earlier datPrefetch, if they were read
+     as the type we want */
+  if (locator->prefetch) {
+    void *pbuf = NULL;
+    size_t pbytes = 0;
+    if (hds1PrefetchTake( (HDSLoc *)locator, normtypestr, &pbuf, &pbytes )) {
+      memcpy( values, pbuf, pbytes );
+      cnfFree( pbuf );
+      goto CLEANUP;
+    }
+  }
+
  /* Check data types and do conversion if required */
   intype = dat1Type( locator, status );
   outtype = dau1HdsType( h5type, status );
 
-  if ((outtype == HDSTYPE_CHAR && intype != HDSTYPE_CHAR) ||
-      (outtype != HDSTYPE_CHAR && intype == HDSTYPE_CHAR)) {
+  convflags = dat1ConvFlags( intype, outtype );
+  if (convflags & HDS__CONV_CHAR) {
     doconv = HDSTYPE_CHAR;
-  } else if ((outtype == HDSTYPE_LOGICAL && intype != HDSTYPE_LOGICAL) ||
-             (outtype != HDSTYPE_LOGICAL && intype == HDSTYPE_LOGICAL)) {
+  } else if (convflags & HDS__CONV_LOGICAL) {
     doconv = HDSTYPE_LOGICAL;
   }
 
@@ -273,19 +296,37 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
                    status, namestr )
            );
 
-  CALLHDFQ( H5Dread( locator->dataset_id, h5type, mem_dataspace_id,
-                     locator->dataspace_id, H5P_DEFAULT,
-                     (tmpvalues ? tmpvalues : values ) ) );
+  dxpl = dat1XferProps( status );
+  HDS1_STATS_BEGIN( tstage );
+  if (!hds1ChunkIO( locator, h5type, HDS_FALSE,
+                    (tmpvalues ? tmpvalues : values ), status )) {
+    CALLHDFQ( H5Dread( locator->dataset_id, h5type, mem_dataspace_id,
+                       locator->dataspace_id, dxpl,
+                       (tmpvalues ? tmpvalues : values ) ) );
+  }
+  nbytes = H5Sget_select_npoints( mem_dataspace_id ) * H5Tget_size( h5type );
+  dat1CountIO( locator->handle, HDS__IO_READ, nbytes );
+  HDS1_STATS_END( HDS__STAT_H5DREAD, tstage, nbytes, locator->handle );
+  if (intype != outtype) {
+    hds1MetricsConvert( intype, outtype,
+                        H5Sget_select_npoints( mem_dataspace_id ) );
+  }
 
   if (tmpvalues) {
     /* Now convert from what we have read to what we need */
     size_t nbad = 0;
     if (doconv == HDSTYPE_CHAR) {
+      HDS1_STATS_BEGIN( tstage );
       dat1CvtChar( nelem, intype, nbin, outtype, nbout, tmpvalues,
                    values, &nbad, status );
+      HDS1_STATS_END( HDS__STAT_CONVERT, tstage, nelem * nbout,
+                      locator->handle );
     } else if (doconv == HDSTYPE_LOGICAL) {
+      HDS1_STATS_BEGIN( tstage );
       dat1CvtLogical( nelem, intype, nbin, outtype, nbout, tmpvalues,
                       values, &nbad, status );
+      HDS1_STATS_END( HDS__STAT_CONVERT, tstage, nelem * nbout,
+                      locator->handle );
     } else if( outtype == HDSTYPE_CHAR && intype == HDSTYPE_CHAR ) {
       memcpy( values, tmpvalues, nelem*outlen );
       /* Report an error if any non-space characters were truncated. */
@@ -322,6 +363,7 @@ datGet(const HDSLoc *locator, const char *type_str, int ndim,
   if (tmpvalues) MEM_FREE(tmpvalues);
   if (h5type) H5Tclose(h5type);
   if (mem_dataspace_id > 0) H5Sclose(mem_dataspace_id);
+  HDS1_STATS_END( HDS__STAT_DATGET, tstart, 0, locator->handle );
   return *status;
 
 }
@@ -0,0 +1,119 @@
+/*
+*+
+*  Name:
+*     datGetBatch
+
+*  Purpose:
+*     Read several primitive components of a structure in one call
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datGetBatch( const HDSLoc *locator, size_t nitem, HDSBatchItem items[],
+*                  int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Locator for the structure containing the components. If the
+*        structure is an array a single cell must have been selected.
+*     nitem = size_t (Given)
+*        Number of elements in "items".
+*     items = HDSBatchItem [] (Given and Returned)
+*        The components. For each one, "name", "type", "ndim" and "dims"
+*        are given as for datFind and datGet, and "values" must point
+*        to memory to receive the values. The "status" field is returned set to the
+*        status of that component.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Equivalent to calling datFind, datGet and datAnnul for each
+*     component in turn, but much faster when there are many small
+*     components, since the structure locator is only validated once,
+*     no locators are created for the components and the memory data
+*     types are only constructed once for each distinct type string.
+
+*  Notes:
+*     - Every component is attempted even if some fail. If any fail,
+*       "status" is returned set to the status of the first failure and
+*       the "status" field of each item shows which ones failed.
+*     - See also datPutBatch.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+datGetBatch( const HDSLoc *locator, size_t nitem, HDSBatchItem items[],
+             int *status ) {
+  uint64_t tstart = 0;
+
+  if (*status != SAI__OK) return *status;
+
+  HDS1_STATS_BEGIN( tstart );
+
+  dat1BatchIO( "datGetBatch", locator, HDS_FALSE, nitem, items, status );
+
+  HDS1_STATS_END( HDS__STAT_DATGETBATCH, tstart, 0, locator->handle );
+  return *status;
+}
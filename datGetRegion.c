@@ -0,0 +1,303 @@
+/*
+*+
+*  Name:
+*     datGetRegion
+
+*  Purpose:
+*     Read primitive(s) into a region of a larger array
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datGetRegion( const HDSLoc *locator, const char *type_str, int ndim,
+*                   const hdsdim dims[], const hdsdim bufdims[],
+*                   const hdsdim lower[], void *values, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Primitive locator. This will often be a slice.
+*     type_str = const char * (Given)
+*        Data type of the array in memory.
+*     ndim = int (Given)
+*        Number of dimensions of the object and of the array in memory.
+*     dims = const hdsdim [] (Given)
+*        Dimensions of the object. Must match the shape of the locator.
+*     bufdims = const hdsdim [] (Given)
+*        Dimensions of the array in memory.
+*     lower = const hdsdim [] (Given)
+*        Pixel indices in the memory array, starting at 1, at which the
+*        first element of the object is to be stored.
+*     values = void * (Returned)
+*        Array of shape "bufdims" to receive the data. Only the region of
+*        shape "dims" starting at "lower" is written. The rest of the array
+*        is left unchanged.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Reads the values of a primitive object into a rectangular region of
+*     a larger array in memory, converting them to the requested type as
+*     datGet does. When HDF5 can perform the type conversion, the values are
+*     transferred straight into the caller's array with a memory
+*     hyperslab. No intermediate copy is made. This is useful, for example,
+*     when assembling a mosaic from a number of tiles.
+
+*  Notes:
+*     - Conversions to or from _CHAR or _LOGICAL are carried out by HDS
+*       itself. They are read into temporary memory and then copied into
+*       the region.
+*     - A scalar object (ndim = 0) is read into the first element of
+*       "values".
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+datGetRegion( const HDSLoc *locator, const char *type_str, int ndim,
+              const hdsdim dims[], const hdsdim bufdims[],
+              const hdsdim lower[], void *values, int *status ) {
+
+  char normtypestr[DAT__SZTYP+1];
+  hdsdim locdims[DAT__MXDIM];
+  hsize_t h5bufdims[DAT__MXDIM];
+  hsize_t h5start[DAT__MXDIM];
+  hsize_t h5count[DAT__MXDIM];
+  hdsbool_t defined = HDS_FALSE;
+  hdstype_t intype = HDSTYPE_NONE;
+  hdstype_t outtype = HDSTYPE_NONE;
+  hid_t h5type = 0;
+  hid_t filetype = 0;
+  hid_t mem_dataspace_id = 0;
+  hid_t dxpl = H5P_DEFAULT;
+  void *tmpvalues = NULL;
+  int convflags = 0;
+  int actdim = 0;
+  int direct = 0;
+  int isprim;
+  int i;
+  size_t nbytes = 0;
+  uint64_t tstart = 0;
+  uint64_t tstage = 0;
+
+  if (*status != SAI__OK) return *status;
+
+  HDS1_STATS_BEGIN( tstart );
+
+  /* A scalar has nowhere else to go */
+  if (ndim == 0) return datGet( locator, type_str, 0, dims, values, status );
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datGetRegion", 1, locator, 1, status );
+
+  /* Complete any writes to the object that are still in progress */
+  if (*status == SAI__OK) hds1WriteWait( locator->handle, status );
+  if (*status != SAI__OK) return *status;
+
+  if (locator->dataset_id <= 0) {
+    *status = DAT__OBJIN;
+    emsRep("datGetRegion_1", "datGetRegion: Can only read from a primitive",
+           status );
+    return *status;
+  }
+
+  isprim = dau1CheckType( 1, type_str, &h5type, normtypestr,
+                          sizeof(normtypestr), status );
+  if (!isprim) {
+    if (*status == SAI__OK) {
+      *status = DAT__TYPIN;
+      emsRepf("datGetRegion_2", "datGetRegion: Data type must be a primitive "
+              "type and not '%s'", status, normtypestr);
+    }
+    goto CLEANUP;
+  }
+
+  /* The object must have the shape we were told, and fit in the buffer */
+  datShape( locator, DAT__MXDIM, locdims, &actdim, status );
+  if (*status != SAI__OK) goto CLEANUP;
+  if (ndim != actdim) {
+    *status = DAT__DIMIN;
+    emsRepf("datGetRegion_3", "datGetRegion: Supplied no. of axes (%d) is "
+            "incorrect - it should be %d.", status, ndim, actdim );
+    goto CLEANUP;
+  }
+  for (i = 0; i < ndim; i++) {
+    if (locdims[i] != dims[i]) {
+      *status = DAT__DIMIN;
+      emsRepf("datGetRegion_4", "datGetRegion: Supplied dimension (%"
+              HDS_DIM_FORMAT ") on axis %d is incorrect - it should be %"
+              HDS_DIM_FORMAT ".", status, dims[i], i+1, locdims[i] );
+      goto CLEANUP;
+    }
+    if (lower[i] < 1 || lower[i] - 1 + dims[i] > bufdims[i]) {
+      *status = DAT__BOUND;
+      emsRepf("datGetRegion_5", "datGetRegion: Region %" HDS_DIM_FORMAT
+              ":%" HDS_DIM_FORMAT " on axis %d lies outside the array "
+              "dimension %" HDS_DIM_FORMAT, status, lower[i],
+              lower[i] - 1 + dims[i], i+1, bufdims[i] );
+      goto CLEANUP;
+    }
+  }
+
+  datState( locator, &defined, status );
+  if (!defined && *status == SAI__OK) {
+    *status = DAT__UNSET;
+    emsRep("datGetRegion_6", "datGetRegion: Primitive object is undefined. "
+           "Nothing to get.", status );
+    goto CLEANUP;
+  }
+
+  /* HDF5 can only deliver straight into the buffer if it can do any
+     conversion itself. That excludes strings of a different length,
+     since datGet must check for truncation. */
+  intype = dat1Type( locator, status );
+  outtype = dau1HdsType( h5type, status );
+  convflags = dat1ConvFlags( intype, outtype );
+  direct = !(convflags & (HDS__CONV_CHAR|HDS__CONV_LOGICAL));
+  if (direct && outtype == HDSTYPE_CHAR) {
+    CALLHDFE( hid_t, filetype,
+              H5Dget_type( locator->dataset_id ),
+              DAT__HDF5E,
+              emsRep("datGetRegion_7", "datGetRegion: Error obtaining data "
+                     "type of dataset", status)
+              );
+    if (H5Tget_size( filetype ) != H5Tget_size( h5type )) direct = 0;
+  }
+
+  if (direct) {
+
+    /* Select the region of the in-memory array. HDF5 wants the
+       dimensions in the opposite order. */
+    dat1ImportDims( "datGetRegion", ndim, bufdims, h5bufdims, status );
+    dat1ImportDims( "datGetRegion", ndim, dims, h5count, status );
+    for (i = 0; i < ndim; i++) h5start[ndim - 1 - i] = lower[i] - 1;
+    if (*status != SAI__OK) goto CLEANUP;
+
+    CALLHDFE( hid_t, mem_dataspace_id,
+              H5Screate_simple( ndim, h5bufdims, NULL ),
+              DAT__HDF5E,
+              emsRep("datGetRegion_8", "datGetRegion: Error allocating "
+                     "in-memory dataspace", status )
+              );
+    CALLHDFQ( H5Sselect_hyperslab( mem_dataspace_id, H5S_SELECT_SET,
+                                   h5start, NULL, h5count, NULL ) );
+    dxpl = dat1XferProps( status );
+    HDS1_STATS_BEGIN( tstage );
+    CALLHDFQ( H5Dread( locator->dataset_id, h5type, mem_dataspace_id,
+                       locator->dataspace_id, dxpl, values ) );
+    nbytes = H5Sget_select_npoints( locator->dataspace_id ) *
+      H5Tget_size( h5type );
+    dat1CountIO( locator->handle, HDS__IO_READ, nbytes );
+    HDS1_STATS_END( HDS__STAT_H5DREAD, tstage, nbytes, locator->handle );
+    if (intype != outtype) {
+      hds1MetricsConvert( intype, outtype,
+                          H5Sget_select_npoints( locator->dataspace_id ) );
+    }
+
+  } else {
+
+    /* Let datGet do the conversion and then copy each row into place */
+    size_t nbel = H5Tget_size( h5type );
+    size_t nelem = 1;
+    size_t rowbytes = nbel * dims[0];
+    hdsdim pos[DAT__MXDIM];
+    const char *src;
+
+    for (i = 0; i < ndim; i++) nelem *= dims[i];
+    tmpvalues = MEM_MALLOC( nelem * nbel );
+    if (!tmpvalues) {
+      *status = DAT__NOMEM;
+      emsRepf("datGetRegion_9", "datGetRegion: Unable to allocate %zu bytes",
+              status, nelem * nbel );
+      goto CLEANUP;
+    }
+    datGet( locator, type_str, ndim, dims, tmpvalues, status );
+    if (*status != SAI__OK) goto CLEANUP;
+
+    for (i = 0; i < ndim; i++) pos[i] = 0;
+    for (src = tmpvalues; src < (char *)tmpvalues + nelem * nbel;
+         src += rowbytes) {
+      size_t off = 0;
+      for (i = ndim - 1; i >= 0; i--) {
+        off = off * bufdims[i] + (lower[i] - 1 + pos[i]);
+      }
+      memcpy( (char *)values + off * nbel, src, rowbytes );
+
+      /* Move on to the next row */
+      for (i = 1; i < ndim; i++) {
+        if (++pos[i] < dims[i]) break;
+        pos[i] = 0;
+      }
+    }
+  }
+
+ CLEANUP:
+  if (tmpvalues) MEM_FREE( tmpvalues );
+  if (filetype > 0) H5Tclose( filetype );
+  if (h5type > 0) H5Tclose( h5type );
+  if (mem_dataspace_id > 0) H5Sclose( mem_dataspace_id );
+  HDS1_STATS_END( HDS__STAT_DATGETREGION, tstart, 0, locator->handle );
+  return *status;
+}
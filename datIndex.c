@@ -101,10 +101,13 @@ datIndex(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status ) {
   char groupnam[DAT__SZNAM+1];
   ssize_t lenstr = 0;
   int ncomp = 0;
+  uint64_t tstart = 0;
   *locator2 = NULL;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datIndex", 1, locator1, 1, status );
 
@@ -137,5 +140,7 @@ datIndex(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status ) {
   datFind( locator1, namestr, locator2, status );
 
  CLEANUP:
+  HDS1_STATS_END( HDS__STAT_DATINDEX, tstart, 0,
+                  (*status == SAI__OK ? (*locator2)->handle : locator1->handle) );
   return *status;
 }
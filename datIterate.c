@@ -0,0 +1,235 @@
+/*
+*+
+*  Name:
+*     datIterate
+
+*  Purpose:
+*     Iterate over all the components of a structure
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datIterate( const HDSLoc *locator, hdsbool_t opencomp, datIterFunc func,
+*                 void *data, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Structure locator.
+*     opencomp = hdsbool_t (Given)
+*        If true, a locator for each component is created and passed to
+*        "func". Otherwise NULL is passed and no component is opened
+*        beyond what is needed to determine its type.
+*     func = datIterFunc (Given)
+*        Function to call for each component. See the Notes.
+*     data = void * (Given)
+*        Arbitrary pointer that is passed unchanged to "func".
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Calls the supplied function once for every component of a structure,
+*     passing the name of the component, whether it is a structure and its
+*     HDS type. The components are visited in the same order as datIndex
+*     uses, but the structure is traversed in a single pass. This is much
+*     faster than calling datNcomp followed by datIndex and datFind for
+*     each component, which requires the group links to be searched again
+*     for each component.
+
+*  Notes:
+*     - The function has the prototype:
+*
+*       int func( const HDSLoc *locator, const char *name, hdsbool_t isstruc,
+*                 const char *type_str, HDSLoc *comploc, void *data,
+*                 int *status );
+*
+*       where "locator" is the supplied structure locator, "name" is the
+*       name of the component, "isstruc" is true if the component is a
+*       structure, "type_str" is its HDS type and "comploc" is a locator for
+*       the component (NULL if "opencomp" is false). The function should
+*       return zero to continue the iteration and non-zero to stop it.
+*     - The "comploc" locator is annulled by datIterate once the function
+*       returns. Use datClone if it is required afterwards.
+*     - Iteration stops if the function returns with "status" set.
+*     - Components must not be created, erased or renamed within the
+*       structure while it is being iterated over.
+*     - If the structure is an array, the locator must be explicitly
+*       associated with an individual cell.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+/* Context passed through H5Literate to the per-link callback */
+typedef struct {
+  const HDSLoc *locator;
+  hdsbool_t opencomp;
+  datIterFunc func;
+  void *data;
+  int *status;
+} IterContext;
+
+static herr_t dat1IterateLink( hid_t group_id, const char *name,
+                               const H5L_info_t *info, void *op_data );
+
+int
+datIterate( const HDSLoc *locator, hdsbool_t opencomp, datIterFunc func,
+            void *data, int *status ) {
+
+  IterContext ctx;
+  hdsdim dims[DAT__MXDIM];
+  herr_t iterstat;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datIterate", 1, locator, 1, status );
+  if (*status != SAI__OK) return *status;
+
+  if (!dat1IsStructure( locator, status)) {
+    *status = DAT__OBJIN;
+    emsRep("datIterate_1", "datIterate: Input object is not a structure",
+           status);
+    return *status;
+  }
+
+  if (dat1GetStructureDims( locator, DAT__MXDIM, dims, status ) > 0) {
+    if (*status == SAI__OK) {
+      *status = DAT__OBJIN;
+      emsRep("datIterate_2", "datIterate: Input object is an array of "
+             "structures. Use datCell to select a single element.", status);
+    }
+    return *status;
+  }
+
+  ctx.locator = locator;
+  ctx.opencomp = opencomp;
+  ctx.func = func;
+  ctx.data = data;
+  ctx.status = status;
+
+  iterstat = H5Literate( locator->group_id, H5_INDEX_NAME, H5_ITER_INC, NULL,
+                         dat1IterateLink, &ctx );
+
+  if (iterstat < 0 && *status == SAI__OK) {
+    *status = DAT__HDF5E;
+    dat1H5EtoEMS( status );
+    emsRep("datIterate_3", "datIterate: Error iterating over the components "
+           "of a structure", status );
+  }
+
+  return *status;
+}
+
+/* Called by H5Literate for each link in the group. Returns zero to
+   continue, positive to stop early and negative on error. */
+static herr_t dat1IterateLink( hid_t group_id, const char *name,
+                               const H5L_info_t *info, void *op_data ) {
+  IterContext *ctx = op_data;
+  int *status = ctx->status;
+  HDSLoc *comploc = NULL;
+  char type_str[DAT__SZTYP+1];
+  hdstype_t hdstyp;
+  hid_t objid = 0;
+  int stop = 0;
+
+  if (*status != SAI__OK) return 1;
+
+  /* Opening the object is the cheapest way to find out both its
+     HDF5 object type and its HDS type. */
+  CALLHDFE( hid_t, objid,
+            H5Oopen( group_id, name, H5P_DEFAULT ),
+            DAT__OBJIN,
+            emsRepf("datIterate_4", "datIterate: Error opening component %s",
+                    status, name )
+            );
+
+  /* Skip anything that is not a group or dataset (e.g. named types). */
+  if (H5Iget_type( objid ) != H5I_GROUP &&
+      H5Iget_type( objid ) != H5I_DATASET) {
+    H5Oclose( objid );
+    return 0;
+  }
+
+  hdstyp = dat1TypeStr( objid, type_str, status );
+
+  /* Hand the object to a new locator if required, otherwise close it */
+  if (ctx->opencomp) {
+    comploc = dat1ObjectLoc( "datIterate", ctx->locator, NULL, name, objid, status );
+  } else {
+    H5Oclose( objid );
+  }
+  objid = 0;
+
+  if (*status == SAI__OK) {
+    stop = (ctx->func)( ctx->locator, name, (hdstyp == HDSTYPE_STRUCTURE),
+                        type_str, comploc, ctx->data, status );
+  }
+  if (comploc) datAnnul( &comploc, status );
+
+  if (*status != SAI__OK) return 1;
+  return (stop ? 1 : 0);
+
+ CLEANUP:
+  if (objid > 0) H5Oclose( objid );
+  return 1;
+}
@@ -54,6 +54,8 @@
 *       written to the HDF5 file on datUnmap() or datAnnul().
 *     - The resultant pointer can be used from both C and Fortran
 *       using CNF.
+*     - The kernel is given a hint about how the data will be accessed
+*       when they are read. See datMapAdvise.
 
 *  History:
 *     2014-08-29 (TIMJ):
@@ -128,9 +130,6 @@
 
 #include "f77.h"
 
-static void *
-dat1Mmap( size_t nbytes, int prot, int flags, int fd, off_t offset, int *isreg, void **pntr, size_t * actbytes, int * status );
-
 int
 datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
        const hdsdim dims[], void **pntr, int *status) {
@@ -147,9 +146,14 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   hdsbool_t try_mmap = HDS_FALSE;
   unsigned intent = 0;
   size_t actbytes = 0;
+  size_t hugebytes = 0;
+  hdsbool_t ishuge = HDS_FALSE;
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* First have to validate the access mode */
   switch (mode_str[0]) {
   case 'R':
@@ -174,6 +178,9 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   /* Validate input locator. */
   dat1ValidateLocator( "datMap", 1, locator, (accmode & HDSMODE_READ), status );
 
+  /* Complete any writes to the object that are still in progress */
+  if (*status == SAI__OK) hds1WriteWait( locator->handle, status );
+
   /* Get the HDF5 type code and confirm this is a primitive type */
   isprim = dau1CheckType( 1, type_str, &h5type, normtypestr,
                           sizeof(normtypestr), status );
@@ -290,10 +297,13 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
      the data and the file itself was opened readonly. I'm not sure what happens
      if other components are removed or added -- will the offset change? Maybe we just try */
   offset = H5Dget_offset( locator->dataset_id );
-  if (offset != HADDR_UNDEF) {
+  if (offset != HADDR_UNDEF &&
+      (dat1ConvFlags( dat1Type( locator, status ), dau1HdsType( h5type, status ) )
+       & HDS__CONV_IDENTITY)) {
     hid_t dataset_h5type = 0;
-    /* In theory we can do a memory map so now compare
-       the data types of the request and the low-level dataset. */
+    /* In theory we can do a memory map so now compare the data types
+       of the request and the low-level dataset. This also checks the
+       byte order and, for _CHAR, the string length. */
     CALLHDFE( hid_t, dataset_h5type,
              H5Dget_type( locator->dataset_id ),
              DAT__HDF5E,
@@ -315,8 +325,9 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
      For now only allow mmap for files opened read only */
   if (intent != H5F_ACC_RDONLY) try_mmap = 0;
 
-  /* If mmap has been disabled by tuning the environment we just force it off here. */
-  if (!hds1GetUseMmap()) try_mmap = 0;
+  /* If mmap has been disabled by tuning the environment, for all files or
+     for this one, we just force it off here. */
+  if (!hds1TuneObject( locator->file_id, "MAP", hds1GetUseMmap() )) try_mmap = 0;
 
 #if DEBUG_HDS
   {
@@ -340,81 +351,42 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   }
 #endif
 
-  if (try_mmap) {
-    int fd = 0;
-    int flags = 0;
-    int prot = 0;
-    hdsbool_t opened_fd = 0;
-
-    if ( intent == H5F_ACC_RDONLY || accmode == HDSMODE_READ ) {
-      flags |= O_RDONLY;
-      prot = PROT_READ;
+  /* Values already read by datPrefetch take the place of a mapping. They
+     are useless if the data are to be overwritten. */
+  if (locator->prefetch) {
+    size_t pbytes = 0;
+    if (accmode != HDSMODE_WRITE &&
+        hds1PrefetchTake( locator, normtypestr, &regpntr, &pbytes )) {
+      try_mmap = HDS_FALSE;
     } else {
-      flags |= O_RDWR;
-      prot = PROT_READ | PROT_WRITE;
+      hds1PrefetchDiscard( locator );
     }
+  }
 
-    if (*status == SAI__OK) {
-      /* see what file driver we have */
-      hid_t fapl_id = -1;
-      hid_t fdriv_id = -1;
-      void * file_handle = NULL;
-      herr_t herr = -1;
-      fapl_id = H5Fget_access_plist(locator->file_id);
-      fdriv_id = H5Pget_driver(fapl_id);
-      if (fdriv_id == H5FD_SEC2 || fdriv_id == H5FD_STDIO) {
-        /* If this is a POSIX or STDIO driver we get the handle */
-        herr = H5Fget_vfd_handle( locator->file_id, fapl_id, (void**)&file_handle);
-        if (herr >= 0) {
-          if (fdriv_id == H5FD_SEC2) {
-            fd = *((int *)file_handle);
-          } else if (fdriv_id == H5FD_STDIO) {
-            FILE * fh = (FILE *)file_handle;
-            fd = fileno(fh);
-          }
-        }
-      }
-      if (fapl_id > 0) H5Pclose( fapl_id );
-
-      if (fd == 0) {
-        /* We have to open the file ourselves! */
-        char * fname = NULL;
-        fname = dat1GetFullName( locator->dataset_id, 1, NULL, status );
-        fd = open(fname, flags);
-        opened_fd = 1;
-        if (fname) MEM_FREE(fname);
-      }
-      if (fd > 0) {
-        /* Set up for memory mapping */
-        int mflags = 0;
-        mflags = MAP_SHARED | MAP_FILE;
-        if (*status == SAI__OK) {
-          mapped = dat1Mmap( nbytes, prot, mflags, fd, offset, &isreg, &regpntr, &actbytes, status );
-          if (*status == SAI__OK) {
-            /* Store the file descriptor in the locator to allow us to close */
-            if (mapped) {
-              if (opened_fd) locator->fdmap = fd;
-              locator->uses_true_mmap = 1;
-            }
-          } else {
-            /* Not currently fatal -- we can try without the file */
-            if (opened_fd) close(fd);
-            emsAnnul(status);
-          }
-        }
-      }
-    }
+  if (try_mmap) {
+    mapped = dat1MmapDataset( locator, accmode, intent, offset, nbytes,
+                              &isreg, &regpntr, &actbytes, status );
+    if (mapped) dat1Advise( locator, mapped, actbytes, offset, nbytes, status );
   }
 
   /* If we have not been able to map anything yet, just get some memory. It is
      zeroed (for WRITE) to match mmap behavior. We rely on the OS to decide when it is reasonable
-     to do an anonymous mmap. */
+     to do an anonymous mmap, except for large buffers that have been tuned
+     to use huge pages (which are always zeroed). */
 
   if (!regpntr) {
     hdsbool_t mustget;
     mustget = (accmode == HDSMODE_READ || accmode == HDSMODE_UPDATE);
 
-    if (mustget) {
+    hugebytes = (size_t)hds1GetHugePage() * 1024 * 1024;
+    if (hugebytes > 0 && nbytes >= hugebytes) {
+      regpntr = hds1HugeAlloc( nbytes, &actbytes );
+      if (regpntr) ishuge = HDS_TRUE;
+    }
+
+    if (regpntr) {
+      /* Already allocated */
+    } else if (mustget) {
       regpntr = cnfMalloc( nbytes );
     } else {
       regpntr = cnfCalloc( 1, nbytes );
@@ -428,6 +400,7 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
 
     /* Populate the memory - check with datState occurred earlier */
     if (mustget) {
+      if (!locator->isslice) dat1Advise( locator, NULL, 0, offset, nbytes, status );
       datGet( locator, normtypestr, ndim, dims, regpntr, status );
     }
   }
@@ -440,11 +413,13 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
   if (*status != SAI__OK) {
     if (mapped) {
       if (isreg == 1) cnfUregp( regpntr );
-      if ( munmap( mapped, actbytes ) != 0 ) {
+      if ( hds1Munmap( mapped, actbytes ) != 0 ) {
         emsSyser( "MESSAGE", errno );
         emsRep("datMap_4", "Error unmapping mapped memory: ^MESSAGE", status);
       }
       mapped = NULL;
+    } else if (ishuge) {
+      hds1HugeFree( regpntr, actbytes );
     } else if (regpntr) {
       cnfFree( regpntr );
     }
@@ -458,6 +433,10 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
     locator->regpntr = regpntr;
     locator->bytesmapped = actbytes;
     locator->accmode = accmode;
+    locator->ishuge = ishuge;
+    locator->datasize = nbytes;
+    dat1CountIO( locator->handle, (mapped ? HDS__IO_MMAP : HDS__IO_COPYMAP),
+                 nbytes );
 
     /* In order to copy the data back into the underlying HDF5 dataset
        we need to store additional information about how this was mapped
@@ -475,86 +454,6 @@ datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim,
      mapped pointer because of pagesize corrections */
   *pntr = regpntr;
 
+  HDS1_STATS_END( HDS__STAT_DATMAP, tstart, nbytes, locator->handle );
   return *status;
 }
-
-
-static void *
-dat1Mmap( size_t nbytes, int prot, int flags, int fd, off_t offset, int *isreg, void **pntr, size_t *actbytes, int * status ) {
-  void * mapped = NULL;
-  int tries = 0;
-  size_t pagesize = 0;
-  void * where = NULL;
-  off_t off = 0;
-  *pntr = NULL;
-  *isreg = 0;
-
-  if (*status != SAI__OK) return NULL;
-
-  /* We need to know the pagesize */
-  pagesize = sysconf( _SC_PAGESIZE );
-
-  *actbytes = nbytes;
-  if (offset > 0) {
-    /* Calculate the starting offset into the file and round this down to a     */
-    /* multiple of the system page size. Calculate the number of bytes to map,  */
-    /* allowing for this rounding.                                              */
-    off = offset - ( offset % pagesize );
-    *actbytes += ( offset - off );
-  }
-
-  while (!mapped) {
-    *isreg = 0;
-    tries++;
-    if (*status != SAI__OK) goto CLEANUP;
-
-    /* Get some anonymous memory - we always have to map read/write
-       because we always have to copy data into this space. */
-    //printf("mmap(%p, %zu, %d, %d, %d, %zu -> %zu [%d])\n", where, *actbytes, prot, flags, fd, offset, off, pagesize);
-    mapped = mmap( where, *actbytes, prot, flags, fd, off );
-    if (mapped == MAP_FAILED) {
-      emsSyser( "MESSAGE", errno );
-      *status = DAT__FILMP;
-      emsRep("datMap_2", "Error mapping some memory: ^MESSAGE", status );
-      mapped = NULL;
-      *pntr = NULL;
-      goto CLEANUP;
-    }
-    /* The pointer we register is the one that has been corrected
-       for the shift we applied in the original request */
-    *pntr = mapped + (offset - off );
-
-    /* Must register with CNF so the pointer can be used by Fortran */
-    *isreg = cnfRegp( *pntr );
-    if (*isreg == -1) {
-      /* Serious internal error */
-      *status = DAT__FILMP;
-      emsRep("datMap_3", "Error registering a pointer for mapped data "
-             " - internal CNF error", status );
-      goto CLEANUP;
-    } else if (*isreg == 0) {
-      /* Free the memory and try again */
-      if ( munmap( mapped, *actbytes ) != 0 ) {
-        *status = DAT__FILMP;
-        emsSyser( "MESSAGE", errno );
-        emsRep("datMap_4", "Error unmapping mapped memory following"
-               " failed registration: ^MESSAGE", status);
-        goto CLEANUP;
-      }
-      if (!where) where = mapped;
-      where += pagesize;
-      mapped = NULL;
-      *pntr = NULL;
-    }
-
-    if (!mapped && tries > 100) {
-      *status = DAT__FILMP;
-      emsRepf("datMap_4b", "Failed to register mapped memory with CNF"
-             " after %d attempts", status, tries );
-      goto CLEANUP;
-    }
-
-  }
- CLEANUP:
-  return mapped;
-}
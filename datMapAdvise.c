@@ -0,0 +1,150 @@
+/*
+*+
+*  Name:
+*     datMapAdvise
+
+*  Purpose:
+*     Specify how mapped primitive data will be accessed
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datMapAdvise( HDSLoc *locator, const char *pattern_str, int *status );
+
+*  Arguments:
+*     locator = HDSLoc * (Given and Returned)
+*        Primitive locator.
+*     pattern_str = const char * (Given)
+*        Expected access pattern. One of "DEFAULT", "NORMAL", "SEQUENTIAL",
+*        "RANDOM", "WILLNEED" or "HUGEPAGE" (case insensitive, and may be
+*        abbreviated to four characters).
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Records the expected pattern of access to the data for subsequent
+*     calls to datMap on this locator. When the data are memory mapped
+*     directly from the file the pattern is passed to the kernel using
+*     madvise(). Otherwise it is passed to posix_fadvise() for the part of
+*     the file that datMap reads. If the primitive is already mapped the
+*     hint is applied to the existing mapping immediately.
+
+*  Notes:
+*     - "DEFAULT" chooses a pattern from the size of the data: WILLNEED
+*       for small arrays and SEQUENTIAL for large ones. This is the pattern
+*       used if datMapAdvise is never called.
+*     - "HUGEPAGE" only affects data that are memory mapped from the file.
+*     - The hints are advisory and have no effect on the values obtained.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <strings.h>
+
+#include "hdf5.h"
+
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+int
+datMapAdvise( HDSLoc *locator, const char *pattern_str, int *status ) {
+  hds_advice_t advice = HDS__ADV_DEFAULT;
+
+  if (*status != SAI__OK) return *status;
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datMapAdvise", 1, locator, 1, status );
+  if (*status != SAI__OK) return *status;
+
+  if (!locator->dataset_id) {
+    *status = DAT__OBJIN;
+    emsRep("datMapAdvise_1", "datMapAdvise: Object is not a primitive",
+           status);
+    return *status;
+  }
+
+  if (strncasecmp( pattern_str, "DEFA", 4 ) == 0) {
+    advice = HDS__ADV_DEFAULT;
+  } else if (strncasecmp( pattern_str, "NORM", 4 ) == 0) {
+    advice = HDS__ADV_NORMAL;
+  } else if (strncasecmp( pattern_str, "SEQU", 4 ) == 0) {
+    advice = HDS__ADV_SEQUENTIAL;
+  } else if (strncasecmp( pattern_str, "RAND", 4 ) == 0) {
+    advice = HDS__ADV_RANDOM;
+  } else if (strncasecmp( pattern_str, "WILL", 4 ) == 0) {
+    advice = HDS__ADV_WILLNEED;
+  } else if (strncasecmp( pattern_str, "HUGE", 4 ) == 0) {
+    advice = HDS__ADV_HUGEPAGE;
+  } else {
+    *status = DAT__MODIN;
+    emsRepf("datMapAdvise_2", "datMapAdvise: Unrecognized access pattern '%s'",
+            status, pattern_str );
+    return *status;
+  }
+
+  locator->advice = advice;
+
+  /* Apply it straight away to an existing mapping of the file */
+  if (locator->uses_true_mmap && locator->pntr) {
+    dat1Advise( locator, locator->pntr, locator->bytesmapped, HADDR_UNDEF,
+                locator->bytesmapped, status );
+  }
+
+  return *status;
+}
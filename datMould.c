@@ -26,16 +26,25 @@
 *        Pointer to global status.
 
 *  Description:
-*     Alter an object's shape permanently.
+*     Alter an object's shape permanently. The number of elements must
+*     not change. For a structure array only the metadata are changed:
+*     the cells are renamed to match their new coordinates. HDF5 can not
+*     change the rank of an existing dataset, so a primitive is recreated
+*     with the new shape, copying the stored bytes without conversion.
 
 *  Authors:
 *     TIMJ: Tim Jenness (Cornell)
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Not Yet Implemented.
 *     - The shape is altered permanently (unlike datCoerc).
 *       The number of dimensions cannot be increased.
+*     - A structure can not be changed between a scalar and an array.
+*     - If an error occurs while the cells of a structure array are
+*       being renamed, any already renamed are given their old names
+*       back, leaving the original shape.
+*     - Can not be called on a vectorized locator, a slice or a mapped
+*       primitive.
 
 *  History:
 *     2014-10-16 (TIMJ):
@@ -83,10 +92,14 @@
 *-
 */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "hdf5.h"
 
 #include "ems.h"
 #include "sae_par.h"
+#include "star/one.h"
 
 #include "hds1.h"
 #include "dat1.h"
@@ -94,17 +107,223 @@
 
 #include "dat_err.h"
 
+static size_t dat1CellIndex( const char *cellname, int ndim,
+                             const hdsdim dims[] );
+static void dat1MouldUndo( hid_t group_id, int curndim, const hdsdim curdims[],
+                           int ndim, const hdsdim dims[], size_t nout,
+                           size_t nin );
+
 int
 datMould( HDSLoc *locator, int ndim, const hdsdim dims[], int *status ) {
 
+  hdsdim curdims[DAT__MXDIM];
+  int curndim = 0;
+  size_t curcount = 1;
+  size_t newcount = 1;
+  size_t nout = 0;
+  size_t nin = 0;
+  hdsbool_t same;
+  int i;
+
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
   dat1ValidateLocator( "datMould", 1, locator, 0, status );
+  if (*status != SAI__OK) return *status;
+
+  if (locator->vectorized) {
+    *status = DAT__OBJIN;
+    emsRep("datMould_1", "datMould: Can not mould a vectorized object",
+           status);
+    return *status;
+  }
+
+  if (locator->regpntr) {
+    *status = DAT__OBJIN;
+    emsRep("datMould_2", "datMould: Can not mould a mapped primitive",
+           status);
+    return *status;
+  }
+
+  if (locator->isslice) {
+    *status = DAT__OBJIN;
+    emsRep("datMould_3", "datMould: Can not mould a slice",
+           status);
+    return *status;
+  }
+
+  /* Get the current dimensions and validate the new ones */
+  datShape( locator, DAT__MXDIM, curdims, &curndim, status );
+  if (*status != SAI__OK) return *status;
+
+  if (ndim < 0 || ndim > curndim) {
+    *status = DAT__DIMIN;
+    emsRepf("datMould_4", "datMould: Can not change the number of dimensions "
+            "from %d to %d", status, curndim, ndim );
+    return *status;
+  }
+
+  same = (ndim == curndim);
+  for (i = 0; i < curndim; i++) curcount *= curdims[i];
+  for (i = 0; i < ndim; i++) {
+    if (dims[i] < 1) {
+      *status = DAT__DIMIN;
+      emsRepf("datMould_5", "datMould: Dimension %d (1-based) is invalid "
+              "(%" HDS_DIM_FORMAT ")", status, i+1, dims[i] );
+      return *status;
+    }
+    newcount *= dims[i];
+    if (same && dims[i] != curdims[i]) same = HDS_FALSE;
+  }
+
+  if (newcount != curcount) {
+    *status = DAT__DIMIN;
+    emsRepf("datMould_6", "datMould: New shape has %zu elements but the "
+            "object has %zu", status, newcount, curcount );
+    return *status;
+  }
+
+  /* Nothing to do if the shape is unchanged */
+  if (same) return *status;
+
+  if ( dat1IsStructure( locator, status ) ) {
+    char oldname[128];
+    char tmpname[128];
+    char newname[128];
+    hdsdim coords[DAT__MXDIM];
+    Handle *handle;
+    size_t n;
+
+    if (curndim == 0 || ndim == 0) {
+      if (*status == SAI__OK) {
+        *status = DAT__DIMIN;
+        emsRep("datMould_7", "datMould: Can not change a structure between "
+               "a scalar and an array", status );
+      }
+      goto CLEANUP;
+    }
 
-  *status = DAT__FATAL;
-  emsRep("datMould", "datMould: Not yet implemented for HDF5",
-         status);
+    /* Each cell is a group named after its coordinates, so moulding a
+       structure array is just a matter of renaming the cells. Move them
+       all out of the way first since old and new names can clash. */
+    for (n = 1; n <= curcount; n++) {
+      dat1Index2Coords( n, curndim, curdims, coords, status );
+      dat1Coords2CellName( curndim, coords, oldname, sizeof(oldname), status );
+      one_snprintf( tmpname, sizeof(tmpname), "+MOULD_%zu", status, n );
+      CALLHDFQ( H5Lmove( locator->group_id, oldname, locator->group_id,
+                         tmpname, H5P_DEFAULT, H5P_DEFAULT ) );
+      nout++;
+    }
+    for (n = 1; n <= newcount; n++) {
+      dat1Index2Coords( n, ndim, dims, coords, status );
+      dat1Coords2CellName( ndim, coords, newname, sizeof(newname), status );
+      one_snprintf( tmpname, sizeof(tmpname), "+MOULD_%zu", status, n );
+      CALLHDFQ( H5Lmove( locator->group_id, tmpname, locator->group_id,
+                         newname, H5P_DEFAULT, H5P_DEFAULT ) );
+      nin++;
+    }
 
+    /* Need to update the dimensions in the attribute */
+    dat1SetStructureDims( locator->group_id, ndim, dims, status );
+    if (*status != SAI__OK) goto CLEANUP;
+
+    /* The new shape is now complete in the file */
+    nout = nin = 0;
+
+    /* Rename the Handles for any cells that have been located, so that
+       they continue to match the HDF5 names. */
+    handle = locator->handle;
+    for (i = 0; i < handle->nchild && *status == SAI__OK; i++) {
+      Handle *child = handle->children[i];
+      if (child && child->name) {
+        n = dat1CellIndex( child->name, curndim, curdims );
+        if (n > 0) {
+          dat1Index2Coords( n, ndim, dims, coords, status );
+          dat1Coords2CellName( ndim, coords, newname, sizeof(newname), status );
+          dat1MoveHandle( child, handle, newname, status );
+        }
+      }
+    }
+
+  } else {
+
+    /* The rank of a dataset is fixed, so we need a new one. */
+    dat1RecreatePrim( "datMould", locator, 0, ndim, dims, status );
+
+  }
+
+ CLEANUP:
+  /* Put back any cells of a structure array that have been renamed, so
+     that a failure leaves the old shape intact */
+  if (*status != SAI__OK && nout > 0) {
+    dat1MouldUndo( locator->group_id, curndim, curdims, ndim, dims, nout,
+                   nin );
+  }
   return *status;
 }
+
+/* Reverse the renaming of the cells of a structure array, given the
+   number of cells that had been moved to temporary names and the number
+   that had then been moved to their new names. Runs regardless of the
+   inherited status, and any errors are ignored since the original error
+   is what matters. */
+static void dat1MouldUndo( hid_t group_id, int curndim, const hdsdim curdims[],
+                           int ndim, const hdsdim dims[], size_t nout,
+                           size_t nin ) {
+  char cellname[128];
+  char tmpname[128];
+  hdsdim coords[DAT__MXDIM];
+  int lstat = SAI__OK;
+  size_t n;
+
+  emsMark();
+  for (n = 1; n <= nin; n++) {
+    dat1Index2Coords( n, ndim, dims, coords, &lstat );
+    dat1Coords2CellName( ndim, coords, cellname, sizeof(cellname), &lstat );
+    one_snprintf( tmpname, sizeof(tmpname), "+MOULD_%zu", &lstat, n );
+    if (lstat == SAI__OK) {
+      H5Lmove( group_id, cellname, group_id, tmpname, H5P_DEFAULT,
+               H5P_DEFAULT );
+    }
+  }
+  for (n = 1; n <= nout; n++) {
+    dat1Index2Coords( n, curndim, curdims, coords, &lstat );
+    dat1Coords2CellName( curndim, coords, cellname, sizeof(cellname), &lstat );
+    one_snprintf( tmpname, sizeof(tmpname), "+MOULD_%zu", &lstat, n );
+    if (lstat == SAI__OK) {
+      H5Lmove( group_id, tmpname, group_id, cellname, H5P_DEFAULT,
+               H5P_DEFAULT );
+    }
+  }
+  H5Eclear2( H5E_DEFAULT );
+  if (lstat != SAI__OK) emsAnnul( &lstat );
+  emsRlse();
+}
+
+/* Return the 1-based vectorized index of the cell with the given cell
+   name, or zero if the name does not describe a cell of an array with
+   the given dimensions. */
+static size_t dat1CellIndex( const char *cellname, int ndim,
+                             const hdsdim dims[] ) {
+  const char cellroot[] = DAT__CELLNAME "(";
+  const char *ptr;
+  char *endptr;
+  size_t index = 0;
+  size_t stride = 1;
+  long coord;
+  int i;
+
+  if (strncmp( cellname, cellroot, strlen(cellroot) ) ) return 0;
+  ptr = cellname + strlen(cellroot);
+
+  for (i = 0; i < ndim; i++) {
+    coord = strtol( ptr, &endptr, 10 );
+    if (endptr == ptr || coord < 1 || coord > dims[i]) return 0;
+    index += (coord - 1) * stride;
+    stride *= dims[i];
+    ptr = endptr + 1;
+    if (*endptr != (i == ndim - 1 ? ')' : ',')) return 0;
+  }
+
+  return index + 1;
+}
@@ -135,6 +135,10 @@ datMove( HDSLoc **locator1, const HDSLoc *locator2, const char *name_str,
   if ((*locator1)->file_id == locator2->file_id) {
     CALLHDFQ(H5Lmove( parentloc->group_id, sourcename,
                       locator2->group_id, cleanname, H5P_DEFAULT, H5P_DEFAULT));
+
+    /* Keep the Handle tree in step with the file. This also discards
+       any cached paths, which are now out of date. */
+    dat1MoveHandle( (*locator1)->handle, locator2->handle, cleanname, status );
   } else {
     datCopy( *locator1, locator2, name_str, status );
     datErase( parentloc, sourcename, status );
@@ -109,9 +109,12 @@ datNew( const HDSLoc    *locator,
         int       *status) {
 
   HDSLoc * newloc;
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datNew", 1, locator, 0, status );
 
@@ -121,6 +124,7 @@ datNew( const HDSLoc    *locator,
      component you have just created */
   datAnnul( &newloc, status );
 
+  HDS1_STATS_END( HDS__STAT_DATNEW, tstart, 0, locator->handle );
   return *status;
 
 }
@@ -0,0 +1,268 @@
+/*
+*+
+*  Name:
+*     datPrefetch
+
+*  Purpose:
+*     Start reading primitive values in the background
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     datPrefetch( const HDSLoc *locator, const char *type_str, int *status );
+
+*  Arguments:
+*     locator = const HDSLoc * (Given)
+*        Primitive locator.
+*     type_str = const char * (Given)
+*        Data type that the values will later be requested as.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Queues a read of all the values selected by the locator, converted
+*     to the given type, on an internal I/O thread and returns straight
+*     away. A later call to datGet or datMap (in READ or UPDATE mode) on the
+*     same locator with the same type then waits for the read to finish, if
+*     it has not already, and uses the values that were read. This allows
+*     the data for the next object to be read while the current one is
+*     being processed.
+
+*  Notes:
+*     - This is only a hint. If the values can not be read in the
+*       background (for example because the conversion to the requested
+*       type is performed by HDS rather than HDF5), nothing is queued and no
+*       error is reported. The values are then read when they are
+*       requested.
+*     - The prefetched values are discarded, after waiting for the read to
+*       complete, if the locator is used to write to the object or is
+*       annulled, or if they are requested as a different type.
+*     - Changes made to the object through a different locator after this
+*       call are not seen by the prefetched values.
+*     - The calling thread keeps its lock on the object. The I/O thread
+*       uses the locator's HDF5 identifiers and does not need its own lock.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <string.h>
+#include <pthread.h>
+
+#include "hdf5.h"
+
+#include "star/one.h"
+#include "ems.h"
+#include "sae_par.h"
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+
+#include "dat_err.h"
+
+#include "f77.h"
+
+int
+datPrefetch( const HDSLoc *locator, const char *type_str, int *status ) {
+
+  HDSLoc *loc = (HDSLoc *)locator;  /* Prefetch state lives in the locator */
+  HdsAsyncIO *prefetch = NULL;
+  char normtypestr[DAT__SZTYP+1];
+  hdsbool_t defined = HDS_FALSE;
+  hdstype_t intype = HDSTYPE_NONE;
+  hdstype_t outtype = HDSTYPE_NONE;
+  hid_t h5type = 0;
+  hid_t filetype = 0;
+  hssize_t npoints = 0;
+  size_t nbytes = 0;
+  int convflags;
+  int isprim;
+  uint64_t tstart = 0;
+
+  if (*status != SAI__OK) return *status;
+
+  HDS1_STATS_BEGIN( tstart );
+
+  /* Validate input locator. */
+  dat1ValidateLocator( "datPrefetch", 1, locator, 1, status );
+
+  /* Complete any writes to the object that are still in progress */
+  if (*status == SAI__OK) hds1WriteWait( locator->handle, status );
+  if (*status != SAI__OK) return *status;
+
+  if (locator->dataset_id <= 0) {
+    *status = DAT__OBJIN;
+    emsRep("datPrefetch_1", "datPrefetch: Can only prefetch a primitive",
+           status );
+    return *status;
+  }
+
+  /* Any earlier request is replaced */
+  hds1PrefetchDiscard( loc );
+
+  isprim = dau1CheckType( 1, type_str, &h5type, normtypestr,
+                          sizeof(normtypestr), status );
+  if (!isprim) {
+    if (*status == SAI__OK) {
+      *status = DAT__TYPIN;
+      emsRepf("datPrefetch_2", "datPrefetch: Data type must be a primitive "
+              "type and not '%s'", status, normtypestr);
+    }
+    goto CLEANUP;
+  }
+
+  datState( locator, &defined, status );
+  if (!defined && *status == SAI__OK) {
+    *status = DAT__UNSET;
+    emsRep("datPrefetch_3", "datPrefetch: Primitive object is undefined. "
+           "Nothing to get.", status );
+    goto CLEANUP;
+  }
+
+  /* Use the string length of the object for plain _CHAR, as datMap does */
+  if (strcmp( "_CHAR", normtypestr ) == 0) {
+    size_t clen = 0;
+    char tmpbuff[DAT__SZTYP+1];
+    datClen( locator, &clen, status );
+    CALLHDFQ( H5Tset_size( h5type, clen ) );
+    one_snprintf( tmpbuff, sizeof(tmpbuff), "*%zu", status, clen );
+    one_strlcat( normtypestr, tmpbuff, DAT__SZTYP+1, status );
+  }
+
+  /* Only conversions that HDF5 can do on its own are possible in the
+     background. That excludes reading into a shorter string, where datGet
+     checks for truncation. */
+  intype = dat1Type( locator, status );
+  outtype = dau1HdsType( h5type, status );
+  convflags = dat1ConvFlags( intype, outtype );
+  if (convflags & (HDS__CONV_CHAR|HDS__CONV_LOGICAL)) goto CLEANUP;
+  if (outtype == HDSTYPE_CHAR) {
+    CALLHDFE( hid_t, filetype,
+              H5Dget_type( locator->dataset_id ),
+              DAT__HDF5E,
+              emsRep("datPrefetch_4", "datPrefetch: Error obtaining data type "
+                     "of dataset", status)
+              );
+    if (H5Tget_size( filetype ) > H5Tget_size( h5type )) goto CLEANUP;
+  }
+
+  CALLHDFE( hssize_t, npoints,
+            H5Sget_select_npoints( locator->dataspace_id ),
+            DAT__HDF5E,
+            emsRep("datPrefetch_5", "datPrefetch: Error obtaining number of "
+                   "elements", status)
+            );
+  nbytes = H5Tget_size( h5type ) * (size_t)npoints;
+
+  prefetch = MEM_CALLOC( 1, sizeof(*prefetch) );
+  if (!prefetch) {
+    *status = DAT__NOMEM;
+    emsRep("datPrefetch_6", "datPrefetch: Unable to allocate memory", status );
+    goto CLEANUP;
+  }
+  pthread_mutex_init( &(prefetch->mutex), NULL );
+  pthread_cond_init( &(prefetch->cond), NULL );
+  prefetch->done = HDS_FALSE;
+  prefetch->status = SAI__OK;
+  prefetch->handle = loc->handle;
+
+  /* The request holds its own reference to the dataset, so that the I/O
+     thread can still read it if the locator's identifier is replaced or
+     closed in the meantime. */
+  prefetch->dataset_id = locator->dataset_id;
+  H5Iinc_ref( prefetch->dataset_id );
+  prefetch->memtype = h5type;
+  h5type = 0;
+  one_strlcpy( prefetch->type, normtypestr, sizeof(prefetch->type), status );
+  prefetch->nbytes = nbytes;
+  prefetch->buffer = cnfMalloc( nbytes > 0 ? nbytes : 1 );
+  if (!prefetch->buffer) {
+    *status = DAT__NOMEM;
+    emsRepf("datPrefetch_7", "datPrefetch: Unable to allocate %zu bytes of "
+            "memory", status, nbytes );
+    goto CLEANUP;
+  }
+  CALLHDFE( hid_t, prefetch->filespace_id,
+            H5Scopy( locator->dataspace_id ),
+            DAT__HDF5E,
+            emsRep("datPrefetch_8", "datPrefetch: Error copying dataspace",
+                   status)
+            );
+
+  /* The transfer property list is obtained here since the I/O thread
+     cannot report errors */
+  prefetch->dxpl = dat1XferProps( status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  /* Once queued the request belongs to the locator */
+  hds1PrefetchQueue( prefetch, status );
+  if (*status == SAI__OK) {
+    dat1CountIO( loc->handle, HDS__IO_READ, nbytes );
+    if (intype != outtype) hds1MetricsConvert( intype, outtype, npoints );
+    loc->prefetch = prefetch;
+    prefetch = NULL;
+  }
+
+ CLEANUP:
+  if (prefetch) {
+    /* Never queued, so it can be freed through the usual route */
+    prefetch->done = HDS_TRUE;
+    prefetch->status = DAT__FATAL;
+    loc->prefetch = prefetch;
+    hds1PrefetchDiscard( loc );
+  }
+  if (filetype > 0) H5Tclose( filetype );
+  if (h5type > 0) H5Tclose( h5type );
+  HDS1_STATS_END( HDS__STAT_DATPREFETCH, tstart, 0, locator->handle );
+  return *status;
+}
@@ -117,19 +117,31 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
   hdstype_t doconv = HDSTYPE_NONE;
   hdstype_t intype = HDSTYPE_NONE;
   hdstype_t outtype = HDSTYPE_NONE;
+  int convflags = 0;
   hid_t h5type = 0;
   hid_t mem_dataspace_id = 0;
+  hid_t dxpl = H5P_DEFAULT;
   hsize_t h5dims[DAT__MXDIM];
   int actdim;
   int i;
   int isprim;
   void * tmpvalues = NULL;
+  size_t nbytes = 0;
+  uint64_t tstart = 0;
+  uint64_t tstage = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datPut", 1, locator, 0, status );
 
+  /* Any prefetched values are about to become out of date, and earlier
+     writes still in progress must not overwrite these values */
+  hds1PrefetchDiscard( (HDSLoc *)locator );
+  if (*status == SAI__OK) hds1WriteWait( locator->handle, status );
+
   namestr[ 0 ] = 0;
   datName(locator, namestr, status);
 
@@ -188,11 +200,10 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
   outtype = dat1Type( locator, status );
   intype = dau1HdsType( h5type, status );
 
-  if ((outtype == HDSTYPE_CHAR && intype != HDSTYPE_CHAR) ||
-      (outtype != HDSTYPE_CHAR && intype == HDSTYPE_CHAR)) {
+  convflags = dat1ConvFlags( intype, outtype );
+  if (convflags & HDS__CONV_CHAR) {
     doconv = HDSTYPE_CHAR;
-  } else if ((outtype == HDSTYPE_LOGICAL && intype != HDSTYPE_LOGICAL) ||
-             (outtype != HDSTYPE_LOGICAL && intype == HDSTYPE_LOGICAL)) {
+  } else if (convflags & HDS__CONV_LOGICAL) {
     doconv = HDSTYPE_LOGICAL;
   }
 
@@ -225,6 +236,7 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
     /* Create a buffer to receive the converted values */
     tmpvalues = MEM_MALLOC( nelem * nbout );
 
+    HDS1_STATS_BEGIN( tstage );
     if (doconv == HDSTYPE_CHAR) {
       dat1CvtChar( nelem, intype, nbin, outtype, nbout, values,
                    tmpvalues, &nbad, status );
@@ -232,6 +244,7 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
       dat1CvtLogical( nelem, intype, nbin, outtype, nbout, values,
                       tmpvalues, &nbad, status );
     }
+    HDS1_STATS_END( HDS__STAT_CONVERT, tstage, nelem * nbout, locator->handle );
     /* The type of the things we are writing has now changed
        so we need to update that */
     if (h5type) H5Tclose(h5type);
@@ -255,10 +268,23 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
            emsRep("datPut_2", "Error allocating in-memory dataspace", status )
            );
 
-  CALLHDFQ( H5Dwrite( locator->dataset_id, h5type, mem_dataspace_id,
-                      locator->dataspace_id, H5P_DEFAULT,
-                      (tmpvalues ? tmpvalues : values )
-                      ) );
+  dxpl = dat1XferProps( status );
+  hds1WriteNote( locator->handle );
+  HDS1_STATS_BEGIN( tstage );
+  if (!hds1ChunkIO( locator, h5type, HDS_TRUE,
+                    (tmpvalues ? tmpvalues : (void *)values ), status )) {
+    CALLHDFQ( H5Dwrite( locator->dataset_id, h5type, mem_dataspace_id,
+                        locator->dataspace_id, dxpl,
+                        (tmpvalues ? tmpvalues : values )
+                        ) );
+  }
+  nbytes = H5Sget_select_npoints( mem_dataspace_id ) * H5Tget_size( h5type );
+  dat1CountIO( locator->handle, HDS__IO_WRITE, nbytes );
+  HDS1_STATS_END( HDS__STAT_H5DWRITE, tstage, nbytes, locator->handle );
+  if (intype != outtype) {
+    hds1MetricsConvert( intype, outtype,
+                        H5Sget_select_npoints( mem_dataspace_id ) );
+  }
 
  CLEANUP:
   if (h5type) H5Tclose(h5type);
@@ -268,5 +294,6 @@ datPut( const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims
     emsRepf("datPut_3", "datPut: Error writing data of type '%s' into primitive %s",
             status, normtypestr, namestr);
   }
+  HDS1_STATS_END( HDS__STAT_DATPUT, tstart, 0, locator->handle );
   return *status;
 }
@@ -151,6 +151,9 @@ datRenam( HDSLoc *locator, const char *name_str, int  *status) {
     }                                                                   \
   }
 
+  /* The identifiers are replaced, so drop any prefetch using them */
+  hds1PrefetchDiscard( locator );
+
   COPYCOMP( dataset_id, H5Dclose );
   COPYCOMP( group_id, H5Gclose );
   COPYCOMP( dataspace_id, H5Sclose );
@@ -31,7 +31,17 @@
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Not Yet Implemented.
+*     - A structure can only be given a structure type and a primitive
+*       a primitive type.
+*     - For a structure only the type attribute is changed (on every
+*       cell of a structure array).
+*     - For a primitive the new type must have the same size in the file
+*       as the old one, and the stored bytes are reinterpreted without
+*       any conversion. HDF5 can not change the type of an existing
+*       dataset, so the primitive is recreated and the bytes are copied.
+*     - Can not be called on a vectorized locator, a slice, a cell or a
+*       mapped primitive. All the cells of an array have the same type,
+*       so the type of a single cell can not be changed on its own.
 
 *  History:
 *     2014-10-16 (TIMJ):
@@ -93,14 +103,114 @@
 int
 datRetyp( const HDSLoc *locator, const char *type_str, int *status) {
 
+  char normtypestr[DAT__SZTYP+1];
+  hid_t h5type = 0;
+  hid_t oldtype = 0;
+  int isprim;
+
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
   dat1ValidateLocator( "datRetyp", 1, locator, 0, status );
+  if (*status != SAI__OK) return *status;
 
-  *status = DAT__FATAL;
-  emsRep("datRetyp", "datRetyp: Not yet implemented for HDF5",
-         status);
-
+  if (locator->vectorized || locator->isslice || locator->iscell ||
+      locator->regpntr) {
+    *status = DAT__OBJIN;
+    emsRep("datRetyp_1", "datRetyp: Can not change the type of a vectorized, "
+           "sliced, mapped or single cell object", status);
+    return *status;
+  }
+
+  isprim = dau1CheckType( HDS_FALSE, type_str, &h5type, normtypestr,
+                          sizeof(normtypestr), status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  if ( dat1IsStructure( locator, status ) ) {
+    hdsdim dims[DAT__MXDIM];
+    int ndim;
+
+    if (isprim) {
+      if (*status == SAI__OK) {
+        *status = DAT__TYPIN;
+        emsRepf("datRetyp_2", "datRetyp: Can not change a structure to "
+                "primitive type '%s'", status, normtypestr );
+      }
+      goto CLEANUP;
+    }
+
+    /* The type of a structure is an attribute of the group, and of each
+       cell of a structure array. */
+    dat1SetAttrString( locator->group_id, HDS__ATTR_STRUCT_TYPE, normtypestr,
+                       status );
+
+    ndim = dat1GetStructureDims( locator, DAT__MXDIM, dims, status );
+    if (ndim > 0 && *status == SAI__OK) {
+      char cellname[128];
+      hdsdim coords[DAT__MXDIM];
+      hid_t cell_id = 0;
+      size_t ncells = 1;
+      size_t n;
+      int i;
+
+      for (i = 0; i < ndim; i++) ncells *= dims[i];
+      for (n = 1; n <= ncells; n++) {
+        dat1Index2Coords( n, ndim, dims, coords, status );
+        dat1Coords2CellName( ndim, coords, cellname, sizeof(cellname), status );
+        CALLHDFE( hid_t, cell_id,
+                 H5Gopen2( locator->group_id, cellname, H5P_DEFAULT ),
+                 DAT__HDF5E,
+                 emsRepf("datRetyp_3", "datRetyp: Error opening cell %s",
+                         status, cellname )
+                 );
+        dat1SetAttrString( cell_id, HDS__ATTR_STRUCT_TYPE, normtypestr,
+                           status );
+        H5Gclose( cell_id );
+      }
+    }
+
+  } else {
+
+    if (!isprim) {
+      if (*status == SAI__OK) {
+        *status = DAT__TYPIN;
+        emsRepf("datRetyp_4", "datRetyp: Can not change a primitive to "
+                "structure type '%s'", status, normtypestr );
+      }
+      goto CLEANUP;
+    }
+
+    CALLHDFE( hid_t, oldtype,
+             H5Dget_type( locator->dataset_id ),
+             DAT__HDF5E,
+             emsRep("datRetyp_5", "datRetyp: Error obtaining data type of dataset",
+                    status)
+             );
+
+    /* Nothing to do if the type is unchanged */
+    if (H5Tequal( oldtype, h5type ) > 0) goto CLEANUP;
+
+    if (H5Tget_size( oldtype ) != H5Tget_size( h5type )) {
+      char oldtypestr[DAT__SZTYP+1];
+      datType( locator, oldtypestr, status );
+      if (*status == SAI__OK) {
+        *status = DAT__TYPIN;
+        emsRepf("datRetyp_6", "datRetyp: Can not change type '%s' to '%s' "
+                "since the element sizes differ", status, oldtypestr,
+                normtypestr );
+      }
+      goto CLEANUP;
+    }
+
+    /* The type of a dataset is fixed, so we need a new one. The locator
+       is updated to refer to it, as if the type had been changed in
+       place. */
+    dat1RecreatePrim( "datRetyp", (HDSLoc *)locator, h5type, 0, NULL, status );
+
+  }
+
+ CLEANUP:
+  if (h5type > 0) H5Tclose( h5type );
+  if (oldtype > 0) H5Tclose( oldtype );
   return *status;
 }
@@ -133,9 +133,12 @@ datSlice(const HDSLoc *locator1, int ndim, const hdsdim lower[],
   int loc1ndims = 0;
   size_t loc1size;
   size_t nelem;
+  uint64_t tstart = 0;
 
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datSlice", 1, locator1, 1, status );
 
@@ -266,5 +269,7 @@ datSlice(const HDSLoc *locator1, int ndim, const hdsdim lower[],
     *locator2 = sliceloc;
   }
 
+  HDS1_STATS_END( HDS__STAT_DATSLICE, tstart, 0,
+                  (*status == SAI__OK ? sliceloc->handle : locator1->handle) );
   return *status;
 }
@@ -92,73 +92,18 @@
 int
 datType( const HDSLoc *locator, char type_str[DAT__SZTYP+1], int * status ) {
 
-  hdstype_t hdstyp = HDSTYPE_NONE;
-  hid_t h5type = 0;
-  hid_t h5attr = 0;
-
   if (*status != SAI__OK) return *status;
 
   /* Validate input locator. */
   dat1ValidateLocator( "datType", 1, locator, 1, status );
-
-  hdstyp = dat1Type( locator, status );
   if (*status != SAI__OK) return *status;
 
-  switch (hdstyp) {
-  case HDSTYPE_INTEGER:
-    one_strlcpy( type_str, "_INTEGER", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_REAL:
-    one_strlcpy( type_str, "_REAL", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_DOUBLE:
-    one_strlcpy( type_str, "_DOUBLE", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_BYTE:
-    one_strlcpy( type_str, "_BYTE", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_UBYTE:
-    one_strlcpy( type_str, "_UBYTE", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_WORD:
-    one_strlcpy( type_str, "_WORD", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_UWORD:
-    one_strlcpy( type_str, "_UWORD", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_LOGICAL:
-    one_strlcpy( type_str, "_LOGICAL", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_INT64:
-    one_strlcpy( type_str, "_INT64", DAT__SZTYP+1, status);
-    break;
-  case HDSTYPE_CHAR:
-    /* Get the type from the dataset and request its size */
-    {
-      size_t dsize = 0;
-      CALLHDFE( hid_t, h5type,
-               H5Dget_type( locator->dataset_id ),
-               DAT__HDF5E,
-               emsRep("datType_1", "datType: Error obtaining data type of dataset", status)
-               );
-      dsize = H5Tget_size( h5type );
-      one_snprintf( type_str, DAT__SZTYP+1, "_CHAR*%zu", status, dsize );
-    }
-    break;
-  case HDSTYPE_STRUCTURE:
-    /* Read the type attribute */
-    dat1GetAttrString( locator->group_id, HDS__ATTR_STRUCT_TYPE, HDS_TRUE,
-                       "HDF5NATIVEGROUP", type_str, DAT__SZTYP+1, status );
-    break;
-  default:
-    *status = DAT__TYPIN;
-    emsRepf("datType_inv","datType: Unknown type associated with dataset/group (%d)",
-            status, hdstyp);
+  if (dat1IsStructure( locator, status ) ) {
+    (void)dat1TypeStr( locator->group_id, type_str, status );
+  } else {
+    (void)dat1TypeStr( locator->dataset_id, type_str, status );
   }
 
- CLEANUP:
-  if (h5type > 0) H5Tclose(h5type);
-  if (h5attr > 0) H5Aclose(h5attr);
   return *status;
 
 }
@@ -106,6 +106,7 @@ int
 datUnmap( HDSLoc * locator, int * status ) {
   /* Try to unmap even if status is bad */
   int lstat = SAI__OK;
+  uint64_t tstart = 0;
 
   /* Just ignore a null pointer */
   if (!locator) return *status;
@@ -113,6 +114,8 @@ datUnmap( HDSLoc * locator, int * status ) {
   /* if there is no mapped pointer in this locator do nothing */
   if (!locator->regpntr) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Validate input locator. */
   dat1ValidateLocator( "datUnmap", 1, locator, (locator->accmode & HDSMODE_READ), &lstat );
   if( lstat != SAI__OK) {
@@ -135,15 +138,25 @@ datUnmap( HDSLoc * locator, int * status ) {
 
        emsMark();
 
-       if (locator->accmode == HDSMODE_WRITE ||
-           locator->accmode == HDSMODE_UPDATE) {
-         datPut( locator, locator->maptype, locator->ndims, locator->mapdims,
-                 locator->regpntr, &lstat);
+       if ((locator->accmode == HDSMODE_WRITE ||
+            locator->accmode == HDSMODE_UPDATE) &&
+           !hds1WriteBehind( locator, &lstat )) {
+         if (locator->isbasic) {
+           dat1BasicIO( locator, HDS_TRUE, locator->regpntr, &lstat );
+         } else {
+           datPut( locator, locator->maptype, locator->ndims, locator->mapdims,
+                   locator->regpntr, &lstat);
+         }
        }
 
        /* if we have bad status from this just ignore it. Release the error stack */
        if (lstat != SAI__OK) emsAnnul( &lstat );
        emsRlse();
+
+     /* Values written through memory mapped from the file invalidate any
+        prefetched copy of them */
+     } else if (locator->accmode != HDSMODE_READ) {
+       hds1WriteNote( locator->handle );
      }
 
      /* Need to free the memory and, if needed, unregister the pointer.
@@ -151,13 +164,22 @@ datUnmap( HDSLoc * locator, int * status ) {
      if (locator->pntr) {
        cnfUregp( locator->regpntr );
 
-       if ( munmap( locator->pntr, locator->bytesmapped ) != 0 ) {
+       if ( hds1Munmap( locator->pntr, locator->bytesmapped ) != 0 ) {
          if (*status == SAI__OK) {
            *status = DAT__FILMP;
            emsSyser( "MESSAGE", errno );
            emsRep("datUnMap_4", "datUnmap: Error unmapping mapped memory: ^MESSAGE", status);
          }
        }
+     } else if (locator->ishuge) {
+       /* Anonymous memory on huge pages, registered with CNF */
+       if ( hds1HugeFree( locator->regpntr, locator->bytesmapped ) != 0 ) {
+         if (*status == SAI__OK) {
+           *status = DAT__FILMP;
+           emsSyser( "MESSAGE", errno );
+           emsRep("datUnMap_5", "datUnmap: Error freeing mapped memory: ^MESSAGE", status);
+         }
+       }
      } else if (locator->regpntr) {
        /* Allocated memory that needs to be freed by CNF but was not mmapped */
        cnfFree( locator->regpntr );
@@ -175,9 +197,17 @@ datUnmap( HDSLoc * locator, int * status ) {
        }
      }
 
+     if (locator->datasize > 0) {
+       dat1CountIO( locator->handle, (locator->pntr ? HDS__IO_UNMAP :
+                                      HDS__IO_UNCOPYMAP), locator->datasize );
+     }
+
      locator->pntr = NULL;
      locator->regpntr = NULL;
      locator->bytesmapped = 0;
+     locator->isbasic = HDS_FALSE;
+     locator->ishuge = HDS_FALSE;
+     locator->datasize = 0;
 
      /* Close the file if we opened it -- ignore the return value */
      if (locator->fdmap > 0) {
@@ -186,5 +216,6 @@ datUnmap( HDSLoc * locator, int * status ) {
      }
   }
 
+  HDS1_STATS_END( HDS__STAT_DATUNMAP, tstart, 0, locator->handle );
   return *status;
 }
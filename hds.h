@@ -128,6 +128,13 @@ datErmsg(int status, size_t *len, char *msg_str);
 int
 datFind(const HDSLoc *locator1, const char *name_str, HDSLoc **locator2, int *status);
 
+/*======================================*/
+/* datFindPath - Find component by path */
+/*======================================*/
+
+int
+datFindPath(const HDSLoc *locator1, const char *path_str, HDSLoc **locator2, int *status);
+
 /*============================*/
 /* datGet - Read primitive(s) */
 /*============================*/
@@ -135,6 +142,13 @@ datFind(const HDSLoc *locator1, const char *name_str, HDSLoc **locator2, int *st
 int
 datGet(const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims[], void *values, int *status);
 
+/*=======================================*/
+/* datGetBatch - Read several components */
+/*=======================================*/
+
+int
+datGetBatch(const HDSLoc *locator, size_t nitem, HDSBatchItem items[], int *status);
+
 /*===================================*/
 /* datGetC - Read _CHAR primitive(s) */
 /*===================================*/
@@ -346,6 +360,12 @@ datGetVR(const HDSLoc * locator, size_t maxval, float values[], size_t *actval,
 int
 datGetVL(const HDSLoc * locator, size_t maxval, hdsbool_t values[], size_t *actval, int * status);
 
+/*=====================================================*/
+/* datGetRegion - Read primitive(s) into part of array */
+/*=====================================================*/
+
+int
+datGetRegion(const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims[], const hdsdim bufdims[], const hdsdim lower[], void *values, int *status);
 
 /*======================================*/
 /* datIndex - Index into component list */
@@ -354,6 +374,13 @@ datGetVL(const HDSLoc * locator, size_t maxval, hdsbool_t values[], size_t *actv
 int
 datIndex(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status);
 
+/*================================================*/
+/* datIterate - Iterate over structure components */
+/*================================================*/
+
+int
+datIterate(const HDSLoc *locator, hdsbool_t opencomp, datIterFunc func, void *data, int *status);
+
 /*===================================*/
 /* datLen - Inquire primitive length */
 /*===================================*/
@@ -385,6 +412,13 @@ datLocked( const HDSLoc *locator, int recursive, int *status);
 int
 datMap(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim, const hdsdim dims[], void **pntr, int *status);
 
+/*==========================================================*/
+/* datMapAdvise - Specify the access pattern of mapped data */
+/*==========================================================*/
+
+int
+datMapAdvise(HDSLoc *locator, const char *pattern_str, int *status);
+
 /*==================================*/
 /* datMapC - Map _CHAR primitive(s) */
 /*==================================*/
@@ -635,6 +669,13 @@ datParen(const HDSLoc *locator1, HDSLoc **locator2, int *status);
 int
 datPrec(const HDSLoc *locator, size_t *nbytes, int *status);
 
+/*======================================================*/
+/* datPrefetch - Start reading values in the background */
+/*======================================================*/
+
+int
+datPrefetch(const HDSLoc *locator, const char *type_str, int *status);
+
 /*====================================*/
 /* datPrim - Enquire object primitive */
 /*====================================*/
@@ -712,6 +753,13 @@ datPutL(const HDSLoc *locator, int ndim, const hdsdim dims[], const hdsbool_t va
 int
 datPut(const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims[], const void *values, int *status);
 
+/*========================================*/
+/* datPutBatch - Write several components */
+/*========================================*/
+
+int
+datPutBatch(const HDSLoc *locator, size_t nitem, HDSBatchItem items[], int *status);
+
 /*=======================================*/
 /* datPut0C - Write scalar string value  */
 /*=======================================*/
@@ -1085,6 +1133,13 @@ hdsLink(HDSLoc *locator, const char *group_str, int *status);
 int
 hdsLock(const HDSLoc *locator, int *status);
 
+/*====================================================*/
+/* hdsMetrics - Return a snapshot of run time metrics */
+/*====================================================*/
+
+int
+hdsMetrics(char *buffer, size_t buflen, int *status);
+
 /*====================================*/
 /* hdsNew - Create new container file */
 /*====================================*/
@@ -1120,6 +1175,13 @@ hdsState(hdsbool_t *state, int *status);
 int
 hdsStop(int *status);
 
+/*================================================*/
+/* hdsSync - Wait for background writes to finish */
+/*================================================*/
+
+int
+hdsSync(int *status);
+
 /*==============================*/
 /* hdsTrace - Trace object path */
 /*==============================*/
@@ -0,0 +1,1548 @@
+/*
+*+
+*  Name:
+*     hdsBench
+
+*  Purpose:
+*     Time common HDS operations
+
+*  Language:
+*     Starlink ANSI C
+
+*  Usage:
+*     hdsBench [scale [maxthreads]]
+*     hdsBench io [maxmb [profile]]
+
+*  Description:
+*     This program runs a set of reproducible microbenchmarks of the C API
+*     to HDS and writes the results to standard output as a JSON array,
+*     one object per benchmark. It is not a test and does not check the
+*     values it reads.
+*
+*     The benchmarks cover creating, opening and closing container files,
+*     locating components of wide and deep structures and of structure
+*     arrays, scalar and large transfers with and without type
+*     conversion, mapping, slices and vectorised access, copying and
+*     concurrent reading from several threads. Reads of a large _WORD
+*     image as _REAL values are timed with several sizes of the buffer
+*     in which HDF5 converts the values (see the NBLOCKS and HYPERVEC
+*     tuning parameters). Large transfers of an image stored in chunks,
+*     with and without compression, are timed with the chunks handled
+*     by HDF5 and read and written directly by HDS using one thread and
+*     using up to the maximum number of threads (see the CHUNKIO tuning
+*     parameter).
+*
+*     It also measures how the throughput of locking, locating and reading
+*     objects scales with the number of threads doing so at once, from one
+*     thread up to a given maximum, doubling each time. This is done both
+*     with all threads sharing a single read-only container and with each
+*     thread using its own writable container.
+*
+*     If the first argument is "io", a sweep of large array reads is run
+*     instead. Arrays of _REAL values, made of planes of 256 by 256
+*     elements, are created with sizes from 1MiB up to a given maximum,
+*     increasing by a factor of four, and stored contiguously and in
+*     chunks of several sizes (see the CHUNK tuning parameter). Each is
+*     read sequentially in large blocks, one plane at a time and in
+*     small tiles at random positions, using datGet and using datMap
+*     both with the data mapped directly from the file and copied into
+*     memory. The configuration that reads the largest arrays fastest is
+*     then reported as a recommended set of tuning parameters and may
+*     be written to a file that can be named by the HDS_TUNE_FILE
+*     environment variable.
+
+*  Parameters:
+*     scale
+*        Optional positive integer by which the number of times each
+*        operation is repeated is multiplied. The sizes of the objects
+*        used are not changed, so results from different scales can be
+*        compared directly. Default 1.
+*     maxthreads
+*        Optional largest number of threads used by the scaling
+*        benchmark and for direct chunk transfers. Default 8.
+*     maxmb
+*        Optional size in MiB of the largest array read by the "io"
+*        sweep. Default 64.
+*     profile
+*        Optional name of a file to which the tuning parameters
+*        recommended by the "io" sweep are written.
+
+*  Notes:
+*     - Scratch container files are created in the current directory and
+*       erased afterwards. The "io" sweep needs free disk space for the
+*       largest array.
+*     - Arrays are read straight after they are written, so they will
+*       usually be in the operating system's file cache.
+*     - Each JSON object gives the name of the benchmark, the variant
+*       (e.g. whether type conversion was needed), the number of
+*       operations timed, the number of threads used, the elapsed time in
+*       seconds, the number of data bytes transferred (zero if not
+*       relevant) and the resulting rates. Benchmarks that use more than
+*       one thread also give the total time in microseconds spent by
+*       threads waiting for objects locked by other threads, as reported
+*       by hdsInfoI.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "ems.h"
+#include "dat_err.h"
+#include "sae_par.h"
+
+/* Number of primitives mapped by benchMapSmall */
+#define NMAP 10000
+
+/* Number of create, open and close cycles timed by benchOpenClose */
+#define NCYCLE 200
+
+/* Number of components in the wide structure, levels in the deep
+   structure and cells in the structure array used by benchTree, and the
+   number of times the deep structure is followed */
+#define NWIDE 1000
+#define NDEEP 50
+#define NCELL 1000
+#define NPASS 20
+
+/* Number of scalar transfers timed by benchScalar */
+#define NSCALAR 20000
+
+/* Number of elements in the primitive used by benchLarge, and the number
+   of times it is transferred */
+#define NLARGE (4*1024*1024)
+#define NREPEAT 10
+
+/* Number of rows and columns in the _WORD image used by benchConvert,
+   and the number of columns in each slice of it that is read */
+#define NIMAGE 2048
+#define NSTRIP 256
+
+/* Transfer buffer sizes, in 512-byte blocks, tried by benchConvert (see
+   the NBLOCKS tuning parameter), and the names of the variants. Zero
+   means the HDF5 default. */
+static const int conv_nblocks[] = { 0, 128, 8192, 32768 };
+static const char *conv_variants[] = { "nblocks_default", "nblocks_64k",
+                                       "nblocks_4m", "nblocks_16m" };
+#define NCONV ((int)(sizeof(conv_nblocks)/sizeof(conv_nblocks[0])))
+
+/* Chunk size, in KiB, of the image used by benchChunkIO, the deflate
+   levels it is stored with, and the names of the variants for each
+   level and way of transferring the chunks */
+#define CHUNKIO_KIB 1024
+static const int chunkio_levels[] = { 0, 4 };
+static const char *chunkio_variants[][3] = {
+  { "plain_hdf5", "plain_direct_1", "plain_direct_n" },
+  { "deflate_hdf5", "deflate_direct_1", "deflate_direct_n" }
+};
+#define NCHUNKIO ((int)(sizeof(chunkio_levels)/sizeof(chunkio_levels[0])))
+
+/* Number of rows and columns in the 2-D array used by benchSlice */
+#define NROW 1024
+
+/* Number of copies timed by benchCopy */
+#define NCOPY 20
+
+/* Number of threads used by benchReaders, and the number of elements
+   each reads per transfer */
+#define NREADER 4
+#define NREAD (1024*1024)
+
+/* Number of lock, locate, read and unlock cycles made by each thread in
+   benchLockScaling, and the number of elements read by each */
+#define NLOCKOP 2000
+#define NLOCKREAD 64
+
+/* Dimensions of each plane of the arrays used by the "io" sweep, the
+   number of planes read at once when reading sequentially, and the
+   dimensions of each tile read when reading at random */
+#define NPLANE 256
+#define NSEQPLANE 64
+#define NTILE 64
+
+/* Chunk sizes, in KiB, tried by the "io" sweep. Zero means contiguous. */
+static const int io_chunks[] = { 0, 64, 1024, 16384 };
+#define NIOCHUNK ((int)(sizeof(io_chunks)/sizeof(io_chunks[0])))
+
+/* Access patterns and methods tried by the "io" sweep */
+static const char *io_patterns[] = { "sequential", "plane", "tile" };
+static const char *io_methods[] = { "get", "mmap", "copy" };
+#define NIOPATTERN 3
+#define NIOMETHOD 3
+
+/* The result of a single benchmark */
+typedef struct BenchResult {
+  const char *name;     /* Name of the benchmark */
+  const char *variant;  /* Configuration it was run with */
+  size_t nops;          /* Number of operations timed */
+  size_t nbytes;        /* Number of data bytes transferred */
+  int nthread;          /* Number of threads used */
+  double seconds;       /* Elapsed time */
+  double lockwait;      /* Lock wait time in microseconds, or -1 */
+} BenchResult;
+
+/* Data passed to each thread run by benchReaders */
+typedef struct ReaderData {
+  const char *path;     /* Container file to read */
+  size_t nrepeat;       /* Number of times to read the data */
+  int status;           /* Returned status */
+} ReaderData;
+
+/* Data passed to each thread run by benchLockScaling */
+typedef struct LockData {
+  HDSLoc *loc;          /* Unlocked top-level locator to use */
+  int readonly;         /* Lock for read-only access? */
+  size_t nop;           /* Number of cycles to make */
+  int status;           /* Returned status */
+} LockData;
+
+/* Multiplier for the number of times each operation is repeated */
+static size_t scale = 1;
+
+/* Largest number of threads used by benchLockScaling */
+static int maxthreads = 8;
+
+static double benchTime( void );
+static void benchReport( const BenchResult *result, int *first );
+static void benchDone( const char *name, const char *variant, size_t nops,
+                       size_t nbytes, double seconds, int *first,
+                       int *status );
+static void benchMapSmall( int *first, int *status );
+static void benchOpenClose( int *first, int *status );
+static void benchTree( int *first, int *status );
+static void benchScalar( int *first, int *status );
+static void benchLarge( int *first, int *status );
+static void benchConvert( int *first, int *status );
+static void benchChunkIO( int *first, int *status );
+static void benchSlice( int *first, int *status );
+static void benchCopy( int *first, int *status );
+static void benchReaders( int *first, int *status );
+static void *benchReader( void *data );
+static void benchLockScaling( int *first, int *status );
+static void *benchLocker( void *data );
+static int benchLockWait( int *status );
+static void benchIOSweep( int maxmb, const char *profile, int *first,
+                          int *status );
+static double benchIORead( HDSLoc *loc, hdsdim nz, int pattern, int method,
+                           float *buf, int *status );
+
+int main (int argc, char **argv) {
+  int status = SAI__OK;
+  int first = 1;
+
+  emsBegin( &status );
+  printf( "[" );
+
+  if (argc > 1 && strcmp( argv[1], "io" ) == 0) {
+    int maxmb = 64;
+    if (argc > 2 && atoi( argv[2] ) > 0) maxmb = atoi( argv[2] );
+    benchIOSweep( maxmb, (argc > 3 ? argv[3] : NULL), &first, &status );
+    printf( "\n]\n" );
+    emsEnd( &status );
+    return (status == SAI__OK ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+
+  if (argc > 1 && atoi( argv[1] ) > 0) scale = atoi( argv[1] );
+  if (argc > 2 && atoi( argv[2] ) > 0) maxthreads = atoi( argv[2] );
+
+  benchOpenClose( &first, &status );
+  benchTree( &first, &status );
+  benchScalar( &first, &status );
+  benchLarge( &first, &status );
+  benchConvert( &first, &status );
+  benchChunkIO( &first, &status );
+  benchMapSmall( &first, &status );
+  benchSlice( &first, &status );
+  benchCopy( &first, &status );
+  benchReaders( &first, &status );
+  benchLockScaling( &first, &status );
+
+  printf( "\n]\n" );
+  emsEnd( &status );
+
+  return (status == SAI__OK ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/* Elapsed time in seconds from an arbitrary origin */
+static double benchTime( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + 1.0E-9 * ts.tv_nsec;
+}
+
+/* Write one result as a JSON object */
+static void benchReport( const BenchResult *result, int *first ) {
+  double rate = (result->seconds > 0.0 ? 1.0 / result->seconds : 0.0);
+  printf( "%s\n  {\"name\": \"%s\", \"variant\": \"%s\", \"nops\": %zu, "
+          "\"threads\": %d, \"seconds\": %.6f, \"ops_per_sec\": %.1f, "
+          "\"bytes\": %zu, \"mb_per_sec\": %.1f",
+          (*first ? "" : ","), result->name, result->variant, result->nops,
+          result->nthread, result->seconds, result->nops * rate,
+          result->nbytes, 1.0E-6 * result->nbytes * rate );
+  if (result->lockwait >= 0.0) {
+    printf( ", \"lockwait_us\": %.0f", result->lockwait );
+  }
+  printf( "}" );
+  *first = 0;
+}
+
+/* Report a benchmark, unless an error has occurred while running it */
+static void benchDone( const char *name, const char *variant, size_t nops,
+                       size_t nbytes, double seconds, int *first,
+                       int *status ) {
+  BenchResult result;
+  if (*status != SAI__OK) return;
+  result.name = name;
+  result.variant = variant;
+  result.nops = nops;
+  result.nbytes = nbytes;
+  result.nthread = 1;
+  result.seconds = seconds;
+  result.lockwait = -1.0;
+  benchReport( &result, first );
+}
+
+/* Map and unmap NMAP small primitives in a container opened for read
+   access, once with the data mapped directly from the file, which
+   requires each mapping to be registered with CNF, and once with the
+   data copied into memory. */
+static void benchMapSmall( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc **locs = NULL;
+  hdsdim dims[] = { 16 };
+  int values[16];
+  int *pntr = NULL;
+  int oldmap = 1;
+  int usemmap;
+  char name[DAT__SZNAM+1];
+  double start;
+  size_t i;
+  size_t j;
+
+  if (*status != SAI__OK) return;
+
+  for (i = 0; i < 16; i++) values[i] = i;
+
+  hdsNew( "hds_bench_map", "BENCH", "BENCH", 0, dims, &loc, status );
+  for (i = 0; i < NMAP && *status == SAI__OK; i++) {
+    HDSLoc *ploc = NULL;
+    sprintf( name, "P%zu", i );
+    datNew( loc, name, "_INTEGER", 1, dims, status );
+    datFind( loc, name, &ploc, status );
+    datPutI( ploc, 1, dims, values, status );
+    datAnnul( &ploc, status );
+  }
+  datAnnul( &loc, status );
+
+  /* Locate everything first so that only the mapping is timed */
+  hdsOpen( "hds_bench_map", "READ", &loc, status );
+  locs = calloc( NMAP, sizeof(*locs) );
+  for (i = 0; i < NMAP && *status == SAI__OK; i++) {
+    sprintf( name, "P%zu", i );
+    datFind( loc, name, &locs[i], status );
+  }
+
+  hdsGtune( "MAP", &oldmap, status );
+  for (usemmap = 1; usemmap >= 0 && *status == SAI__OK; usemmap--) {
+    hdsTune( "MAP", usemmap, status );
+    start = benchTime();
+    for (j = 0; j < scale; j++) {
+      for (i = 0; i < NMAP && *status == SAI__OK; i++) {
+        datMapI( locs[i], "READ", 1, dims, &pntr, status );
+        datUnmap( locs[i], status );
+      }
+    }
+    benchDone( "map_small", (usemmap ? "mmap" : "copy"), NMAP*scale,
+               NMAP*scale*sizeof(values), benchTime() - start, first,
+               status );
+  }
+  hdsTune( "MAP", oldmap, status );
+
+  for (i = 0; i < NMAP; i++) {
+    if (locs[i]) datAnnul( &locs[i], status );
+  }
+  free( locs );
+  datAnnul( &loc, status );
+
+  /* Reopen for update so that the file can be erased */
+  hdsOpen( "hds_bench_map", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Create a container file and close it again, then open it for read
+   and for update access and close it again, NCYCLE times each. The file
+   is closed by annulling its last locator, which is what hdsClose now
+   does. */
+static void benchOpenClose( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  hdsdim dims[] = { 0 };
+  const char *modes[] = { "READ", "UPDATE" };
+  const char *variants[] = { "open_read", "open_update" };
+  size_t n = NCYCLE*scale;
+  double start;
+  size_t i;
+  int m;
+
+  if (*status != SAI__OK) return;
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    hdsNew( "hds_bench_open", "BENCH", "BENCH", 0, dims, &loc, status );
+    datAnnul( &loc, status );
+  }
+  benchDone( "open_close", "new", n, 0, benchTime() - start, first, status );
+
+  for (m = 0; m < 2; m++) {
+    start = benchTime();
+    for (i = 0; i < n && *status == SAI__OK; i++) {
+      hdsOpen( "hds_bench_open", modes[m], &loc, status );
+      datAnnul( &loc, status );
+    }
+    benchDone( "open_close", variants[m], n, 0, benchTime() - start, first,
+               status );
+  }
+
+  hdsOpen( "hds_bench_open", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Locate components of a structure with NWIDE components, by name and
+   by index, follow a chain of NDEEP nested structures from the top NPASS
+   times, and locate each cell of an array of NCELL structures. */
+static void benchTree( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *wide = NULL;
+  HDSLoc *cells = NULL;
+  HDSLoc *cur = NULL;
+  HDSLoc *next = NULL;
+  HDSLoc *comp = NULL;
+  hdsdim dims[] = { NCELL };
+  hdsdim sub;
+  char (*names)[DAT__SZNAM+1] = NULL;
+  double start;
+  size_t i;
+  size_t j;
+
+  if (*status != SAI__OK) return;
+
+  names = malloc( NWIDE * sizeof(*names) );
+  if (!names) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate component names", status );
+    return;
+  }
+  for (i = 0; i < NWIDE; i++) sprintf( names[i], "C%zu", i );
+
+  hdsNew( "hds_bench_tree", "BENCH", "BENCH", 0, dims, &loc, status );
+
+  datNew( loc, "WIDE", "WIDE", 0, dims, status );
+  datFind( loc, "WIDE", &wide, status );
+  for (i = 0; i < NWIDE && *status == SAI__OK; i++) {
+    datNew0I( wide, names[i], status );
+  }
+  datAnnul( &wide, status );
+
+  datClone( loc, &cur, status );
+  for (i = 0; i < NDEEP && *status == SAI__OK; i++) {
+    datNew( cur, "LEVEL", "LEVEL", 0, dims, status );
+    datFind( cur, "LEVEL", &next, status );
+    datAnnul( &cur, status );
+    cur = next;
+    next = NULL;
+  }
+  if (cur) datAnnul( &cur, status );
+
+  datNew( loc, "CELLS", "CELL", 1, dims, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_tree", "READ", &loc, status );
+  datFind( loc, "WIDE", &wide, status );
+  datFind( loc, "CELLS", &cells, status );
+
+  start = benchTime();
+  for (j = 0; j < scale; j++) {
+    for (i = 0; i < NWIDE && *status == SAI__OK; i++) {
+      datFind( wide, names[i], &comp, status );
+      datAnnul( &comp, status );
+    }
+  }
+  benchDone( "find", "wide", NWIDE*scale, 0, benchTime() - start, first,
+             status );
+
+  start = benchTime();
+  for (j = 0; j < scale; j++) {
+    for (i = 0; i < NWIDE && *status == SAI__OK; i++) {
+      datIndex( wide, i + 1, &comp, status );
+      datAnnul( &comp, status );
+    }
+  }
+  benchDone( "index", "wide", NWIDE*scale, 0, benchTime() - start, first,
+             status );
+
+  start = benchTime();
+  for (j = 0; j < NPASS*scale; j++) {
+    datClone( loc, &cur, status );
+    for (i = 0; i < NDEEP && *status == SAI__OK; i++) {
+      datFind( cur, "LEVEL", &next, status );
+      datAnnul( &cur, status );
+      cur = next;
+      next = NULL;
+    }
+    if (cur) datAnnul( &cur, status );
+  }
+  benchDone( "find", "deep", NDEEP*NPASS*scale, 0, benchTime() - start, first,
+             status );
+
+  start = benchTime();
+  for (j = 0; j < scale; j++) {
+    for (i = 0; i < NCELL && *status == SAI__OK; i++) {
+      sub = i + 1;
+      datCell( cells, 1, &sub, &comp, status );
+      datAnnul( &comp, status );
+    }
+  }
+  benchDone( "cell", "array", NCELL*scale, 0, benchTime() - start, first,
+             status );
+
+  datAnnul( &cells, status );
+  datAnnul( &wide, status );
+  datAnnul( &loc, status );
+  free( names );
+
+  hdsOpen( "hds_bench_tree", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Write and read an _INTEGER scalar NSCALAR times each, using the same
+   type and using _DOUBLE so that each value has to be converted. */
+static void benchScalar( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *iloc = NULL;
+  hdsdim dims[] = { 0 };
+  size_t n = NSCALAR*scale;
+  double dval = 0.0;
+  double start;
+  int ival = 0;
+  size_t i;
+
+  if (*status != SAI__OK) return;
+
+  hdsNew( "hds_bench_scalar", "BENCH", "BENCH", 0, dims, &loc, status );
+  datNew0I( loc, "VALUE", status );
+  datFind( loc, "VALUE", &iloc, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datPut0I( iloc, (int)i, status );
+  }
+  benchDone( "put0", "native", n, n*sizeof(ival), benchTime() - start, first,
+             status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datPut0D( iloc, (double)i, status );
+  }
+  benchDone( "put0", "convert", n, n*sizeof(ival), benchTime() - start,
+             first, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datGet0I( iloc, &ival, status );
+  }
+  benchDone( "get0", "native", n, n*sizeof(ival), benchTime() - start, first,
+             status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datGet0D( iloc, &dval, status );
+  }
+  benchDone( "get0", "convert", n, n*sizeof(ival), benchTime() - start,
+             first, status );
+
+  datAnnul( &iloc, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_scalar", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Write, read and map a _REAL primitive with NLARGE elements NREPEAT
+   times each, using _REAL and using _DOUBLE so that each element has to
+   be converted. Mapping without conversion is timed both with the data
+   mapped directly from the file and with it copied into memory. */
+static void benchLarge( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  hdsdim dims[] = { NLARGE };
+  float *fbuf = NULL;
+  double *dbuf = NULL;
+  float *fpntr = NULL;
+  double *dpntr = NULL;
+  size_t n = NREPEAT*scale;
+  size_t nbytes = n * NLARGE * sizeof(*fbuf);
+  double start;
+  int oldmap = 1;
+  int usemmap;
+  size_t i;
+
+  if (*status != SAI__OK) return;
+
+  fbuf = malloc( NLARGE * sizeof(*fbuf) );
+  dbuf = malloc( NLARGE * sizeof(*dbuf) );
+  if (!fbuf || !dbuf) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate transfer buffers", status );
+    goto CLEANUP;
+  }
+  for (i = 0; i < NLARGE; i++) {
+    fbuf[i] = i;
+    dbuf[i] = i;
+  }
+
+  hdsNew( "hds_bench_large", "BENCH", "BENCH", 0, dims, &loc, status );
+  datNew( loc, "DATA", "_REAL", 1, dims, status );
+  datFind( loc, "DATA", &ploc, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datPutR( ploc, 1, dims, fbuf, status );
+  }
+  benchDone( "put", "native", n, nbytes, benchTime() - start, first, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datPutD( ploc, 1, dims, dbuf, status );
+  }
+  benchDone( "put", "convert", n, nbytes, benchTime() - start, first,
+             status );
+
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_large", "READ", &loc, status );
+  datFind( loc, "DATA", &ploc, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datGetR( ploc, 1, dims, fbuf, status );
+  }
+  benchDone( "get", "native", n, nbytes, benchTime() - start, first, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datGetD( ploc, 1, dims, dbuf, status );
+  }
+  benchDone( "get", "convert", n, nbytes, benchTime() - start, first,
+             status );
+
+  hdsGtune( "MAP", &oldmap, status );
+  for (usemmap = 1; usemmap >= 0 && *status == SAI__OK; usemmap--) {
+    hdsTune( "MAP", usemmap, status );
+    start = benchTime();
+    for (i = 0; i < n && *status == SAI__OK; i++) {
+      datMapR( ploc, "READ", 1, dims, &fpntr, status );
+      datUnmap( ploc, status );
+    }
+    benchDone( "map", (usemmap ? "mmap" : "copy"), n, nbytes,
+               benchTime() - start, first, status );
+  }
+  hdsTune( "MAP", oldmap, status );
+
+  start = benchTime();
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    datMapD( ploc, "READ", 1, dims, &dpntr, status );
+    datUnmap( ploc, status );
+  }
+  benchDone( "map", "convert", n, nbytes, benchTime() - start, first,
+             status );
+
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_large", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+
+ CLEANUP:
+  free( fbuf );
+  free( dbuf );
+}
+
+/* Read a 2-D _WORD image of NIMAGE by NIMAGE elements as _REAL values
+   NREPEAT times, with each of the transfer buffer sizes in conv_nblocks.
+   Then read it in slices of NSTRIP whole columns, each of which is made
+   of NIMAGE separate pieces of the file, with the default and with a
+   larger number of pieces handled at once (see the HYPERVEC tuning
+   parameter). */
+static void benchConvert( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  HDSLoc *slice = NULL;
+  hdsdim dims[] = { NIMAGE, NIMAGE };
+  hdsdim sdims[] = { NSTRIP, NIMAGE };
+  hdsdim lower[2];
+  hdsdim upper[2];
+  short *wbuf = NULL;
+  float *fbuf = NULL;
+  size_t npix = (size_t)NIMAGE * NIMAGE;
+  size_t n = NREPEAT*scale;
+  double start;
+  int oldnblocks = 0;
+  int oldhypervec = 0;
+  int hypervec;
+  int iconv;
+  size_t i;
+  size_t j;
+
+  if (*status != SAI__OK) return;
+
+  wbuf = malloc( npix * sizeof(*wbuf) );
+  fbuf = malloc( npix * sizeof(*fbuf) );
+  if (!wbuf || !fbuf) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate transfer buffers", status );
+    goto CLEANUP;
+  }
+  for (i = 0; i < npix; i++) wbuf[i] = i % 32768;
+
+  hdsNew( "hds_bench_convert", "BENCH", "BENCH", 0, dims, &loc, status );
+  datNew( loc, "DATA", "_WORD", 2, dims, status );
+  datFind( loc, "DATA", &ploc, status );
+  datPutW( ploc, 2, dims, wbuf, status );
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_convert", "READ", &loc, status );
+  datFind( loc, "DATA", &ploc, status );
+
+  hdsGtune( "NBLOCKS", &oldnblocks, status );
+  for (iconv = 0; iconv < NCONV && *status == SAI__OK; iconv++) {
+    hdsTune( "NBLOCKS", conv_nblocks[iconv], status );
+    start = benchTime();
+    for (i = 0; i < n && *status == SAI__OK; i++) {
+      datGetR( ploc, 2, dims, fbuf, status );
+    }
+    benchDone( "get_word_real", conv_variants[iconv], n,
+               n * npix * sizeof(*fbuf), benchTime() - start, first, status );
+  }
+  hdsTune( "NBLOCKS", oldnblocks, status );
+
+  hdsGtune( "HYPERVEC", &oldhypervec, status );
+  for (hypervec = 0; hypervec <= NIMAGE && *status == SAI__OK;
+       hypervec += NIMAGE) {
+    hdsTune( "HYPERVEC", hypervec, status );
+    start = benchTime();
+    for (i = 0; i < n && *status == SAI__OK; i++) {
+      for (j = 0; j < NIMAGE/NSTRIP && *status == SAI__OK; j++) {
+        lower[0] = j*NSTRIP + 1;
+        upper[0] = (j + 1)*NSTRIP;
+        lower[1] = 1;
+        upper[1] = NIMAGE;
+        datSlice( ploc, 2, lower, upper, &slice, status );
+        datGetR( slice, 2, sdims, fbuf, status );
+        datAnnul( &slice, status );
+      }
+    }
+    benchDone( "get_word_real_strip",
+               (hypervec ? "hypervec_image" : "hypervec_default"),
+               n*(NIMAGE/NSTRIP), n * npix * sizeof(*fbuf),
+               benchTime() - start, first, status );
+  }
+  hdsTune( "HYPERVEC", oldhypervec, status );
+
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_convert", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+
+ CLEANUP:
+  free( wbuf );
+  free( fbuf );
+}
+
+/* Write and read a 2-D _REAL image of NIMAGE by NIMAGE elements stored in
+   chunks of CHUNKIO_KIB, uncompressed and compressed, NREPEAT times each.
+   The chunks are transferred by HDF5, directly by the calling thread
+   alone and directly using up to "maxthreads" threads (see the CHUNKIO
+   tuning parameter). */
+static void benchChunkIO( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  hdsdim dims[] = { NIMAGE, NIMAGE };
+  float *fbuf = NULL;
+  size_t npix = (size_t)NIMAGE * NIMAGE;
+  size_t n = NREPEAT*scale;
+  size_t nbytes = n * npix * sizeof(*fbuf);
+  double start;
+  int nthreads[3];
+  int oldchunk = 0;
+  int oldcompress = 0;
+  int oldchunkio = 0;
+  int ilevel;
+  int imode;
+  size_t i;
+
+  if (*status != SAI__OK) return;
+
+  fbuf = malloc( npix * sizeof(*fbuf) );
+  if (!fbuf) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate transfer buffer", status );
+    return;
+  }
+
+  /* A smooth image with some noise, so that it compresses moderately */
+  for (i = 0; i < npix; i++) {
+    fbuf[i] = (float)(i % NIMAGE) + (float)((i * 2654435761u) % 1000) / 1000;
+  }
+
+  nthreads[0] = 0;
+  nthreads[1] = 1;
+  nthreads[2] = maxthreads;
+
+  hdsGtune( "CHUNK", &oldchunk, status );
+  hdsGtune( "COMPRESS", &oldcompress, status );
+  hdsGtune( "CHUNKIO", &oldchunkio, status );
+
+  for (ilevel = 0; ilevel < NCHUNKIO && *status == SAI__OK; ilevel++) {
+    hdsTune( "CHUNK", CHUNKIO_KIB, status );
+    hdsTune( "COMPRESS", chunkio_levels[ilevel], status );
+    hdsNew( "hds_bench_chunkio", "BENCH", "BENCH", 0, dims, &loc, status );
+    datNew( loc, "DATA", "_REAL", 2, dims, status );
+    hdsTune( "CHUNK", oldchunk, status );
+    hdsTune( "COMPRESS", oldcompress, status );
+    datFind( loc, "DATA", &ploc, status );
+
+    for (imode = 0; imode < 3 && *status == SAI__OK; imode++) {
+      hdsTune( "CHUNKIO", nthreads[imode], status );
+
+      start = benchTime();
+      for (i = 0; i < n && *status == SAI__OK; i++) {
+        datPutR( ploc, 2, dims, fbuf, status );
+      }
+      benchDone( "put_chunked", chunkio_variants[ilevel][imode], n, nbytes,
+                 benchTime() - start, first, status );
+
+      start = benchTime();
+      for (i = 0; i < n && *status == SAI__OK; i++) {
+        datGetR( ploc, 2, dims, fbuf, status );
+      }
+      benchDone( "get_chunked", chunkio_variants[ilevel][imode], n, nbytes,
+                 benchTime() - start, first, status );
+    }
+
+    datAnnul( &ploc, status );
+    datAnnul( &loc, status );
+    hdsOpen( "hds_bench_chunkio", "UPDATE", &loc, status );
+    hdsErase( &loc, status );
+  }
+
+  hdsTune( "CHUNKIO", oldchunkio, status );
+  free( fbuf );
+}
+
+/* Read a 2-D _REAL array of NROW by NROW elements one row at a time and
+   one column at a time through slices, and through a vectorised locator
+   both in NROW chunks and all at once. */
+static void benchSlice( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  HDSLoc *vec = NULL;
+  HDSLoc *slice = NULL;
+  hdsdim dims[] = { NROW, NROW };
+  hdsdim vdims[] = { NROW*NROW };
+  hdsdim lower[2];
+  hdsdim upper[2];
+  hdsdim sdims[2];
+  float *buf = NULL;
+  size_t rowbytes = NROW * sizeof(*buf);
+  double start;
+  size_t i;
+  size_t j;
+
+  if (*status != SAI__OK) return;
+
+  buf = malloc( NROW * NROW * sizeof(*buf) );
+  if (!buf) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate transfer buffer", status );
+    return;
+  }
+  for (i = 0; i < NROW*NROW; i++) buf[i] = i;
+
+  hdsNew( "hds_bench_slice", "BENCH", "BENCH", 0, dims, &loc, status );
+  datNew( loc, "DATA", "_REAL", 2, dims, status );
+  datFind( loc, "DATA", &ploc, status );
+  datPutR( ploc, 2, dims, buf, status );
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_slice", "READ", &loc, status );
+  datFind( loc, "DATA", &ploc, status );
+
+  /* Rows are contiguous in the file */
+  start = benchTime();
+  for (j = 0; j < scale; j++) {
+    for (i = 0; i < NROW && *status == SAI__OK; i++) {
+      lower[0] = 1;
+      upper[0] = NROW;
+      lower[1] = upper[1] = i + 1;
+      sdims[0] = NROW;
+      sdims[1] = 1;
+      datSlice( ploc, 2, lower, upper, &slice, status );
+      datGetR( slice, 2, sdims, buf, status );
+      datAnnul( &slice, status );
+    }
+  }
+  benchDone( "slice", "row", NROW*scale, NROW*scale*rowbytes,
+             benchTime() - start, first, status );
+
+  /* Columns are strided */
+  start = benchTime();
+  for (j = 0; j < scale; j++) {
+    for (i = 0; i < NROW && *status == SAI__OK; i++) {
+      lower[0] = upper[0] = i + 1;
+      lower[1] = 1;
+      upper[1] = NROW;
+      sdims[0] = 1;
+      sdims[1] = NROW;
+      datSlice( ploc, 2, lower, upper, &slice, status );
+      datGetR( slice, 2, sdims, buf, status );
+      datAnnul( &slice, status );
+    }
+  }
+  benchDone( "slice", "column", NROW*scale, NROW*scale*rowbytes,
+             benchTime() - start, first, status );
+
+  start = benchTime();
+  for (j = 0; j < scale; j++) {
+    datVec( ploc, &vec, status );
+    for (i = 0; i < NROW && *status == SAI__OK; i++) {
+      lower[0] = i*NROW + 1;
+      upper[0] = (i + 1)*NROW;
+      sdims[0] = NROW;
+      datSlice( vec, 1, lower, upper, &slice, status );
+      datGetR( slice, 1, sdims, buf, status );
+      datAnnul( &slice, status );
+    }
+    datAnnul( &vec, status );
+  }
+  benchDone( "vec", "chunk", NROW*scale, NROW*scale*rowbytes,
+             benchTime() - start, first, status );
+
+  start = benchTime();
+  for (j = 0; j < scale && *status == SAI__OK; j++) {
+    datVec( ploc, &vec, status );
+    datGetR( vec, 1, vdims, buf, status );
+    datAnnul( &vec, status );
+  }
+  benchDone( "vec", "whole", scale, NROW*scale*rowbytes,
+             benchTime() - start, first, status );
+
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+  free( buf );
+
+  hdsOpen( "hds_bench_slice", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Copy a structure holding 100 small primitives, and a single large
+   primitive, to a new component of the same container NCOPY times each.
+   Erasing each copy is not timed. */
+static void benchCopy( int *first, int *status ) {
+  HDSLoc *loc = NULL;
+  HDSLoc *src = NULL;
+  HDSLoc *ploc = NULL;
+  hdsdim dims[] = { 1000 };
+  hdsdim ldims[] = { NLARGE/4 };
+  double values[1000];
+  float *pntr = NULL;
+  char name[DAT__SZNAM+1];
+  size_t n = NCOPY*scale;
+  double seconds;
+  double start;
+  size_t i;
+
+  if (*status != SAI__OK) return;
+
+  for (i = 0; i < 1000; i++) values[i] = i;
+
+  hdsNew( "hds_bench_copy", "BENCH", "BENCH", 0, dims, &loc, status );
+  datNew( loc, "STRUC", "STRUC", 0, dims, status );
+  datFind( loc, "STRUC", &src, status );
+  for (i = 0; i < 100 && *status == SAI__OK; i++) {
+    sprintf( name, "D%zu", i );
+    datNew( src, name, "_DOUBLE", 1, dims, status );
+    datFind( src, name, &ploc, status );
+    datPutD( ploc, 1, dims, values, status );
+    datAnnul( &ploc, status );
+  }
+
+  /* The primitive is given values so that there is data to copy */
+  datNew( loc, "PRIM", "_REAL", 1, ldims, status );
+  datFind( loc, "PRIM", &ploc, status );
+  datMapR( ploc, "WRITE", 1, ldims, &pntr, status );
+  if (*status == SAI__OK) {
+    for (i = 0; i < ldims[0]; i++) pntr[i] = i;
+  }
+  datUnmap( ploc, status );
+
+  seconds = 0.0;
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    start = benchTime();
+    datCopy( src, loc, "COPY", status );
+    seconds += benchTime() - start;
+    datErase( loc, "COPY", status );
+  }
+  benchDone( "copy", "structure", n, n*sizeof(values)*100, seconds, first,
+             status );
+
+  seconds = 0.0;
+  for (i = 0; i < n && *status == SAI__OK; i++) {
+    start = benchTime();
+    datCopy( ploc, loc, "COPY", status );
+    seconds += benchTime() - start;
+    datErase( loc, "COPY", status );
+  }
+  benchDone( "copy", "primitive", n, n*ldims[0]*sizeof(float), seconds,
+             first, status );
+
+  datAnnul( &ploc, status );
+  datAnnul( &src, status );
+  datAnnul( &loc, status );
+
+  hdsOpen( "hds_bench_copy", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Read the same container from NREADER threads at once, each opening
+   the file itself and reading NREAD elements NREPEAT times. */
+static void benchReaders( int *first, int *status ) {
+  BenchResult result;
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  pthread_t threads[NREADER];
+  ReaderData tdata[NREADER];
+  hdsdim dims[] = { NREAD };
+  float *buf = NULL;
+  double start;
+  int lockwait;
+  int i;
+
+  if (*status != SAI__OK) return;
+
+  buf = calloc( NREAD, sizeof(*buf) );
+  if (!buf) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate transfer buffer", status );
+    return;
+  }
+
+  hdsNew( "hds_bench_read", "BENCH", "BENCH", 0, dims, &loc, status );
+  datNew( loc, "DATA", "_REAL", 1, dims, status );
+  datFind( loc, "DATA", &ploc, status );
+  datPutR( ploc, 1, dims, buf, status );
+  datAnnul( &ploc, status );
+  datAnnul( &loc, status );
+  free( buf );
+  if (*status != SAI__OK) return;
+
+  lockwait = benchLockWait( status );
+  start = benchTime();
+  for (i = 0; i < NREADER; i++) {
+    tdata[i].path = "hds_bench_read";
+    tdata[i].nrepeat = NREPEAT*scale;
+    tdata[i].status = SAI__OK;
+    pthread_create( &threads[i], NULL, benchReader, &tdata[i] );
+  }
+  for (i = 0; i < NREADER; i++) pthread_join( threads[i], NULL );
+  for (i = 0; i < NREADER; i++) {
+    if (tdata[i].status != SAI__OK && *status == SAI__OK) {
+      *status = tdata[i].status;
+      emsRepf( "", "hdsBench: Reader thread %d failed", status, i );
+    }
+  }
+  result.seconds = benchTime() - start;
+  result.name = "read_threads";
+  result.variant = "open_per_thread";
+  result.nops = NREADER*NREPEAT*scale;
+  result.nbytes = result.nops*NREAD*sizeof(float);
+  result.nthread = NREADER;
+  result.lockwait = benchLockWait( status ) - lockwait;
+  if (*status == SAI__OK) benchReport( &result, first );
+
+  hdsOpen( "hds_bench_read", "UPDATE", &loc, status );
+  hdsErase( &loc, status );
+}
+
+/* Body of each thread run by benchReaders */
+static void *benchReader( void *data ) {
+  ReaderData *tdata = data;
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  hdsdim dims[] = { NREAD };
+  float *buf = NULL;
+  size_t i;
+  int status = SAI__OK;
+
+  buf = malloc( NREAD * sizeof(*buf) );
+  if (!buf) {
+    tdata->status = DAT__NOMEM;
+    return NULL;
+  }
+
+  hdsOpen( tdata->path, "READ", &loc, &status );
+  datFind( loc, "DATA", &ploc, &status );
+  for (i = 0; i < tdata->nrepeat && status == SAI__OK; i++) {
+    datGetR( ploc, 1, dims, buf, &status );
+  }
+  datAnnul( &ploc, &status );
+  datAnnul( &loc, &status );
+
+  free( buf );
+  tdata->status = status;
+  return NULL;
+}
+
+/* Run NLOCKOP cycles of locking a top-level object, locating and reading
+   a small primitive inside it and unlocking it again, in 1, 2, 4 ... up to
+   "maxthreads" threads at once. Each thread count is run first with all
+   threads sharing one container opened for read access, which they lock
+   for read-only access, and then with each thread using its own container
+   opened for update, which it locks for read/write access. */
+static void benchLockScaling( int *first, int *status ) {
+  BenchResult result;
+  HDSLoc *shared = NULL;
+  HDSLoc **private = NULL;
+  HDSLoc *ploc = NULL;
+  pthread_t *threads = NULL;
+  LockData *tdata = NULL;
+  hdsdim dims[] = { NLOCKREAD };
+  float values[NLOCKREAD];
+  char path[40];
+  double start;
+  int lockwait;
+  int nthread;
+  int useshared;
+  int i;
+
+  if (*status != SAI__OK) return;
+
+  for (i = 0; i < NLOCKREAD; i++) values[i] = i;
+
+  private = calloc( maxthreads, sizeof(*private) );
+  threads = calloc( maxthreads, sizeof(*threads) );
+  tdata = calloc( maxthreads, sizeof(*tdata) );
+  if (!private || !threads || !tdata) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate thread data", status );
+    goto CLEANUP;
+  }
+
+  /* One container for each thread plus the shared one, which is the last.
+     Each is left open and unlocked so that any thread can lock it. */
+  for (i = 0; i <= maxthreads && *status == SAI__OK; i++) {
+    HDSLoc *loc = NULL;
+    sprintf( path, "hds_bench_lock%d", i );
+    hdsNew( path, "BENCH", "BENCH", 0, dims, &loc, status );
+    datNew( loc, "DATA", "_REAL", 1, dims, status );
+    datFind( loc, "DATA", &ploc, status );
+    datPutR( ploc, 1, dims, values, status );
+    datAnnul( &ploc, status );
+    datAnnul( &loc, status );
+
+    hdsOpen( path, (i < maxthreads ? "UPDATE" : "READ"), &loc, status );
+    datUnlock( loc, 1, status );
+    if (i < maxthreads) {
+      private[i] = loc;
+    } else {
+      shared = loc;
+    }
+  }
+
+  for (nthread = 1; *status == SAI__OK; nthread *= 2) {
+    if (nthread > maxthreads) nthread = maxthreads;
+
+    for (useshared = 1; useshared >= 0 && *status == SAI__OK; useshared--) {
+      lockwait = benchLockWait( status );
+      start = benchTime();
+      for (i = 0; i < nthread; i++) {
+        tdata[i].loc = (useshared ? shared : private[i]);
+        tdata[i].readonly = useshared;
+        tdata[i].nop = NLOCKOP*scale;
+        tdata[i].status = SAI__OK;
+        pthread_create( &threads[i], NULL, benchLocker, &tdata[i] );
+      }
+      for (i = 0; i < nthread; i++) pthread_join( threads[i], NULL );
+      result.seconds = benchTime() - start;
+
+      for (i = 0; i < nthread; i++) {
+        if (tdata[i].status != SAI__OK && *status == SAI__OK) {
+          *status = tdata[i].status;
+          emsRepf( "", "hdsBench: Locking thread %d failed", status, i );
+        }
+      }
+
+      result.name = "lock_scaling";
+      result.variant = (useshared ? "shared_read" : "private_update");
+      result.nops = nthread*NLOCKOP*scale;
+      result.nbytes = result.nops*sizeof(values);
+      result.nthread = nthread;
+      result.lockwait = benchLockWait( status ) - lockwait;
+      if (*status == SAI__OK) benchReport( &result, first );
+    }
+
+    if (nthread == maxthreads) break;
+  }
+
+  /* Lock the containers again so that they can be closed and erased */
+  for (i = 0; i <= maxthreads; i++) {
+    HDSLoc *loc = (i < maxthreads ? private[i] : shared);
+    if (!loc) continue;
+    datLock( loc, 1, 0, status );
+    datAnnul( &loc, status );
+    sprintf( path, "hds_bench_lock%d", i );
+    hdsOpen( path, "UPDATE", &loc, status );
+    hdsErase( &loc, status );
+  }
+
+ CLEANUP:
+  free( private );
+  free( threads );
+  free( tdata );
+}
+
+/* Body of each thread run by benchLockScaling */
+static void *benchLocker( void *data ) {
+  LockData *tdata = data;
+  HDSLoc *ploc = NULL;
+  hdsdim dims[] = { NLOCKREAD };
+  float values[NLOCKREAD];
+  size_t i;
+  int status = SAI__OK;
+
+  for (i = 0; i < tdata->nop && status == SAI__OK; i++) {
+    datLock( tdata->loc, 1, tdata->readonly, &status );
+    datFind( tdata->loc, "DATA", &ploc, &status );
+    datGetR( ploc, 1, dims, values, &status );
+    datAnnul( &ploc, &status );
+    datUnlock( tdata->loc, 1, &status );
+  }
+
+  tdata->status = status;
+  return NULL;
+}
+
+/* Total time in microseconds that threads have spent waiting for objects
+   locked by other threads */
+static int benchLockWait( int *status ) {
+  int result = 0;
+  hdsInfoI( NULL, "LOCKWAIT", NULL, &result, status );
+  return result;
+}
+
+/* Read arrays of increasing size up to "maxmb" MiB, stored with each of
+   the chunk sizes in "io_chunks", using each access pattern and method.
+   Then report the tuning parameters that give the shortest total time
+   over all patterns for the largest array, and write them to the file
+   "profile" if it is not NULL. */
+static void benchIOSweep( int maxmb, const char *profile, int *first,
+                          int *status ) {
+  BenchResult result;
+  HDSLoc *loc = NULL;
+  HDSLoc *ploc = NULL;
+  HDSLoc *slice = NULL;
+  FILE *fd = NULL;
+  hdsdim dims[3];
+  hdsdim lower[3];
+  hdsdim upper[3];
+  float *buf = NULL;
+  double rates[NIOCHUNK][NIOPATTERN][NIOMETHOD];
+  double score;
+  double best = -1.0;
+  double maptime[2];
+  char variant[80];
+  int oldchunk = 0;
+  int oldmap = 1;
+  int bestchunk = 0;
+  int bestmap = 1;
+  int mb;
+  int c;
+  int p;
+  int m;
+  hdsdim k;
+  size_t i;
+
+  if (*status != SAI__OK) return;
+
+  /* Big enough for NSEQPLANE planes, and initialised to a ramp */
+  buf = malloc( (size_t)NSEQPLANE * NPLANE * NPLANE * sizeof(*buf) );
+  if (!buf) {
+    *status = DAT__NOMEM;
+    emsRep( "", "hdsBench: Unable to allocate transfer buffer", status );
+    return;
+  }
+  for (i = 0; i < (size_t)NSEQPLANE * NPLANE * NPLANE; i++) buf[i] = i;
+
+  hdsGtune( "CHUNK", &oldchunk, status );
+  hdsGtune( "MAP", &oldmap, status );
+  memset( rates, 0, sizeof(rates) );
+
+  for (mb = 1; *status == SAI__OK; mb *= 4) {
+    if (mb > maxmb) mb = maxmb;
+
+    /* Four planes per MiB */
+    dims[0] = NPLANE;
+    dims[1] = NPLANE;
+    dims[2] = 4 * (hdsdim)mb;
+
+    for (c = 0; c < NIOCHUNK && *status == SAI__OK; c++) {
+
+      /* Skip chunks that would hold the whole array */
+      if (io_chunks[c] >= 1024*mb) continue;
+
+      hdsTune( "CHUNK", io_chunks[c], status );
+      hdsNew( "hds_bench_io", "BENCH", "BENCH", 0, dims, &loc, status );
+      datNew( loc, "DATA", "_REAL", 3, dims, status );
+      hdsTune( "CHUNK", oldchunk, status );
+      datFind( loc, "DATA", &ploc, status );
+
+      /* Write one plane at a time so that arrays larger than memory can
+         be used */
+      for (k = 1; k <= dims[2] && *status == SAI__OK; k++) {
+        lower[0] = lower[1] = 1;
+        upper[0] = upper[1] = NPLANE;
+        lower[2] = upper[2] = k;
+        datSlice( ploc, 3, lower, upper, &slice, status );
+        upper[2] = 1;
+        datPutR( slice, 3, upper, buf, status );
+        datAnnul( &slice, status );
+      }
+      datAnnul( &ploc, status );
+      datAnnul( &loc, status );
+
+      hdsOpen( "hds_bench_io", "READ", &loc, status );
+      datFind( loc, "DATA", &ploc, status );
+
+      for (p = 0; p < NIOPATTERN && *status == SAI__OK; p++) {
+        for (m = 0; m < NIOMETHOD && *status == SAI__OK; m++) {
+          result.seconds = benchIORead( ploc, dims[2], p, m, buf, status );
+          sprintf( variant, "%s,chunk_kb=%d,size_mb=%d", io_methods[m],
+                   io_chunks[c], mb );
+          result.name = io_patterns[p];
+          result.variant = variant;
+          result.nops = (p == 0 ? (dims[2] + NSEQPLANE - 1) / NSEQPLANE :
+                         (p == 1 ? dims[2] :
+                          dims[2] * (NPLANE / NTILE) * (NPLANE / NTILE)));
+          result.nbytes = (size_t)dims[2] * NPLANE * NPLANE * sizeof(*buf);
+          result.nthread = 1;
+          result.lockwait = -1.0;
+          if (*status == SAI__OK) {
+            benchReport( &result, first );
+            rates[c][p][m] = (result.seconds > 0.0 ?
+                              1.0E-6 * result.nbytes / result.seconds : 0.0);
+          }
+        }
+      }
+
+      datAnnul( &ploc, status );
+      datAnnul( &loc, status );
+      hdsOpen( "hds_bench_io", "UPDATE", &loc, status );
+      hdsErase( &loc, status );
+    }
+
+    if (mb == maxmb) break;
+  }
+
+  hdsTune( "MAP", oldmap, status );
+
+  /* "rates" now holds the results for the largest array. Choose the
+     chunk size that reads a MB with each pattern in the shortest total
+     time, using the fastest method for each pattern since the method is
+     chosen by the application rather than by tuning. Then choose whether
+     to map from the file by comparing the times for mmap and copy with
+     that chunk size. */
+  for (c = 0; c < NIOCHUNK; c++) {
+    score = 0.0;
+    for (p = 0; p < NIOPATTERN; p++) {
+      double fastest = 0.0;
+      for (m = 0; m < NIOMETHOD; m++) {
+        if (rates[c][p][m] > fastest) fastest = rates[c][p][m];
+      }
+      if (fastest <= 0.0) break;
+      score += 1.0 / fastest;
+    }
+    if (p == NIOPATTERN && (best < 0.0 || score < best)) {
+      best = score;
+      bestchunk = io_chunks[c];
+      maptime[0] = maptime[1] = 0.0;
+      for (p = 0; p < NIOPATTERN; p++) {
+        maptime[0] += 1.0 / rates[c][p][2];
+        maptime[1] += 1.0 / rates[c][p][1];
+      }
+      bestmap = (maptime[1] <= maptime[0]);
+    }
+  }
+
+  if (*status == SAI__OK) {
+    printf( "%s\n  {\"name\": \"recommendation\", \"size_mb\": %d, "
+            "\"MAP\": %d, \"CHUNK\": %d}", (*first ? "" : ","), maxmb,
+            bestmap, bestchunk );
+    *first = 0;
+
+    if (profile) {
+      fd = fopen( profile, "w" );
+      if (fd) {
+        fprintf( fd, "# HDS tuning parameters recommended by hdsBench io "
+                 "for arrays of %d MiB\n", maxmb );
+        fprintf( fd, "MAP = %d\nCHUNK = %d\n", bestmap, bestchunk );
+        fclose( fd );
+      } else {
+        *status = DAT__FILCR;
+        emsRepf( "", "hdsBench: Unable to write tuning file %s", status,
+                 profile );
+      }
+    }
+  }
+
+  free( buf );
+}
+
+/* Read the whole of the 3-D array "loc", which has "nz" planes, using
+   access pattern "pattern" and method "method" (indices into io_patterns
+   and io_methods). Every page of the data is looked at, so that mapped
+   data is actually read. Returns the elapsed time. */
+static double benchIORead( HDSLoc *loc, hdsdim nz, int pattern, int method,
+                           float *buf, int *status ) {
+  HDSLoc *slice = NULL;
+  hdsdim lower[3];
+  hdsdim upper[3];
+  hdsdim sdims[3];
+  hdsdim k;
+  float *pntr = NULL;
+  float *data;
+  double start;
+  double sum = 0.0;
+  size_t ntile = 0;
+  size_t nslice;
+  size_t nel;
+  size_t i;
+  size_t t;
+
+  if (*status != SAI__OK) return 0.0;
+
+  if (method > 0) hdsTune( "MAP", (method == 1), status );
+
+  /* The same tiles are read every time */
+  srand( 1 );
+  if (pattern == 0) {
+    nslice = (nz + NSEQPLANE - 1) / NSEQPLANE;
+  } else if (pattern == 1) {
+    nslice = nz;
+  } else {
+    ntile = (NPLANE / NTILE) * (NPLANE / NTILE);
+    nslice = nz * ntile;
+  }
+
+  start = benchTime();
+  for (t = 0; t < nslice && *status == SAI__OK; t++) {
+    if (pattern == 0) {
+      k = t * NSEQPLANE + 1;
+      lower[0] = lower[1] = 1;
+      upper[0] = upper[1] = NPLANE;
+      lower[2] = k;
+      upper[2] = (k + NSEQPLANE - 1 < nz ? k + NSEQPLANE - 1 : nz);
+    } else if (pattern == 1) {
+      lower[0] = lower[1] = 1;
+      upper[0] = upper[1] = NPLANE;
+      lower[2] = upper[2] = t + 1;
+    } else {
+      lower[0] = 1 + NTILE * (rand() % (NPLANE / NTILE));
+      lower[1] = 1 + NTILE * (rand() % (NPLANE / NTILE));
+      lower[2] = upper[2] = 1 + rand() % nz;
+      upper[0] = lower[0] + NTILE - 1;
+      upper[1] = lower[1] + NTILE - 1;
+    }
+    sdims[0] = upper[0] - lower[0] + 1;
+    sdims[1] = upper[1] - lower[1] + 1;
+    sdims[2] = upper[2] - lower[2] + 1;
+    nel = sdims[0] * sdims[1] * sdims[2];
+
+    datSlice( loc, 3, lower, upper, &slice, status );
+    if (method == 0) {
+      datGetR( slice, 3, sdims, buf, status );
+      data = buf;
+    } else {
+      datMapR( slice, "READ", 3, sdims, &pntr, status );
+      data = pntr;
+    }
+    if (*status == SAI__OK) {
+      for (i = 0; i < nel; i += 1024) sum += data[i];
+    }
+    if (method > 0) datUnmap( slice, status );
+    datAnnul( &slice, status );
+  }
+
+  /* Stop the compiler discarding the loop that looks at the data */
+  if (sum < 0.0) printf( " " );
+
+  return benchTime() - start;
+}
@@ -18,8 +18,8 @@
 
 *  Arguments:
 *     loc = const HDSLoc* (Given)
-*        HDS locator, if required by the particular topic. Will be
-*        ignored for FILES and LOCATORS topics and can be NULL pointer.
+*        HDS locator, if required by the particular topic. It is only
+*        used by the VERSION topic and can otherwise be a NULL pointer.
 *     topic = const char * (Given)
 *        Topic on which information is to be obtained. Allowed values are:
 *        - LOCATORS : Return the number of active locators.
@@ -29,6 +29,31 @@
 *        - FILES : Return the number of open files
 *        - VERSION : Return the HDS implementation version number for the
 *                    supplied HDS locator.
+*        - HUGEPAGES : Return the number of mapped buffers currently
+*                      backed by huge pages (see hdsTune).
+*        - STATS : Write the call counts and timings gathered since
+*                  the STATS tuning parameter was set (see hdsTune) to
+*                  standard output, and return the total number of calls
+*                  counted. If EXTRA is "RESET" the counts are then set
+*                  back to zero.
+*        - HANDLES : Return the number of internal object Handles in
+*                    existence.
+*        - IDS : Return the number of open HDF5 identifiers.
+*        - MAPPED : Return the number of bytes currently mapped by
+*                   datMap, whether from the file or by copying.
+*        - MMAPS : Return the number of primitives that have been mapped
+*                  directly from the file.
+*        - COPYMAPS : Return the number of primitives that have been
+*                     mapped by copying the data into memory.
+*        - CONVERSIONS : Return the number of data elements that have
+*                        been converted from one type to another when
+*                        read or written. If EXTRA is two comma
+*                        separated HDS types (e.g. "_INTEGER,_REAL")
+*                        only conversions from the first to the second
+*                        are counted.
+*        - LOCKWAIT : Return the total time in microseconds that threads
+*                     have spent waiting for access to HDS objects held
+*                     by other threads.
 *     extra = const char * (Given)
 *        Extra options to control behaviour. The content depends on
 *        the particular TOPIC. See NOTES for more information.
@@ -67,6 +92,8 @@
 *    - Top-level scratch locators such as "HDS_SCRATCH.TEMP_N" are not
 *      included in the "LOCATORS" count but children of the temp locators
 *      are included (since those temporary items should be freed).
+*    - Values too large for an int are returned as the largest int. See
+*      hdsMetrics for a way to obtain all the run time metrics at once.
 
 *  History:
 *     2014-10-17 (TIMJ):
@@ -118,6 +145,7 @@
 
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 
 #include "ems.h"
 #include "sae_par.h"
@@ -131,6 +159,9 @@
 /* Maximum number of filters that we can supply */
 #define MAXCOMP 20
 
+/* Return a count as an int, limited to the largest int */
+#define CLAMPINT(value) ( (value) > INT_MAX ? INT_MAX : (int)(value) )
+
 int
 hdsInfoI(const HDSLoc* loc, const char *topic_str, const char *extra,
 	 int *result, int  *status) {
@@ -141,6 +172,87 @@ hdsInfoI(const HDSLoc* loc, const char *topic_str, const char *extra,
     *result = loc->hds_version;
   } else if (strncasecmp(topic_str, "FIL", 3) == 0) {
     *result = hds1CountFiles();
+  } else if (strncasecmp(topic_str, "HUGE", 4) == 0) {
+    *result = hds1HugeCount();
+  } else if (strncasecmp(topic_str, "STAT", 4) == 0) {
+    *result = hds1StatsShow( extra && strncasecmp( extra, "RESET", 5 ) == 0 );
+  } else if (strncasecmp(topic_str, "HAND", 4) == 0 ||
+             strncasecmp(topic_str, "MAPP", 4) == 0 ||
+             strncasecmp(topic_str, "MMAP", 4) == 0 ||
+             strncasecmp(topic_str, "COPY", 4) == 0 ||
+             strncasecmp(topic_str, "LOCK", 4) == 0 ) {
+    HdsMetrics metrics;
+    hds1MetricsCopy( &metrics );
+    switch (toupper(topic_str[0])) {
+    case 'H':
+      *result = CLAMPINT( metrics.nhandle );
+      break;
+    case 'M':
+      if (toupper(topic_str[1]) == 'A') {
+        *result = CLAMPINT( metrics.bytes_mmap + metrics.bytes_copymap );
+      } else {
+        *result = CLAMPINT( metrics.nmmap );
+      }
+      break;
+    case 'C':
+      *result = CLAMPINT( metrics.ncopymap );
+      break;
+    default:
+      *result = CLAMPINT( metrics.lockwait_ns / 1000 );
+    }
+  } else if (strncasecmp(topic_str, "CONV", 4) == 0) {
+    HdsMetrics metrics;
+    hdstype_t from = HDSTYPE_NONE;
+    hdstype_t to = HDSTYPE_NONE;
+    size_t total = 0;
+    size_t i, j;
+
+    /* Decode any pair of types */
+    if (extra && strchr( extra, ',' )) {
+      char typestr[DAT__SZTYP+1];
+      char normtypestr[DAT__SZTYP+1];
+      const char *comma = strchr( extra, ',' );
+      size_t len = comma - extra;
+      hid_t h5type = 0;
+      int k;
+
+      for (k = 0; k < 2 && *status == SAI__OK; k++) {
+        if (len > DAT__SZTYP) len = DAT__SZTYP;
+        memcpy( typestr, (k == 0 ? extra : comma + 1), len );
+        typestr[len] = '\0';
+        if (dau1CheckType( 1, typestr, &h5type, normtypestr,
+                           sizeof(normtypestr), status )) {
+          if (k == 0) {
+            from = dau1HdsType( h5type, status );
+          } else {
+            to = dau1HdsType( h5type, status );
+          }
+        }
+        if (h5type > 0) H5Tclose( h5type );
+        h5type = 0;
+        len = strlen( comma + 1 );
+      }
+      if ((from == HDSTYPE_NONE || to == HDSTYPE_NONE) &&
+          *status == SAI__OK) {
+        *status = DAT__TYPIN;
+        emsRepf("hdsInfoI_conv", "hdsInfoI: Invalid type conversion '%s'",
+                status, extra );
+      }
+      if (*status != SAI__OK) return *status;
+    }
+
+    hds1MetricsCopy( &metrics );
+    for (i = 0; i < HDSTYPE_STRUCTURE; i++) {
+      for (j = 0; j < HDSTYPE_STRUCTURE; j++) {
+        if (from == HDSTYPE_NONE || (i == from && j == to)) {
+          total += metrics.nconvert[i][j];
+        }
+      }
+    }
+    *result = CLAMPINT( total );
+  } else if (strncasecmp(topic_str, "IDS", 3) == 0) {
+    ssize_t nobj = H5Fget_obj_count( H5F_OBJ_ALL, H5F_OBJ_ALL );
+    *result = ( nobj > 0 ? CLAMPINT( nobj ) : 0 );
   } else if (strncasecmp(topic_str, "ALOC", 4) == 0 ||
              strncasecmp(topic_str, "LOCA", 4) == 0 ) {
     char * filter = NULL;
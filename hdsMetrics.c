@@ -0,0 +1,201 @@
+/*
+*+
+*  Name:
+*     hdsMetrics
+
+*  Purpose:
+*     Return a snapshot of the HDS run time metrics
+
+*  Language:
+*     Starlink ANSI C
+
+*  Type of Module:
+*     Library routine
+
+*  Invocation:
+*     hdsMetrics( char *buffer, size_t buflen, int *status );
+
+*  Arguments:
+*     buffer = char * (Returned)
+*        Buffer to receive the metrics, as a null-terminated string.
+*     buflen = size_t (Given)
+*        Size of "buffer" in bytes, including room for the terminator.
+*     status = int* (Given and Returned)
+*        Pointer to global status.
+
+*  Description:
+*     Writes the current values of all the run time metrics into the
+*     supplied buffer, one per line in the form "name=value", so that they
+*     can be logged or passed to a monitoring system. The following are
+*     always included:
+*
+*     - files: Number of open container files.
+*     - locators: Number of active locators (excluding internal scratch
+*       locators, as for the LOCATORS topic of hdsInfoI).
+*     - handles: Number of internal object Handles in existence.
+*     - hdf5_ids: Number of open HDF5 identifiers.
+*     - mapped_bytes: Bytes currently mapped by datMap.
+*     - mmap_bytes: ... of which mapped directly from the file.
+*     - copymap_bytes: ... of which mapped by copying into memory.
+*     - mmap_count: Number of primitives mapped directly from the file.
+*     - copymap_count: Number of primitives mapped by copying.
+*     - lockwait_count: Number of times a thread has had to wait for access
+*       to an object held by another thread.
+*     - lockwait_us: Total time spent waiting, in microseconds.
+*
+*     followed by a line "convert.FROM.TO=n" for each pair of HDS types
+*     between which "n" (non-zero) data elements have been converted when
+*     reading or writing, for example "convert._INTEGER._REAL=1024".
+
+*  Notes:
+*     - An error is reported if the buffer is too small, in which case it
+*       holds as many complete lines as would fit.
+*     - Several of the values are also available individually from
+*       hdsInfoI.
+
+*  Authors:
+*     {enter_new_authors_here}
+
+*  History:
+*     18-OCT-2026:
+*        Original version.
+*     {enter_further_changes_here}
+
+*  Copyright:
+*     Copyright (C) 2026 East Asian Observatory
+*     All Rights Reserved.
+
+*  Licence:
+*     Redistribution and use in source and binary forms, with or
+*     without modification, are permitted provided that the following
+*     conditions are met:
+*
+*     - Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*
+*     - Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials
+*       provided with the distribution.
+*
+*     - Neither the name of the {organization} nor the names of its
+*       contributors may be used to endorse or promote products
+*       derived from this software without specific prior written
+*       permission.
+*
+*     THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+*     CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*     INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+*     MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*     DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+*     CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+*     SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+*     LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*     USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+*     AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+*     LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+*     IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+*     THE POSSIBILITY OF SUCH DAMAGE.
+
+*  Bugs:
+*     {note_any_bugs_here}
+*-
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+/* Names of the primitive types, in the order of hdstype_t */
+static const char *type_names[HDSTYPE_STRUCTURE] = {
+  "", "_BYTE", "_UBYTE", "_WORD", "_UWORD", "_INTEGER", "_INT64",
+  "_REAL", "_DOUBLE", "_LOGICAL", "_CHAR"
+};
+
+static int hds1AppendMetric( char *buffer, size_t buflen, size_t *used,
+                             const char *name, size_t value );
+
+int
+hdsMetrics( char *buffer, size_t buflen, int *status ) {
+  HdsMetrics metrics;
+  char name[2*DAT__SZTYP + 10];
+  ssize_t nids;
+  size_t used = 0;
+  int ok = 1;
+  int i;
+  int j;
+
+  if (*status != SAI__OK) return *status;
+  if (!buffer || buflen == 0) {
+    *status = DAT__TRUNC;
+    emsRep("hdsMetrics_1", "hdsMetrics: No buffer supplied for the metrics",
+           status );
+    return *status;
+  }
+  buffer[0] = '\0';
+
+  hds1MetricsCopy( &metrics );
+  nids = H5Fget_obj_count( H5F_OBJ_ALL, H5F_OBJ_ALL );
+
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "files",
+                               hds1CountFiles() );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "locators",
+                               hds1CountLocators( 0, NULL, HDS_TRUE, status ) );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "handles",
+                               metrics.nhandle );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "hdf5_ids",
+                               ( nids > 0 ? nids : 0 ) );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "mapped_bytes",
+                               metrics.bytes_mmap + metrics.bytes_copymap );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "mmap_bytes",
+                               metrics.bytes_mmap );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "copymap_bytes",
+                               metrics.bytes_copymap );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "mmap_count",
+                               metrics.nmmap );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "copymap_count",
+                               metrics.ncopymap );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "lockwait_count",
+                               metrics.nlockwait );
+  ok = ok && hds1AppendMetric( buffer, buflen, &used, "lockwait_us",
+                               metrics.lockwait_ns / 1000 );
+
+  for (i = 1; i < HDSTYPE_STRUCTURE && ok; i++) {
+    for (j = 1; j < HDSTYPE_STRUCTURE && ok; j++) {
+      if (metrics.nconvert[i][j] == 0) continue;
+      snprintf( name, sizeof(name), "convert.%s.%s", type_names[i],
+                type_names[j] );
+      ok = hds1AppendMetric( buffer, buflen, &used, name,
+                             metrics.nconvert[i][j] );
+    }
+  }
+
+  if (!ok && *status == SAI__OK) {
+    *status = DAT__TRUNC;
+    emsRepf("hdsMetrics_2", "hdsMetrics: Buffer of %zu bytes is too small "
+            "to hold all the metrics", status, buflen );
+  }
+
+  return *status;
+}
+
+/* Append a "name=value" line to the buffer, updating "used". Returns
+   zero, leaving the buffer unchanged, if the line does not fit. */
+static int hds1AppendMetric( char *buffer, size_t buflen, size_t *used,
+                             const char *name, size_t value ) {
+  int len;
+  len = snprintf( buffer + *used, buflen - *used, "%s=%zu\n", name, value );
+  if (len < 0 || (size_t)len >= buflen - *used) {
+    buffer[*used] = '\0';
+    return 0;
+  }
+  *used += len;
+  return 1;
+}
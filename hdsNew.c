@@ -133,14 +133,19 @@ hdsNew(const char *file_str,
   char cleanname[DAT__SZNAM+1];
   char groupstr[DAT__SZTYP+1];
   hid_t file_id = 0;
+  hid_t fcpl = H5P_DEFAULT;
+  hid_t fapl = H5P_DEFAULT;
   hsize_t h5dims[DAT__MXDIM];
   HDSLoc * thisloc = NULL;
   hid_t h5type = 0;
   char *fname = NULL;
+  uint64_t tstart = 0;
 
   /* Returns the inherited status for compatibility reasons */
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Configure the HDF5 library for our needs as this routine could be called
      before any others. */
   dat1InitHDF5();
@@ -174,11 +179,12 @@ hdsNew(const char *file_str,
               "cannot be used to create a new container file.", status,
               fname );
 
-  /* Otherrwise, create the HDF5 file */
+  /* Otherrwise, create the HDF5 file, using compact metadata storage
+     if requested by the tuning parameters. */
   } else {
+     dat1FileProps( fname, HDS_TRUE, &fcpl, &fapl, status );
      CALLHDFE( hid_t, file_id,
-            H5Fcreate( fname, H5F_ACC_TRUNC,
-                       H5P_DEFAULT, H5P_DEFAULT ),
+            H5Fcreate( fname, H5F_ACC_TRUNC, fcpl, fapl ),
             DAT__FILCR,
             emsRepf("hdsNew","Error creating file '%s'", status, fname )
             );
@@ -208,6 +214,10 @@ hdsNew(const char *file_str,
     }
   }
 
+  if (fcpl != H5P_DEFAULT) H5Pclose( fcpl );
+  if (fapl != H5P_DEFAULT) H5Pclose( fapl );
+  fcpl = fapl = H5P_DEFAULT;
+
   /* Free fname allocated by dau1CheckFileName.  Set to NULL in case
      the CLEANUP block runs so that we don't try to free it twice? */
   if (fname) {
@@ -218,6 +228,7 @@ hdsNew(const char *file_str,
   /* Return the locator */
   if (*status == SAI__OK) {
     *locator = thisloc;
+    HDS1_STATS_END( HDS__STAT_HDSNEW, tstart, 0, thisloc->handle );
     return *status;
   }
 
@@ -230,8 +241,11 @@ hdsNew(const char *file_str,
   }
   if (*status != SAI__OK) unlink(fname);
   if (file_id > 0) H5Fclose(file_id);
+  if (fcpl != H5P_DEFAULT) H5Pclose( fcpl );
+  if (fapl != H5P_DEFAULT) H5Pclose( fapl );
   if (fname) MEM_FREE(fname);
 
+  HDS1_STATS_END( HDS__STAT_HDSNEW, tstart, 0, NULL );
   return *status;
 }
 
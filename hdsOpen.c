@@ -138,15 +138,22 @@ hdsOpen( const char *file_str, const char *mode_str,
   char * fname = NULL;
   hid_t file_id = 0;
   hid_t group_id = 0;
+  hid_t fapl = H5P_DEFAULT;
+  hid_t fcpl = H5P_DEFAULT;
+  H5F_fspace_strategy_t strategy;
+  size_t pbsize = 0;
   htri_t filstat = 0;
   unsigned int flags = 0;
   int rdonly = 0;
   int lstat;
   int oldlock;
+  uint64_t tstart = 0;
 
   *locator = NULL;
   if (*status != SAI__OK) return *status;
 
+  HDS1_STATS_BEGIN( tstart );
+
   /* Configure the HDF5 library for our needs as this routine could be called
      before any others. */
   dat1InitHDF5();
@@ -188,7 +195,23 @@ hdsOpen( const char *file_str, const char *mode_str,
   /* Open the HDF5 file. First check status is good so we can tell if the
     file open has failed.  */
   if( *status == SAI__OK ) {
-     file_id = H5Fopen( fname, flags, H5P_DEFAULT );
+
+/* Use any file access properties given by the tuning parameters. HDF5
+   refuses to use a page buffer with files that were not created with
+   paged aggregation, so if a page buffer was requested and the open
+   fails, try again without the page buffer but with the other
+   properties. If that also fails, the page buffer was not the problem,
+   so it is requested again. Any other failure is dealt with below. */
+     dat1FileProps( fname, HDS_FALSE, NULL, &fapl, status );
+     if( fapl == H5P_DEFAULT ||
+         H5Pget_page_buffer_size( fapl, &pbsize, NULL, NULL ) < 0 ) pbsize = 0;
+
+     file_id = H5Fopen( fname, flags, fapl );
+     if( file_id < 0 && pbsize > 0 &&
+         H5Pset_page_buffer_size( fapl, 0, 0, 0 ) >= 0 ) {
+        file_id = H5Fopen( fname, flags, fapl );
+        if( file_id < 0 ) H5Pset_page_buffer_size( fapl, pbsize, 0, 0 );
+     }
 
 /* If the file could not be opened, and we are attempting to open it in
    UPDATE or WRITE mode, the error may be caused by it already being open
@@ -196,15 +219,33 @@ hdsOpen( const char *file_str, const char *mode_str,
    READ mode [HDS V4 allows a file to opened for update even if it has
    previously been opened read-only, although the second open may fail
    if the file is write-protected. Some starlink apps rely on this
-   behaviour]. */
+   behaviour]. The same tuned properties are used, again without the
+   page buffer if it is refused. */
      if( file_id < 0 && !rdonly ) {
-        file_id = H5Fopen( fname, H5F_ACC_RDONLY, H5P_DEFAULT );
+        file_id = H5Fopen( fname, H5F_ACC_RDONLY, fapl );
+        if( file_id < 0 && pbsize > 0 &&
+            H5Pset_page_buffer_size( fapl, 0, 0, 0 ) >= 0 ) {
+           file_id = H5Fopen( fname, H5F_ACC_RDONLY, fapl );
+        }
 
 /* If the file was opened successfully in READ mode, we need to
    close the file and then re-open it in the requested mode, re-establishing
-   all the active locators associated with the file. */
+   all the active locators associated with the file. A file that is
+   already open is shared, so the page buffer may have been accepted
+   above even if the file is not paged. Check before re-opening. */
         if( file_id > 0 ) {
-           file_id = dat1Reopen( file_id, flags, H5P_DEFAULT, status );
+           if( pbsize > 0 ) {
+              strategy = H5F_FSPACE_STRATEGY_PAGE;
+              fcpl = H5Fget_create_plist( file_id );
+              if( fcpl >= 0 ) {
+                 H5Pget_file_space_strategy( fcpl, &strategy, NULL, NULL );
+                 H5Pclose( fcpl );
+              }
+              if( strategy != H5F_FSPACE_STRATEGY_PAGE ) {
+                 H5Pset_page_buffer_size( fapl, 0, 0, 0 );
+              }
+           }
+           file_id = dat1Reopen( file_id, flags, fapl, status );
         } else {
            *status = DAT__HDF5E;
            dat1H5EtoEMS( status );
@@ -312,6 +353,7 @@ hdsOpen( const char *file_str, const char *mode_str,
 
  CLEANUP:
   if (fname) MEM_FREE(fname);
+  if (fapl != H5P_DEFAULT) H5Pclose( fapl );
 
   /* Free the temporary which will close the parent group */
   if (temploc) datAnnul(&temploc, status );
@@ -326,6 +368,8 @@ hdsOpen( const char *file_str, const char *mode_str,
     if (file_id > 0) H5Fclose( file_id );
   }
 
+  HDS1_STATS_END( HDS__STAT_HDSOPEN, tstart, 0,
+                  (*status == SAI__OK ? (*locator)->handle : NULL) );
   return *status;
 
 }
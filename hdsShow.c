@@ -30,6 +30,11 @@
 
 *  Notes:
 *     The following topics are supported:
+*     - DATA: For each open container file, the number of reads and
+*       writes of primitive data and the bytes transferred, the bytes
+*       currently mapped (directly from the file and by copying), the
+*       file size, the HDF5 metadata cache hit rate and the raw data
+*       chunk cache settings.
 *     - FILES: List all open file objects.
 *     - LOCATORS: List all open primitives and structure locators.
 
@@ -102,9 +107,7 @@ hdsShow(const char *topic_str, int  *status) {
   if (*status != SAI__OK) return *status;
 
   if (strncasecmp( topic_str, "DAT", 3 ) == 0) {
-    *status = DAT__FATAL;
-    emsRep("hdsShow", "hdsShow: DATA reporting not yet implemented for HDF5",
-           status);
+    hds1ShowData( status );
   } else if (strncasecmp( topic_str, "FIL", 3 ) == 0 ||
              strncasecmp( topic_str, "LOC", 3 ) == 0 ) {
     ssize_t nobj = 0;
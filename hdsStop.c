@@ -29,7 +29,8 @@
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Not Yet Implemented.
+*     - Not Yet Implemented, except that any statistics gathered
+*       because the STATS tuning parameter is set are reported.
 *     - Will attempt to run even if status is set on entry, although
 *       no further error report will be made if it subsequently fails
 *       under these circumstances.
@@ -96,6 +97,10 @@ hdsStop( int *status ) {
 
   if (*status != SAI__OK) return *status;
 
+  /* Report any statistics that have been gathered */
+  if (hds1GetStats()) hds1StatsShow( HDS_FALSE );
+  hds1TraceWrite();
+
   *status = DAT__FATAL;
   emsRep("hdsStop", "hdsStop: Not yet implemented for HDF5",
          status);
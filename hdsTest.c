@@ -77,6 +77,11 @@ static void cmpprec ( const HDSLoc * loc1, const char * name, int * status );
 static void cmpintarr( size_t nelem, const int result[],
                        const int expected[], int *status );
 static void testSliceVec( int *status );
+static void testCompact( int *status );
+static void testTuneFile( int *status );
+static int countComps( const HDSLoc *loc, const char *name, hdsbool_t isstruc,
+                       const char *type_str, HDSLoc *comploc, void *data,
+                       int *status );
 static void testThreadSafety( const char *path, int *status );
 static void *test1ThreadSafety( void *data );
 static void *test2ThreadSafety( void *data );
@@ -136,6 +141,9 @@ int main (void) {
 
   emsBegin(&status);
 
+  /* Tuning file defaults, which must be read before anything else */
+  testTuneFile( &status );
+
   /* Create a new container file */
   hdsNew( path, "HDS_TEST", "NDF", 0, dim, &loc1, &status );
 
@@ -213,6 +221,28 @@ int main (void) {
       datSlice(loc2, 2, lower, upper, &loc3, &status );
       datGetI(loc3, 2, outdims, outdata, &status);
       cmpintarr( 4, outdata, expected, &status );
+
+      /* The same slice placed inside a larger array, with and
+         without type conversion by HDS */
+      if (status == SAI__OK) {
+        const hdsdim bufdims[] = { 4, 3 };
+        const hdsdim bufpos[] = { 2, 2 };
+        const int expbuf[] = { 0, 0, 0, 0, 0, 13, 14, 0, 0, 18, 19, 0 };
+        int buf[12];
+        char cbuf[12][2];
+        memset( buf, 0, sizeof(buf) );
+        memset( cbuf, ' ', sizeof(cbuf) );
+        datGetRegion( loc3, "_INTEGER", 2, outdims, bufdims, bufpos, buf,
+                      &status );
+        cmpintarr( 12, buf, expbuf, &status );
+        datGetRegion( loc3, "_CHAR*2", 2, outdims, bufdims, bufpos, cbuf,
+                      &status );
+        if (status == SAI__OK && (strncmp( cbuf[9], "18", 2 ) != 0 ||
+                                  strncmp( cbuf[4], "  ", 2 ) != 0)) {
+          status = DAT__FATAL;
+          emsRep("", "datGetRegion did not place strings correctly", &status );
+        }
+      }
       datAnnul( &loc3, &status );
     }
     if (status == SAI__OK) {
@@ -231,6 +261,62 @@ int main (void) {
       datAnnul(&loc4, &status);
       datAnnul(&loc3, &status);
     }
+    if (status == SAI__OK) {
+      /* Reshape to a vector and check the elements are in the same order */
+      const hdsdim newdim[] = { 30 };
+      const hdsdim lower[] = { 13 };
+      const hdsdim upper[] = { 16 };
+      const int expected[] = { 13, 14, 15, 16 };
+      hdsdim dims[DAT__MXDIM];
+      int outdata[4];
+      int ndims;
+      size_t actvals;
+      datMould( loc2, 1, newdim, &status );
+      datShape( loc2, DAT__MXDIM, dims, &ndims, &status );
+      cmpszints( ndims, 1, &status );
+      cmpszints( dims[0], 30, &status );
+      datSlice( loc2, 1, lower, upper, &loc3, &status );
+      datGet1I( loc3, 4, outdata, &actvals, &status );
+      cmpintarr( actvals, outdata, expected, &status );
+      datAnnul( &loc3, &status );
+
+      /* Reinterpret the bytes as another type of the same size and back */
+      datRetyp( loc2, "_REAL", &status );
+      datType( loc2, typestr, &status );
+      cmpstrings( typestr, "_REAL", &status );
+      datRetyp( loc2, "_INTEGER", &status );
+      datSlice( loc2, 1, lower, upper, &loc3, &status );
+      datGet1I( loc3, 4, outdata, &actvals, &status );
+      cmpintarr( actvals, outdata, expected, &status );
+      datAnnul( &loc3, &status );
+    }
+    if (status == SAI__OK) {
+      hdsbool_t conv = HDS_FALSE;
+      datConv( loc2, "_DOUBLE", &conv, &status );
+      cmpszints( conv, HDS_TRUE, &status );
+      datConv( loc1, "_DOUBLE", &conv, &status );
+      cmpszints( conv, HDS_FALSE, &status );
+    }
+    if (status == SAI__OK) {
+      /* Raw bytes of the integers, modified in place */
+      unsigned char *bpntr = NULL;
+      size_t nbytes = 0;
+      size_t actvals;
+      int outvec[30];
+      int ival;
+      datBasic( loc2, "UPDATE", &bpntr, &nbytes, &status );
+      cmpszints( nbytes, 30 * sizeof(int), &status );
+      if (status == SAI__OK) {
+        memcpy( &ival, bpntr + 12*sizeof(int), sizeof(int) );
+        cmpszints( ival, 13, &status );
+        ival = -13;
+        memcpy( bpntr + 12*sizeof(int), &ival, sizeof(int) );
+      }
+      datUnmap( loc2, &status );
+      datGet1I( loc2, 30, outvec, &actvals, &status );
+      cmpszints( outvec[12], -13, &status );
+      cmpszints( outvec[13], 14, &status );
+    }
     datAnnul( &loc2, &status );
   }
 
@@ -259,6 +345,62 @@ int main (void) {
     traceme(loc3, "HDS_TEST.RECORDS(3,2)", 2, &status);
     traceme(loc4, "HDS_TEST.RECORDS(3,2).INTINCELL", 3, &status);
     datAnnul( &loc4, &status );
+
+    /* The same objects located from a path in a single call */
+    datFindPath( loc1, "records(3, 2).IntInCell", &loc4, &status );
+    traceme(loc4, "HDS_TEST.RECORDS(3,2).INTINCELL", 3, &status);
+    if (status == SAI__OK) {
+      int ival = 0;
+      datGet0I( loc4, &ival, &status );
+      cmpszints( ival, -999, &status );
+    }
+    datAnnul( &loc4, &status );
+    datFindPath( loc1, "RECORDS(3,2)", &loc4, &status );
+    traceme(loc4, "HDS_TEST.RECORDS(3,2)", 2, &status);
+    datAnnul( &loc4, &status );
+
+    /* Reshape the structure array and check that the open cell follows */
+    if (status == SAI__OK) {
+      const hdsdim newdim[] = { 2, 5 };
+      datMould( loc2, 2, newdim, &status );
+      traceme(loc3, "HDS_TEST.RECORDS(2,4)", 2, &status);
+      datFindPath( loc1, "RECORDS(2,4).INTINCELL", &loc4, &status );
+      datAnnul( &loc4, &status );
+      datMould( loc2, 2, histdim, &status );
+      traceme(loc3, "HDS_TEST.RECORDS(3,2)", 2, &status);
+      datRetyp( loc2, "NEW_REC", &status );
+      datType( loc3, namestr, &status );
+      cmpstrings( namestr, "NEW_REC", &status );
+    }
+    if (status == SAI__OK) {
+      int lstat = SAI__OK;
+      emsMark();
+      datRetyp( loc3, "CELL_REC", &lstat );
+      if (lstat == DAT__OBJIN) {
+        emsAnnul( &lstat );
+      } else {
+        if (lstat != SAI__OK) emsAnnul( &lstat );
+        status = DAT__FATAL;
+        emsRep("", "datRetyp did not reject a cell locator", &status );
+      }
+      emsRlse();
+    }
+    if (status == SAI__OK) {
+      int lstat = SAI__OK;
+      emsMark();
+      datFindPath( loc1, "RECORDS(3,1).INTINCELL", &loc4, &lstat );
+      if (lstat == DAT__OBJNF) {
+        emsAnnul( &lstat );
+      } else {
+        if (lstat != SAI__OK) emsAnnul( &lstat );
+        status = DAT__FATAL;
+      }
+      emsRlse();
+      if (status != SAI__OK) {
+        emsRep("", "datFindPath did not report DAT__OBJNF for a missing "
+               "component", &status );
+      }
+    }
     datAnnul( &loc3, &status );
     datAnnul( &loc2, &status );
   }
@@ -316,6 +458,16 @@ int main (void) {
       }
     }
 
+    /* Iterate over the components and compare with datNcomp */
+    {
+      int niter = 0;
+      datIterate( loc2, 1, countComps, &niter, &status );
+      cmpszints( niter, ncomp, &status );
+      niter = 0;
+      datIterate( loc2, 0, countComps, &niter, &status );
+      cmpszints( niter, ncomp, &status );
+    }
+
 //    cmpprec( loc2, "BYTE", &status );
 //    cmpprec( loc2, "UBYTE", &status );
     cmpprec( loc2, "WORD", &status );
@@ -399,6 +551,280 @@ int main (void) {
     hdsFlush( "TEST", &status );
   }
 
+  /* Check that a missing component is reported as not found */
+  if (status == SAI__OK) {
+    int lstat = SAI__OK;
+    emsMark();
+    datFind( loc1, "NOTTHERE", &loc3, &lstat );
+    if (lstat == DAT__OBJNF) {
+      emsAnnul( &lstat );
+    } else {
+      if (lstat != SAI__OK) emsAnnul( &lstat );
+      status = DAT__FATAL;
+    }
+    emsRlse();
+    if (status != SAI__OK) {
+      emsRep("", "datFind did not report DAT__OBJNF for a missing component",
+             &status );
+    }
+  }
+
+  /* Write and read several components at once */
+  if (status == SAI__OK) {
+    const hdsdim vdim[] = { 3 };
+    const double dvals[] = { 1.5, -2.5, 3.5 };
+    double dout[3];
+    int ival = 42;
+    int iout = 0;
+    char cval[] = "BATCHED ";
+    char cout[9];
+    hdsbool_t lval = HDS_TRUE;
+    hdsbool_t lout = HDS_FALSE;
+    int lstat = SAI__OK;
+    HDSBatchItem items[] = {
+      { "BINT", "_INTEGER", 0, NULL, &ival, 0 },
+      { "BDBL", "_DOUBLE", 1, vdim, (void *)dvals, 0 },
+      { "BCHAR", "_CHAR*8", 0, NULL, cval, 0 },
+      { "BLOG", "_LOGICAL", 0, NULL, &lval, 0 },
+      { "BMISSING", "_INTEGER", 0, NULL, &ival, 0 }
+    };
+
+    datNew( loc1, "BATCH", "BATCH_TEST", 0, NULL, &status );
+    datFind( loc1, "BATCH", &loc2, &status );
+    datNew0I( loc2, "BINT", &status );
+    datNew1D( loc2, "BDBL", 3, &status );
+    datNew0C( loc2, "BCHAR", 8, &status );
+    datNew0L( loc2, "BLOG", &status );
+    datPutBatch( loc2, 4, items, &status );
+
+    items[0].values = &iout;
+    items[1].values = dout;
+    items[2].values = cout;
+    items[3].values = &lout;
+    emsMark();
+    datGetBatch( loc2, 5, items, &lstat );
+    if (lstat == DAT__OBJNF && items[4].status == DAT__OBJNF &&
+        items[0].status == SAI__OK) {
+      emsAnnul( &lstat );
+    } else {
+      if (lstat != SAI__OK) emsAnnul( &lstat );
+      status = DAT__FATAL;
+      emsRep("", "datGetBatch did not report a missing component", &status );
+    }
+    emsRlse();
+    cout[8] = '\0';
+    cmpszints( iout, 42, &status );
+    cmpszints( (int)(dout[1] * 10), -25, &status );
+    cmpstrings( cout, "BATCHED ", &status );
+    cmpszints( lout, HDS_TRUE, &status );
+
+    /* Values read in the background and then collected */
+    if (status == SAI__OK) {
+      HDSLoc *loc4 = NULL;
+      double *dpntr = NULL;
+      size_t actvals = 0;
+      datFind( loc2, "BDBL", &loc3, &status );
+      datPrefetch( loc3, "_DOUBLE", &status );
+      datGetVD( loc3, 3, dout, &actvals, &status );
+      cmpszints( (int)(dout[2] * 10), 35, &status );
+      datPrefetch( loc3, "_DOUBLE", &status );
+      datMapD( loc3, "READ", 1, vdim, &dpntr, &status );
+      if (status == SAI__OK) cmpszints( (int)(dpntr[0] * 10), 15, &status );
+      datUnmap( loc3, &status );
+      datPrefetch( loc3, "_DOUBLE", &status );
+
+      /* Written in the background after unmapping, and read back */
+      hdsTune( "WRITEBEHIND", 16, &status );
+      datMapD( loc3, "UPDATE", 1, vdim, &dpntr, &status );
+      if (status == SAI__OK) dpntr[1] = 7.5;
+      datUnmap( loc3, &status );
+      datGetVD( loc3, 3, dout, &actvals, &status );
+      cmpszints( (int)(dout[1] * 10), 75, &status );
+      datMapD( loc3, "WRITE", 1, vdim, &dpntr, &status );
+      if (status == SAI__OK) {
+        dpntr[0] = 0.5;
+        dpntr[1] = -2.5;
+        dpntr[2] = 3.5;
+      }
+      datUnmap( loc3, &status );
+      hdsSync( &status );
+      hdsTune( "WRITEBEHIND", 0, &status );
+      datGetVD( loc3, 3, dout, &actvals, &status );
+      cmpszints( (int)(dout[0] * 10), 5, &status );
+
+      /* A write through another locator discards the prefetched values.
+         Requests are done in order, so collecting the second prefetch
+         ensures the first has been read before the write. */
+      datPrefetch( loc3, "_DOUBLE", &status );
+      datFind( loc2, "BDBL", &loc4, &status );
+      datPrefetch( loc4, "_DOUBLE", &status );
+      datGet1D( loc4, 3, dout, &actvals, &status );
+      dout[0] = 10.5;
+      dout[1] = 20.5;
+      dout[2] = 30.5;
+      datPutVD( loc4, 3, dout, &status );
+      datAnnul( &loc4, &status );
+      datGet1D( loc3, 3, dout, &actvals, &status );
+      cmpszints( (int)(dout[2] * 10), 305, &status );
+      datAnnul( &loc3, &status );
+    }
+
+    /* A large buffer backed by huge pages */
+    if (status == SAI__OK) {
+      hdsdim hdim[] = { 262144 };
+      double *dpntr = NULL;
+      int nhuge = 0;
+      hdsTune( "HUGEPAGE", 1, &status );
+      datNew( loc2, "BHUGE", "_DOUBLE", 1, hdim, &status );
+      datFind( loc2, "BHUGE", &loc3, &status );
+      datMapD( loc3, "WRITE", 1, hdim, &dpntr, &status );
+      if (status == SAI__OK) dpntr[hdim[0]-1] = 4.5;
+      hdsInfoI( NULL, "HUGEPAGES", NULL, &nhuge, &status );
+      cmpszints( nhuge, 1, &status );
+      datUnmap( loc3, &status );
+      hdsInfoI( NULL, "HUGEPAGES", NULL, &nhuge, &status );
+      cmpszints( nhuge, 0, &status );
+      datMapD( loc3, "READ", 1, hdim, &dpntr, &status );
+      if (status == SAI__OK) cmpszints( (int)(dpntr[hdim[0]-1] * 10), 45, &status );
+      datUnmap( loc3, &status );
+      hdsTune( "HUGEPAGE", 0, &status );
+      datAnnul( &loc3, &status );
+      datErase( loc2, "BHUGE", &status );
+    }
+
+    /* A compressed primitive stored in chunks, which must be read by
+       copying. Whole chunks are transferred directly by two threads. */
+    if (status == SAI__OK) {
+      hdsdim cdim[] = { 100, 30 };
+      hdsdim lower[] = { 1, 12 };
+      hdsdim upper[] = { 100, 12 };
+      hdsdim sdim[] = { 100, 1 };
+      HDSLoc *sloc = NULL;
+      int cvals[3000];
+      int *ipntr = NULL;
+      int chunk = 0;
+      for (i = 0; i < 3000; i++) cvals[i] = i;
+      hdsTune( "CHUNK", 1, &status );
+      hdsGtune( "CHUNK", &chunk, &status );
+      cmpszints( chunk, 1, &status );
+      hdsTune( "COMPRESS", 1, &status );
+      hdsTune( "CHUNKIO", 2, &status );
+      datNew( loc2, "BCHUNK", "_INTEGER", 2, cdim, &status );
+      hdsTune( "CHUNK", 0, &status );
+      hdsTune( "COMPRESS", 0, &status );
+      datFind( loc2, "BCHUNK", &loc3, &status );
+      datPutI( loc3, 2, cdim, cvals, &status );
+      datSlice( loc3, 2, lower, upper, &sloc, &status );
+      datMapI( sloc, "READ", 2, sdim, &ipntr, &status );
+      if (status == SAI__OK) cmpszints( ipntr[5], 1105, &status );
+      datUnmap( sloc, &status );
+      datAnnul( &sloc, &status );
+      memset( cvals, 0, sizeof(cvals) );
+      datGetI( loc3, 2, cdim, cvals, &status );
+      for (i = 0; i < 3000 && status == SAI__OK; i++) {
+        cmpszints( cvals[i], i, &status );
+      }
+
+      /* Read back through the HDF5 filter pipeline, to check that the
+         chunks were compressed as HDF5 expects */
+      hdsTune( "CHUNKIO", 0, &status );
+      memset( cvals, 0, sizeof(cvals) );
+      datGetI( loc3, 2, cdim, cvals, &status );
+      for (i = 0; i < 3000 && status == SAI__OK; i++) {
+        cmpszints( cvals[i], i, &status );
+      }
+      datAnnul( &loc3, &status );
+      datErase( loc2, "BCHUNK", &status );
+    }
+
+    /* Converting values through a small transfer buffer, a few pieces of
+       a slice at a time */
+    if (status == SAI__OK) {
+      hdsdim wdim[] = { 200, 200 };
+      hdsdim lower[] = { 11, 1 };
+      hdsdim upper[] = { 20, 200 };
+      hdsdim sdim[] = { 10, 200 };
+      HDSLoc *sloc = NULL;
+      short *wvals = NULL;
+      float *fvals = NULL;
+      int nblocks = 0;
+      wvals = malloc( 40000 * sizeof(*wvals) );
+      fvals = malloc( 40000 * sizeof(*fvals) );
+      if (!wvals || !fvals) {
+        status = DAT__NOMEM;
+        emsRep( "", "Unable to allocate transfer buffers", &status );
+      } else {
+        for (i = 0; i < 40000; i++) wvals[i] = i % 1000;
+      }
+      hdsTune( "NBLOCKS", 1, &status );
+      hdsGtune( "NBLOCKS", &nblocks, &status );
+      cmpszints( nblocks, 1, &status );
+      hdsTune( "HYPERVEC", 2, &status );
+      datNew( loc2, "BWORD", "_WORD", 2, wdim, &status );
+      datFind( loc2, "BWORD", &loc3, &status );
+      datPutW( loc3, 2, wdim, wvals, &status );
+      datGetR( loc3, 2, wdim, fvals, &status );
+      if (status == SAI__OK) cmpszints( (int)fvals[39999], 999, &status );
+      datSlice( loc3, 2, lower, upper, &sloc, &status );
+      datGetR( sloc, 2, sdim, fvals, &status );
+      if (status == SAI__OK) cmpszints( (int)fvals[15], 215, &status );
+      hdsTune( "NBLOCKS", 0, &status );
+      hdsTune( "HYPERVEC", 0, &status );
+      datAnnul( &sloc, &status );
+      datAnnul( &loc3, &status );
+      datErase( loc2, "BWORD", &status );
+      free( wvals );
+      free( fvals );
+    }
+
+    /* Call counts, reported on demand */
+    if (status == SAI__OK) {
+      int ncalls = 0;
+      hdsTune( "STATS", 1, &status );
+      datFind( loc2, "BINT", &loc3, &status );
+      datGet0I( loc3, &iout, &status );
+      datAnnul( &loc3, &status );
+      hdsInfoI( NULL, "STATS", "RESET", &ncalls, &status );
+      if (status == SAI__OK && ncalls < 3) {
+        status = DAT__FATAL;
+        emsRepf( "", "hdsInfoI STATS counted %d calls rather than at least 3",
+                 &status, ncalls );
+      }
+      hdsInfoI( NULL, "STATS", NULL, &ncalls, &status );
+      cmpszints( ncalls, 0, &status );
+      hdsTune( "STATS", 0, &status );
+    }
+
+    /* Run time metrics */
+    if (status == SAI__OK) {
+      char snapshot[2048];
+      double dval = 0.0;
+      int nconv0 = 0;
+      int nconv1 = 0;
+      int nhandle = 0;
+      hdsInfoI( NULL, "CONVERSIONS", "_INTEGER,_DOUBLE", &nconv0, &status );
+      datFind( loc2, "BINT", &loc3, &status );
+      datGet0D( loc3, &dval, &status );
+      hdsInfoI( NULL, "HANDLES", NULL, &nhandle, &status );
+      datAnnul( &loc3, &status );
+      hdsInfoI( NULL, "CONVERSIONS", "_INTEGER,_DOUBLE", &nconv1, &status );
+      cmpszints( nconv1 - nconv0, 1, &status );
+      if (status == SAI__OK && nhandle < 3) {
+        status = DAT__FATAL;
+        emsRepf( "", "hdsInfoI HANDLES returned %d rather than at least 3",
+                 &status, nhandle );
+      }
+      hdsMetrics( snapshot, sizeof(snapshot), &status );
+      if (status == SAI__OK && (!strstr( snapshot, "\nhandles=" ) ||
+                                !strstr( snapshot, "convert._INTEGER._DOUBLE=" ))) {
+        status = DAT__FATAL;
+        emsRepf( "", "hdsMetrics returned unexpected metrics: %s",
+                 &status, snapshot );
+      }
+    }
+    datAnnul( &loc2, &status );
+  }
+
   /* Check that we can not ask for the parent of the
      root locator */
   if (status == SAI__OK) {
@@ -591,7 +1017,9 @@ int main (void) {
 
   /* Try mapping - _DOUBLE */
   dimd[0] = 2;
+  datMapAdvise(loc2, "RANDOM", &status);
   datMapD(loc2, "READ", 1, dimd, &mapd, &status);
+  datMapAdvise(loc2, "SEQUENTIAL", &status);
   if (status == SAI__OK) {
       for (i = 0; i < 2; i++ ) {
          if (darr[i] != mapd[i]) {
@@ -616,6 +1044,16 @@ int main (void) {
       }
   }
   datUnmap(loc2, &status);
+  if (status == SAI__OK) {
+    datMapAdvise(loc2, "SIDEWAYS", &status);
+    if (status == DAT__MODIN) {
+      emsAnnul(&status);
+    } else {
+      if (status != SAI__OK) emsAnnul(&status);
+      status = DAT__FATAL;
+      emsRep("", "datMapAdvise accepted an unknown pattern", &status);
+    }
+  }
   datAnnul(&loc2, &status);
 
   /* Find and map DATA_ARRAY */
@@ -643,7 +1081,9 @@ int main (void) {
 
   /* See if we can rename something and copy it*/
   datFind( loc1, "TESTSTRUCT", &loc2, &status );
+  traceme( loc2, "HDS_TEST.TESTSTRUCT", 2, &status );
   datRenam( loc2, "STRUCT2", &status );
+  traceme( loc2, "HDS_TEST.STRUCT2", 2, &status );
   datCcopy( loc2, loc1, "STRUCT3", &loc3, &status);
   {
     char type2str[DAT__SZTYP];
@@ -653,9 +1093,11 @@ int main (void) {
   }
   datAnnul( &loc3, &status);
   datFind( loc2, "CHAR", &loc3, &status );
+  traceme( loc3, "HDS_TEST.STRUCT2.CHAR", 3, &status );
   datRenam( loc3, "CHAR*12", &status );
   datName( loc3, namestr, &status );
   cmpstrings( namestr, "CHAR*12", &status );
+  traceme( loc3, "HDS_TEST.STRUCT2.CHAR*12", 3, &status );
   datAnnul( &loc3, &status );
 
   /* Copy the structure to a new location */
@@ -698,6 +1140,8 @@ int main (void) {
   hdsShow("FILES", &status);
   printf("Query locators after 2 locators created:\n");
   hdsShow("LOCATORS", &status);
+  printf("Query data transfers:\n");
+  hdsShow("DATA", &status);
 
   /* Count the number of primary locators */
   {
@@ -794,6 +1238,9 @@ int main (void) {
 /* Test slicing and vectorising. */
   testSliceVec( &status );
 
+/* Test compact metadata storage */
+  testCompact( &status );
+
 /* Test thread safety */
   testThreadSafety( path, &status );
 
@@ -861,6 +1308,26 @@ static void cmpprec ( const HDSLoc * loc1, const char * name, int * status ) {
     }
 }
 
+/* datIterate callback that counts components and checks the types
+   reported against datType */
+static int countComps( const HDSLoc *loc, const char *name, hdsbool_t isstruc,
+                       const char *type_str, HDSLoc *comploc, void *data,
+                       int *status ) {
+  char typestr[DAT__SZTYP+1];
+  int *count = data;
+  if (*status != SAI__OK) return 1;
+  (*count)++;
+  if (comploc) {
+    datType( comploc, typestr, status );
+    cmpstrings( type_str, typestr, status );
+  }
+  if (isstruc && type_str[0] == '_' && *status == SAI__OK) {
+    *status = DAT__FATAL;
+    emsRepf("", "Structure %s has primitive type %s", status, name, type_str );
+  }
+  return 0;
+}
+
 static void traceme (const HDSLoc * loc, const char * expected, int explev,
                      int *status) {
   char path_str[1024];
@@ -1020,7 +1487,153 @@ static  void testSliceVec( int *status ){
 }
 
 
+static void testTuneFile( int *status ){
+   FILE *fd = NULL;
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   hdsdim dims[] = { 100, 30 };
+   hid_t plist;
+   hsize_t blksize;
+   hsize_t heapsize;
+   H5O_info_t oinfo;
+   const char *path;
+   int ival = 0;
+   int i;
+
+   if( *status != SAI__OK ) return;
+
+/* Write a tuning file and arrange for it to be read. Nothing has yet
+   caused the tuning environment to be read. */
+   fd = fopen( "hds_ctest_tune", "w" );
+   if( !fd ) {
+      *status = DAT__FILCR;
+      emsRep( "", "Unable to create tuning file", status );
+      return;
+   }
+   fprintf( fd, "# Test tuning file\nMAP 1\nNBLOCKS = 256\nHYPERVEC 4\n" );
+   fprintf( fd, "[*/hds_ctest_tune1.sdf]\nCHUNK 1\nCOMPRESS 1\nNCOM 20\n"
+            "INAL 16\n" );
+   fclose( fd );
+   setenv( "HDS_TUNE_FILE", "hds_ctest_tune", 1 );
+
+/* Values set by hdsTune must not be replaced by the file when it is
+   read, whichever routine happens to read it. */
+   hdsTune( "MAP", 0, status );
+   hdsTune( "NBLOCKS", 300, status );
+   hdsGtune( "MAP", &ival, status );
+   cmpszints( ival, 0, status );
+   hdsGtune( "NBLOCKS", &ival, status );
+   cmpszints( ival, 300, status );
+
+/* The file still supplies the defaults for other parameters. */
+   hdsGtune( "HYPERVEC", &ival, status );
+   cmpszints( ival, 4, status );
+
+   hdsTune( "MAP", 1, status );
+   hdsTune( "NBLOCKS", 0, status );
+   hdsTune( "HYPERVEC", 0, status );
+
+/* The section applies only to the first of two otherwise identical
+   containers. The global values are left at their defaults. */
+   for( i = 1; i <= 2 && *status == SAI__OK; i++ ) {
+      path = ( i == 1 ) ? "hds_ctest_tune1" : "hds_ctest_tune2";
+      hdsNew( path, "HDS_TEST", "NDF", 0, dims, &loc1, status );
+      datNew( loc1, "DATA", "_INTEGER", 2, dims, status );
+      datNew( loc1, "MORE", "EXT", 0, dims, status );
+      datFind( loc1, "DATA", &loc2, status );
+      datFind( loc1, "MORE", &loc3, status );
+
+/* CHUNK and COMPRESS: a 12000 byte primitive is stored in compressed
+   chunks */
+      if( *status == SAI__OK ) {
+         plist = H5Dget_create_plist( loc2->dataset_id );
+         cmpszints( H5Pget_layout( plist ) == H5D_CHUNKED, i == 1, status );
+         cmpszints( H5Pget_nfilters( plist ), ( i == 1 ) ? 1 : 0, status );
+         H5Pclose( plist );
+      }
+
+/* INAL: the metadata block size, in 512-byte blocks */
+      if( *status == SAI__OK ) {
+         plist = H5Fget_access_plist( loc1->file_id );
+         H5Pget_meta_block_size( plist, &blksize );
+         cmpszints( blksize, ( i == 1 ) ? 8192 : 2048, status );
+         H5Pclose( plist );
+      }
+
+/* NCOM: the expected number of components in a new structure, which
+   sizes the local heap holding their names */
+      if( *status == SAI__OK ) {
+         H5Oget_info2( loc3->group_id, &oinfo, H5O_INFO_META_SIZE );
+         heapsize = oinfo.meta_size.obj.heap_size;
+         cmpszints( heapsize >= 20 * (DAT__SZNAM + 1), i == 1, status );
+      }
+
+      datAnnul( &loc3, status );
+      datAnnul( &loc2, status );
+      datErase( loc1, "DATA", status );
+      datErase( loc1, "MORE", status );
+      datAnnul( &loc1, status );
+   }
+
+   unsetenv( "HDS_TUNE_FILE" );
+   remove( "hds_ctest_tune" );
+}
+
+static void testCompact( int *status ){
+   HDSLoc *loc1 = NULL;
+   HDSLoc *loc2 = NULL;
+   HDSLoc *loc3 = NULL;
+   hdsdim dims[1];
+   int ival = 0;
+   int compact = 0;
+
+   if( *status != SAI__OK ) return;
 
+/* Create a file with compact metadata containing a few levels of
+   structure. */
+   hdsTune( "COMPACT", 1, status );
+   hdsGtune( "COMPACT", &compact, status );
+   cmpszints( compact, 1, status );
+   dims[0] = 3;
+   hdsNew( "hds_ctest_compact", "HDS_TEST", "NDF", 0, dims, &loc1, status );
+   datNew( loc1, "MORE", "EXT", 0, dims, status );
+   datFind( loc1, "MORE", &loc2, status );
+   datNew( loc2, "RECORDS", "HIST_REC", 1, dims, status );
+   datNew0I( loc2, "VALUE", status );
+   datFind( loc2, "VALUE", &loc3, status );
+   datPut0I( loc3, 42, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   datAnnul( &loc1, status );
+   hdsTune( "COMPACT", 0, status );
+
+/* Re-open it through a page buffer and read the value back. */
+   hdsTune( "PAGEBUF", 64, status );
+   hdsOpen( "hds_ctest_compact", "READ", &loc1, status );
+   datFind( loc1, "MORE", &loc2, status );
+   datFind( loc2, "VALUE", &loc3, status );
+   datGet0I( loc3, &ival, status );
+   cmpszints( ival, 42, status );
+   datAnnul( &loc3, status );
+   datAnnul( &loc2, status );
+   datAnnul( &loc1, status );
+
+/* A page buffer must not prevent normal files being opened */
+   hdsOpen( "hds_ctest", "READ", &loc1, status );
+   datAnnul( &loc1, status );
+
+/* Tuning parameter names are not case sensitive */
+   hdsTune( "pagebuf", 0, status );
+   hdsGtune( "PageBuf", &ival, status );
+   cmpszints( ival, 0, status );
+
+   if( *status == SAI__OK ) {
+      printf( "TestCompact passed\n" );
+   } else {
+      emsRep( " ", "TestCompact failed", status );
+   }
+}
 
 
 
@@ -127,28 +127,41 @@ int hdsTrace(const HDSLoc *locator, int  *nlev, char *path_str,
   objid = dat1RetrieveIdentifier( locator, status );
   if (*status != SAI__OK) return *status;
 
-  /* First we get the path of the object */
-  objid_to_name( objid, 0, path_str, path_length, status );
+  /* First we get the path of the object. This is normally cached in the
+     Handle, but we fall back to asking HDF5 if there is no Handle. */
+  if (locator->handle) {
+    char *tempstr = dat1HandlePath( locator->handle, objid, 0, nlev, status );
+    if (tempstr) {
+      one_strlcpy( path_str, tempstr, path_length, status );
+      MEM_FREE( tempstr );
+    }
+  } else {
+    size_t i;
+    size_t lenstr;
+    objid_to_name( objid, 0, path_str, path_length, status );
+
+    /* Now walk through the string replacing "/" with "." */
+    if (*status == SAI__OK) {
+      lenstr = strlen(path_str);
+      for (i = 0; i < lenstr; i++) {
+        if ( path_str[i] == '/' ) {
+          path_str[i] = '.';
+          (*nlev)++;
+        }
+      }
+      /* the level is one more than the number of dots we found
+         (assuming that objid_to_name did not return the
+         root ".") */
+      (*nlev)++;
+    }
+  }
 
-  /* Now walk through the string replacing "/" with "." */
   if (*status == SAI__OK) {
     hdsdim lower[DAT__MXDIM];
     hdsdim upper[DAT__MXDIM];
     char subscriptstr[2 + 2 * (VAL__SZK + 2 ) * DAT__MXDIM + 1]; /* "(a1:a2,b,c,d,...)" */
     int rank;
-    size_t i;
     hdsbool_t issubset = 0;
-    size_t lenstr = strlen(path_str);
-    for (i = 0; i < lenstr; i++) {
-      if ( path_str[i] == '/' ) {
-        path_str[i] = '.';
-        (*nlev)++;
-      }
-    }
-    /* the level is one more than the number of dots we found
-       (assuming that objid_to_name did not return the
-       root ".") */
-    (*nlev)++;
 
     /* if this is a slice or a cell of a primitive object then
        we need to include that information in the full path name */
@@ -162,7 +175,15 @@ int hdsTrace(const HDSLoc *locator, int  *nlev, char *path_str,
   }
 
   /* Now the file name */
-  objid_to_name( objid, 1, file_str, file_length, status );
+  if (locator->handle) {
+    char *tempstr = dat1HandlePath( locator->handle, objid, 1, NULL, status );
+    if (tempstr) {
+      one_strlcpy( file_str, tempstr, file_length, status );
+      MEM_FREE( tempstr );
+    }
+  } else {
+    objid_to_name( objid, 1, file_str, file_length, status );
+  }
 
   return *status;
 }
@@ -124,6 +124,13 @@ datErmsg_v5(int status, size_t *len, char *msg_str);
 int
 datFind_v5(const HDSLoc *locator1, const char *name_str, HDSLoc **locator2, int *status);
 
+/*======================================*/
+/* datFindPath - Find component by path */
+/*======================================*/
+
+int
+datFindPath_v5(const HDSLoc *locator1, const char *path_str, HDSLoc **locator2, int *status);
+
 /*============================*/
 /* datGet - Read primitive(s) */
 /*============================*/
@@ -131,6 +138,13 @@ datFind_v5(const HDSLoc *locator1, const char *name_str, HDSLoc **locator2, int
 int
 datGet_v5(const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims[], void *values, int *status);
 
+/*=======================================*/
+/* datGetBatch - Read several components */
+/*=======================================*/
+
+int
+datGetBatch_v5(const HDSLoc *locator, size_t nitem, HDSBatchItem items[], int *status);
+
 /*===================================*/
 /* datGetC - Read _CHAR primitive(s) */
 /*===================================*/
@@ -342,6 +356,12 @@ datGetVR_v5(const HDSLoc * locator, size_t maxval, float values[], size_t *actva
 int
 datGetVL_v5(const HDSLoc * locator, size_t maxval, hdsbool_t values[], size_t *actval, int * status);
 
+/*=====================================================*/
+/* datGetRegion - Read primitive(s) into part of array */
+/*=====================================================*/
+
+int
+datGetRegion_v5(const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims[], const hdsdim bufdims[], const hdsdim lower[], void *values, int *status);
 
 /*======================================*/
 /* datIndex - Index into component list */
@@ -350,6 +370,13 @@ datGetVL_v5(const HDSLoc * locator, size_t maxval, hdsbool_t values[], size_t *a
 int
 datIndex_v5(const HDSLoc *locator1, int index, HDSLoc **locator2, int *status);
 
+/*================================================*/
+/* datIterate - Iterate over structure components */
+/*================================================*/
+
+int
+datIterate_v5(const HDSLoc *locator, hdsbool_t opencomp, datIterFunc func, void *data, int *status);
+
 /*===================================*/
 /* datLen - Inquire primitive length */
 /*===================================*/
@@ -379,6 +406,13 @@ datLocked_v5( const HDSLoc *locator, int recursive, int *status);
 int
 datMap_v5(HDSLoc *locator, const char *type_str, const char *mode_str, int ndim, const hdsdim dims[], void **pntr, int *status);
 
+/*==========================================================*/
+/* datMapAdvise - Specify the access pattern of mapped data */
+/*==========================================================*/
+
+int
+datMapAdvise_v5(HDSLoc *locator, const char *pattern_str, int *status);
+
 /*==================================*/
 /* datMapC - Map _CHAR primitive(s) */
 /*==================================*/
@@ -629,6 +663,13 @@ datParen_v5(const HDSLoc *locator1, HDSLoc **locator2, int *status);
 int
 datPrec_v5(const HDSLoc *locator, size_t *nbytes, int *status);
 
+/*======================================================*/
+/* datPrefetch - Start reading values in the background */
+/*======================================================*/
+
+int
+datPrefetch_v5(const HDSLoc *locator, const char *type_str, int *status);
+
 /*====================================*/
 /* datPrim - Enquire object primitive */
 /*====================================*/
@@ -706,6 +747,13 @@ datPutL_v5(const HDSLoc *locator, int ndim, const hdsdim dims[], const hdsbool_t
 int
 datPut_v5(const HDSLoc *locator, const char *type_str, int ndim, const hdsdim dims[], const void *values, int *status);
 
+/*========================================*/
+/* datPutBatch - Write several components */
+/*========================================*/
+
+int
+datPutBatch_v5(const HDSLoc *locator, size_t nitem, HDSBatchItem items[], int *status);
+
 /*=======================================*/
 /* datPut0C - Write scalar string value  */
 /*=======================================*/
@@ -1070,6 +1118,13 @@ hdsLink_v5(HDSLoc *locator, const char *group_str, int *status);
 int
 hdsLock_v5(const HDSLoc *locator, int *status);
 
+/*====================================================*/
+/* hdsMetrics - Return a snapshot of run time metrics */
+/*====================================================*/
+
+int
+hdsMetrics_v5(char *buffer, size_t buflen, int *status);
+
 /*====================================*/
 /* hdsNew - Create new container file */
 /*====================================*/
@@ -1112,6 +1167,13 @@ hdsState_v5(hdsbool_t *state, int *status);
 int
 hdsStop_v5(int *status);
 
+/*================================================*/
+/* hdsSync - Wait for background writes to finish */
+/*================================================*/
+
+int
+hdsSync_v5(int *status);
+
 /*==============================*/
 /* hdsTrace - Trace object path */
 /*==============================*/
@@ -14,7 +14,9 @@
 #define datErase datErase_v5
 #define datErmsg datErmsg_v5
 #define datFind datFind_v5
+#define datFindPath datFindPath_v5
 #define datGet datGet_v5
+#define datGetBatch datGetBatch_v5
 #define datGetC datGetC_v5
 #define datGetD datGetD_v5
 #define datGetI datGetI_v5
@@ -45,11 +47,14 @@
 #define datGetVK datGetVK_v5
 #define datGetVR datGetVR_v5
 #define datGetVL datGetVL_v5
+#define datGetRegion datGetRegion_v5
 #define datIndex datIndex_v5
+#define datIterate datIterate_v5
 #define datLen datLen_v5
 #define datLock datLock_v5
 #define datLocked datLocked_v5
 #define datMap datMap_v5
+#define datMapAdvise datMapAdvise_v5
 #define datMapC datMapC_v5
 #define datMapD datMapD_v5
 #define datMapI datMapI_v5
@@ -85,6 +90,7 @@
 #define datNew1R datNew1R_v5
 #define datParen datParen_v5
 #define datPrec datPrec_v5
+#define datPrefetch datPrefetch_v5
 #define datPrim datPrim_v5
 #define datPrmry datPrmry_v5
 #define datPutC datPutC_v5
@@ -96,6 +102,7 @@
 #define datPutR datPutR_v5
 #define datPutL datPutL_v5
 #define datPut datPut_v5
+#define datPutBatch datPutBatch_v5
 #define datPut0C datPut0C_v5
 #define datPut0D datPut0D_v5
 #define datPut0R datPut0R_v5
@@ -146,12 +153,14 @@
 #define hdsInfoI hdsInfoI_v5
 #define hdsLink hdsLink_v5
 #define hdsLock hdsLock_v5
+#define hdsMetrics hdsMetrics_v5
 #define hdsIsOpen hdsIsOpen_v5
 #define hdsNew hdsNew_v5
 #define hdsOpen hdsOpen_v5
 #define hdsShow hdsShow_v5
 #define hdsState hdsState_v5
 #define hdsStop hdsStop_v5
+#define hdsSync hdsSync_v5
 #define hdsTrace hdsTrace_v5
 #define hdsTune hdsTune_v5
 #define hdsWild hdsWild_v5
@@ -0,0 +1,470 @@
+/* Single source file holding the I/O thread used by datPrefetch and by
+ * write-behind in datUnmap, and the routines used to queue requests for
+ * it and to wait for the results. Keeping them together lets them share
+ * the request queue.
+ *
+ * There is a single I/O thread, started the first time it is needed.
+ * Requests are performed in the order they were queued, so a read
+ * queued after a write to the same object sees the written values. The
+ * thread only makes HDF5 calls, which are serialised by the HDF5 library
+ * itself, and reports errors solely through the status stored in the
+ * request, since EMS must not be used from a thread that does not own
+ * the locator. The thread that queued a request retains its HDS lock on
+ * the object throughout.
+ *
+ * A prefetch is always completed before its locator is used to read,
+ * write or annul the object. Each request holds its own reference to the
+ * dataset, so the locator can be annulled, or its dataset replaced,
+ * straight away. Every write to an object, through any locator, first
+ * increments the "nwritten" field of its Handle using hds1WriteNote, and
+ * prefetched data is thrown away if that has changed since the read was
+ * queued.
+ *
+ * Anything else that accesses an object waits for its pending writes
+ * using hds1WriteWait, which is also where errors from failed writes to
+ * that object are reported. Operations on a whole tree of objects, and
+ * the closing of a container file, wait for the pending writes to any
+ * object in the same file using hds1WriteWaitFile, which also reports
+ * the failed writes to those objects. Writes to other files carry on.
+ * Each write is counted in the "nwrites" field of the Handle of its
+ * object and in the "nwrites_file" field of the top level Handle of its
+ * file, which lasts as long as the file is open.
+ */
+
+#include <pthread.h>
+#include <string.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+#include "f77.h"
+
+/* The queue of requests waiting for the I/O thread */
+static HdsAsyncIO *queue_head = NULL;
+static HdsAsyncIO *queue_tail = NULL;
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond = PTHREAD_COND_INITIALIZER;
+
+/* Signalled by the I/O thread whenever a write completes. Uses
+   "queue_mutex". */
+static pthread_cond_t done_cond = PTHREAD_COND_INITIALIZER;
+
+/* Number of writes queued but not complete, and the total size of their
+   buffers. Protected by "queue_mutex", as are the "nwrites" and
+   "nwritten" fields of each Handle. */
+static size_t nwrites_pending = 0;
+static size_t nbytes_pending = 0;
+
+/* Writes that have failed but not yet been reported, with the Handle of
+   the object and the top level Handle of its file. The Handles are only
+   ever compared with those supplied by later callers, as the Handle of
+   the object may have been freed by then. Failures are always reported
+   before the file is closed and its top level Handle freed. */
+typedef struct WriteFailure {
+  char name[DAT__SZNAM+1];
+  int status;
+  const Handle *handle;
+  const Handle *top;
+  struct WriteFailure *next;
+} WriteFailure;
+static WriteFailure *failures = NULL;
+
+/* Used to start the I/O thread exactly once */
+static pthread_once_t starter = PTHREAD_ONCE_INIT;
+static int start_error = 0;
+
+static void hds1StartIOThread( void );
+static void *hds1IOThread( void *arg );
+static void hds1CompleteWrite( HdsAsyncIO *request );
+static Handle *hds1TopHandle( Handle *handle );
+static void hds1ReportFailures( WriteFailure *failed, int *status );
+
+/* Add a request to the queue, starting the I/O thread if needed. The
+   request must have been fully initialised, with "done" false. */
+void
+hds1PrefetchQueue( HdsAsyncIO *prefetch, int *status ) {
+  if (*status != SAI__OK) return;
+
+  pthread_once( &starter, hds1StartIOThread );
+  if (start_error) {
+    *status = DAT__FATAL;
+    emsRep( "hds1PrefetchQueue", "Unable to start the HDS I/O thread",
+            status );
+    return;
+  }
+
+  prefetch->next = NULL;
+  pthread_mutex_lock( &queue_mutex );
+  prefetch->nwritten = prefetch->handle->nwritten;
+  if (queue_tail) {
+    queue_tail->next = prefetch;
+  } else {
+    queue_head = prefetch;
+  }
+  queue_tail = prefetch;
+  pthread_cond_signal( &queue_cond );
+  pthread_mutex_unlock( &queue_mutex );
+}
+
+/* Detach any prefetch request from the locator, waiting for it to
+   complete. If the read succeeded, was for the requested normalised type
+   and the object has not been written since the read was queued, the
+   buffer (allocated with cnfMalloc) and its size are returned
+   and become the responsibility of the caller. Otherwise the buffer is
+   freed and false is returned. A NULL "type" just discards the request.
+   Runs regardless of the inherited status, since it is needed for
+   cleaning up. */
+hdsbool_t
+hds1PrefetchTake( HDSLoc *locator, const char *type, void **buffer,
+                  size_t *nbytes ) {
+  HdsAsyncIO *prefetch;
+  hdsbool_t result = HDS_FALSE;
+  hdsbool_t stale;
+
+  if (!locator || !locator->prefetch) return HDS_FALSE;
+  prefetch = locator->prefetch;
+  locator->prefetch = NULL;
+
+  pthread_mutex_lock( &(prefetch->mutex) );
+  while (!prefetch->done) {
+    pthread_cond_wait( &(prefetch->cond), &(prefetch->mutex) );
+  }
+  pthread_mutex_unlock( &(prefetch->mutex) );
+
+  pthread_mutex_lock( &queue_mutex );
+  stale = ( prefetch->handle &&
+            prefetch->handle->nwritten != prefetch->nwritten );
+  pthread_mutex_unlock( &queue_mutex );
+
+  if (type && !stale && prefetch->status == SAI__OK &&
+      strcmp( type, prefetch->type ) == 0) {
+    *buffer = prefetch->buffer;
+    *nbytes = prefetch->nbytes;
+    result = HDS_TRUE;
+  } else if (prefetch->buffer) {
+    cnfFree( prefetch->buffer );
+  }
+
+  if (prefetch->memtype > 0) H5Tclose( prefetch->memtype );
+  if (prefetch->filespace_id > 0) H5Sclose( prefetch->filespace_id );
+  if (prefetch->dataset_id > 0) H5Idec_ref( prefetch->dataset_id );
+  pthread_cond_destroy( &(prefetch->cond) );
+  pthread_mutex_destroy( &(prefetch->mutex) );
+  MEM_FREE( prefetch );
+
+  return result;
+}
+
+/* Wait for and throw away any prefetched data. Used before the object
+   is modified or the locator annulled, and before the locator's dataset
+   identifier is replaced. */
+void
+hds1PrefetchDiscard( HDSLoc *locator ) {
+  if (locator && locator->prefetch) {
+    hds1PrefetchTake( locator, NULL, NULL, NULL );
+  }
+}
+
+static void hds1StartIOThread( void ) {
+  pthread_t thread;
+  pthread_attr_t attr;
+
+  pthread_attr_init( &attr );
+  pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+  if (pthread_create( &thread, &attr, hds1IOThread, NULL ) != 0) {
+    start_error = 1;
+  }
+  pthread_attr_destroy( &attr );
+}
+
+/* Main loop of the I/O thread */
+static void *hds1IOThread( void *arg ) {
+  HdsAsyncIO *request;
+  hid_t mem_dataspace_id;
+  hsize_t npoints;
+  herr_t herr;
+  int rstatus;
+
+  while (1) {
+    pthread_mutex_lock( &queue_mutex );
+    while (!queue_head) pthread_cond_wait( &queue_cond, &queue_mutex );
+    request = queue_head;
+    queue_head = request->next;
+    if (!queue_head) queue_tail = NULL;
+    pthread_mutex_unlock( &queue_mutex );
+
+    /* Transfer the selected elements to or from a dense buffer, laid out
+       exactly as datGet and datPut would. */
+    rstatus = SAI__OK;
+    npoints = H5Sget_select_npoints( request->filespace_id );
+    mem_dataspace_id = H5Screate_simple( 1, &npoints, NULL );
+    if (mem_dataspace_id < 0) {
+      herr = -1;
+    } else if (request->writing) {
+      herr = H5Dwrite( request->dataset_id, request->memtype, mem_dataspace_id,
+                       request->filespace_id, request->dxpl, request->buffer );
+    } else {
+      herr = H5Dread( request->dataset_id, request->memtype, mem_dataspace_id,
+                      request->filespace_id, request->dxpl, request->buffer );
+    }
+    if (herr < 0) {
+      rstatus = DAT__HDF5E;
+      H5Eclear2( H5E_DEFAULT );
+    }
+    if (mem_dataspace_id > 0) H5Sclose( mem_dataspace_id );
+
+    if (request->writing) {
+      request->status = rstatus;
+      hds1CompleteWrite( request );
+    } else {
+      pthread_mutex_lock( &(request->mutex) );
+      request->status = rstatus;
+      request->done = HDS_TRUE;
+      pthread_cond_broadcast( &(request->cond) );
+      pthread_mutex_unlock( &(request->mutex) );
+    }
+  }
+
+  return arg;
+}
+
+/* Release the resources of a finished write and tell any waiting
+   threads. Called by the I/O thread. */
+static void hds1CompleteWrite( HdsAsyncIO *request ) {
+  WriteFailure *failure = NULL;
+
+  cnfFree( request->buffer );
+  H5Tclose( request->memtype );
+  H5Sclose( request->filespace_id );
+
+  if (request->status != SAI__OK) {
+    failure = MEM_CALLOC( 1, sizeof(*failure) );
+    if (failure) {
+      strcpy( failure->name, request->name );
+      failure->status = request->status;
+      failure->handle = request->handle;
+      failure->top = request->top;
+    }
+  }
+  H5Idec_ref( request->dataset_id );
+
+  pthread_mutex_lock( &queue_mutex );
+  request->handle->nwrites--;
+  request->top->nwrites_file--;
+  nwrites_pending--;
+  nbytes_pending -= request->nbytes;
+  if (failure) {
+    failure->next = failures;
+    failures = failure;
+  }
+  pthread_cond_broadcast( &done_cond );
+  pthread_mutex_unlock( &queue_mutex );
+
+  MEM_FREE( request );
+}
+
+/* Hand the memory mapped by a locator to the I/O thread to be written.
+   Returns true if this was done, in which case the locator no longer
+   owns the memory. Returns false, having done nothing, if write-behind
+   is disabled or not possible for this mapping. Blocks while the
+   memory held by pending writes would exceed the WRITEBEHIND limit. */
+hdsbool_t
+hds1WriteBehind( HDSLoc *locator, int *status ) {
+  HdsAsyncIO *request = NULL;
+  char normtypestr[DAT__SZTYP+1];
+  hid_t memtype = 0;
+  hssize_t npoints;
+  size_t limit;
+  size_t nbytes;
+  int convflags;
+
+  limit = (size_t)hds1GetWriteBehind() * 1024 * 1024;
+  if (*status != SAI__OK || limit == 0) return HDS_FALSE;
+
+  /* Only memory that we allocated with cnfMalloc can be handed over */
+  if (locator->pntr || locator->ishuge || !locator->regpntr ||
+      locator->dataset_id <= 0) {
+    return HDS_FALSE;
+  }
+
+  /* The I/O thread can only do conversions that HDF5 can do */
+  if (locator->isbasic) {
+    memtype = H5Dget_type( locator->dataset_id );
+    if (memtype < 0) memtype = 0;
+  } else if (dau1CheckType( 1, locator->maptype, &memtype, normtypestr,
+                            sizeof(normtypestr), status )) {
+    convflags = dat1ConvFlags( dat1Type( locator, status ),
+                               dau1HdsType( memtype, status ) );
+    if (convflags & (HDS__CONV_CHAR|HDS__CONV_LOGICAL)) {
+      H5Tclose( memtype );
+      memtype = 0;
+    }
+  }
+  if (memtype <= 0 || *status != SAI__OK) goto CLEANUP;
+
+  npoints = H5Sget_select_npoints( locator->dataspace_id );
+  if (npoints < 0) goto CLEANUP;
+  nbytes = H5Tget_size( memtype ) * (size_t)npoints;
+  if (nbytes > limit) goto CLEANUP;
+
+  pthread_once( &starter, hds1StartIOThread );
+  if (start_error) goto CLEANUP;
+
+  request = MEM_CALLOC( 1, sizeof(*request) );
+  if (!request) goto CLEANUP;
+  request->filespace_id = H5Scopy( locator->dataspace_id );
+  if (request->filespace_id < 0) goto CLEANUP;
+  datName( locator, request->name, status );
+  request->dxpl = dat1XferProps( status );
+  if (*status != SAI__OK) goto CLEANUP;
+
+  request->writing = HDS_TRUE;
+  request->status = SAI__OK;
+  request->dataset_id = locator->dataset_id;
+  H5Iinc_ref( request->dataset_id );
+  request->memtype = memtype;
+  memtype = 0;
+  request->buffer = locator->regpntr;
+  request->nbytes = nbytes;
+  request->handle = locator->handle;
+  request->top = hds1TopHandle( locator->handle );
+
+  pthread_mutex_lock( &queue_mutex );
+  while (nbytes_pending > 0 && nbytes_pending + nbytes > limit) {
+    pthread_cond_wait( &done_cond, &queue_mutex );
+  }
+  nbytes_pending += nbytes;
+  nwrites_pending++;
+  request->handle->nwrites++;
+  request->top->nwrites_file++;
+  request->handle->nwritten++;
+  request->next = NULL;
+  if (queue_tail) {
+    queue_tail->next = request;
+  } else {
+    queue_head = request;
+  }
+  queue_tail = request;
+  pthread_cond_signal( &queue_cond );
+  pthread_mutex_unlock( &queue_mutex );
+
+  dat1CountIO( locator->handle, HDS__IO_WRITE, nbytes );
+  locator->regpntr = NULL;
+  return HDS_TRUE;
+
+ CLEANUP:
+  if (request) {
+    if (request->filespace_id > 0) H5Sclose( request->filespace_id );
+    MEM_FREE( request );
+  }
+  if (memtype > 0) H5Tclose( memtype );
+  return HDS_FALSE;
+}
+
+/* Wait until there are no pending background writes to the object
+   described by the supplied Handle, or to any object if "handle" is
+   NULL. Then report any writes to that object, or to any object if
+   "handle" is NULL, that have failed since they were last reported. This
+   is done even if status is set on entry. */
+void
+hds1WriteWait( const Handle *handle, int *status ) {
+  WriteFailure *failed = NULL;
+  WriteFailure **prev;
+  WriteFailure *next;
+
+  pthread_mutex_lock( &queue_mutex );
+  if (nwrites_pending == 0 && !failures) {
+    pthread_mutex_unlock( &queue_mutex );
+    return;
+  }
+  while (handle ? handle->nwrites > 0 : nwrites_pending > 0) {
+    pthread_cond_wait( &done_cond, &queue_mutex );
+  }
+  prev = &failures;
+  while (*prev) {
+    next = (*prev)->next;
+    if (!handle || (*prev)->handle == handle) {
+      (*prev)->next = failed;
+      failed = *prev;
+      *prev = next;
+    } else {
+      prev = &((*prev)->next);
+    }
+  }
+  pthread_mutex_unlock( &queue_mutex );
+
+  hds1ReportFailures( failed, status );
+}
+
+/* Wait until there are no pending background writes to any object in
+   the container file holding the object described by the supplied
+   Handle. Then report any writes to objects in that file that have
+   failed since they were last reported. This is done even if status is
+   set on entry. */
+void
+hds1WriteWaitFile( const Handle *handle, int *status ) {
+  WriteFailure *failed = NULL;
+  WriteFailure **prev;
+  WriteFailure *next;
+  const Handle *top;
+
+  if (!handle) return;
+  top = hds1TopHandle( (Handle *) handle );
+
+  pthread_mutex_lock( &queue_mutex );
+  while (top->nwrites_file > 0) {
+    pthread_cond_wait( &done_cond, &queue_mutex );
+  }
+  prev = &failures;
+  while (*prev) {
+    next = (*prev)->next;
+    if ((*prev)->top == top) {
+      (*prev)->next = failed;
+      failed = *prev;
+      *prev = next;
+    } else {
+      prev = &((*prev)->next);
+    }
+  }
+  pthread_mutex_unlock( &queue_mutex );
+
+  hds1ReportFailures( failed, status );
+}
+
+/* Report and free a list of failed writes */
+static void hds1ReportFailures( WriteFailure *failed, int *status ) {
+  WriteFailure *next;
+
+  while (failed) {
+    next = failed->next;
+    if (*status == SAI__OK) *status = failed->status;
+    emsRepf( "hds1WriteWait", "Background write of data to '%s' failed",
+             status, failed->name );
+    MEM_FREE( failed );
+    failed = next;
+  }
+}
+
+/* Return the top level Handle of the file holding the object described
+   by the supplied Handle. Objects are only ever moved within a file, so
+   this does not change. */
+static Handle *hds1TopHandle( Handle *handle ) {
+  while (handle->parent) handle = handle->parent;
+  return handle;
+}
+
+/* Record that the object described by the supplied Handle is about to be
+   written, so that any data prefetched from it through another locator
+   is not used. Must be called before every write to a dataset. */
+void
+hds1WriteNote( Handle *handle ) {
+  if (!handle) return;
+  pthread_mutex_lock( &queue_mutex );
+  handle->nwritten++;
+  pthread_mutex_unlock( &queue_mutex );
+}
@@ -0,0 +1,455 @@
+/* Single source file holding the direct chunk transfer used by datGet,
+ * datPut and the copying modes of datMap and datUnmap, and the pool of
+ * threads that shares out its work.
+ *
+ * When a primitive is stored in chunks (see the CHUNK tuning parameter),
+ * the values selected by a locator cover whole chunks and no type
+ * conversion is needed, each chunk is read or written in its stored form
+ * with H5Dread_chunk or H5Dwrite_chunk and copied to or from its place in
+ * the caller's buffer. Chunks at the upper edge of the array count as
+ * whole if the selection runs to the edge. This avoids the general
+ * selection and filter machinery of HDF5, which handles one chunk at a
+ * time in the calling thread. Chunks compressed with the deflate filter
+ * (see the COMPRESS tuning parameter) are compressed and decompressed
+ * here using zlib, so that this is done for several chunks at once.
+ * Anything else, including chunks that have not been written yet and
+ * other filters, is left to H5Dread and H5Dwrite.
+ *
+ * The chunks of a transfer are shared between the calling thread and up
+ * to CHUNKIO-1 threads from the pool, which are started when first needed
+ * and then wait for further work. Each thread takes the next chunk not
+ * yet started. HDF5 calls are serialised by the HDF5 library itself, so
+ * only the copying and compression happen in parallel. The pool threads
+ * make no EMS calls. If any chunk cannot be transferred, the caller is
+ * told to transfer the whole selection the normal way, which rewrites or
+ * rereads any chunks that were done, and reports any error.
+ */
+
+#if HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if HAVE_ZLIB_H && HAVE_LIBZ
+#  include <zlib.h>
+#  define HDS1_HAVE_ZLIB 1
+#endif
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+/* A transfer of whole chunks. The shape of the selection, the chunks and
+   the buffer are given in HDF5 (C) order. */
+typedef struct ChunkJob {
+  hid_t dataset_id;            /* Dataset to transfer */
+  hdsbool_t writing;           /* Writing rather than reading? */
+  unsigned char *buffer;       /* Caller's buffer */
+  int rank;                    /* Number of dimensions */
+  hsize_t start[DAT__MXDIM];   /* First selected element on each axis */
+  hsize_t count[DAT__MXDIM];   /* Number selected on each axis */
+  hsize_t cdims[DAT__MXDIM];   /* Chunk dimensions */
+  hsize_t ngrid[DAT__MXDIM];   /* Number of chunks on each axis */
+  size_t elsize;               /* Bytes per element */
+  size_t chunkbytes;           /* Bytes per uncompressed chunk */
+  int level;                   /* Deflate level, zero if not compressed */
+  size_t nchunk;               /* Number of chunks */
+  size_t next;                 /* Next chunk to start */
+  size_t ndone;                /* Number of chunks finished */
+  int nhelper;                 /* Number of pool threads working on it */
+  int maxhelper;               /* Largest number that may do so */
+  hdsbool_t failed;            /* Has any chunk failed? */
+  pthread_cond_t done_cond;    /* Signalled when all chunks are finished */
+  struct ChunkJob *nextjob;    /* Next job waiting for pool threads */
+} ChunkJob;
+
+/* Jobs that still have chunks not yet started, and the number of pool
+   threads. Protected by "pool_mutex". */
+static ChunkJob *jobs = NULL;
+static int nworker = 0;
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+
+static hdsbool_t hds1ChunkSetup( const HDSLoc *locator, hid_t h5type,
+                                 ChunkJob *job );
+static void hds1ChunkRun( ChunkJob *job );
+static hdsbool_t hds1ChunkOne( ChunkJob *job, size_t ichunk );
+static void hds1ChunkCopy( ChunkJob *job, const hsize_t offset[],
+                           unsigned char *chunk, hdsbool_t tochunk );
+static void hds1ChunkWorkers( int nwanted );
+static void *hds1ChunkThread( void *arg );
+
+/* Read or write the values selected by "locator" directly from or to the
+   chunks of the dataset. "h5type" is the memory type of the values in
+   "buffer", which are held densely in the order used by H5Dread. Returns
+   true if the transfer has been done and false if it should instead be
+   made by calling H5Dread or H5Dwrite, either because it is unsuitable
+   or because it failed. */
+hdsbool_t
+hds1ChunkIO( const HDSLoc *locator, hid_t h5type, hdsbool_t writing,
+             void *buffer, int *status ) {
+  ChunkJob job;
+  ChunkJob **prev;
+  int nthread;
+
+  if (*status != SAI__OK) return HDS_FALSE;
+
+  nthread = hds1GetChunkIO();
+  if (nthread <= 0) return HDS_FALSE;
+
+  memset( &job, 0, sizeof(job) );
+  job.dataset_id = locator->dataset_id;
+  job.writing = writing;
+  job.buffer = buffer;
+  if (!hds1ChunkSetup( locator, h5type, &job )) return HDS_FALSE;
+  if (writing) hds1WriteNote( locator->handle );
+
+  /* Let pool threads help if there is more than one chunk */
+  job.maxhelper = nthread - 1;
+  if ((size_t)job.maxhelper > job.nchunk - 1) job.maxhelper = job.nchunk - 1;
+
+  if (job.maxhelper > 0) {
+    hds1ChunkWorkers( job.maxhelper );
+    pthread_cond_init( &job.done_cond, NULL );
+    pthread_mutex_lock( &pool_mutex );
+    job.nextjob = jobs;
+    jobs = &job;
+    pthread_cond_broadcast( &pool_cond );
+    pthread_mutex_unlock( &pool_mutex );
+  }
+
+  hds1ChunkRun( &job );
+
+  if (job.maxhelper > 0) {
+    pthread_mutex_lock( &pool_mutex );
+    for (prev = &jobs; *prev; prev = &((*prev)->nextjob)) {
+      if (*prev == &job) {
+        *prev = job.nextjob;
+        break;
+      }
+    }
+    while (job.ndone < job.nchunk || job.nhelper > 0) {
+      pthread_cond_wait( &job.done_cond, &pool_mutex );
+    }
+    pthread_mutex_unlock( &pool_mutex );
+    pthread_cond_destroy( &job.done_cond );
+  }
+
+  return (job.failed ? HDS_FALSE : HDS_TRUE);
+}
+
+/* Fill in the shape of a transfer of the values selected by "locator",
+   returning false if it does not consist of whole chunks or if the
+   chunks cannot be handled here */
+static hdsbool_t hds1ChunkSetup( const HDSLoc *locator, hid_t h5type,
+                                 ChunkJob *job ) {
+  hid_t dcpl = 0;
+  hid_t filetype = 0;
+  hsize_t dims[DAT__MXDIM];
+  hsize_t end[DAT__MXDIM];
+  hsize_t nsel = 1;
+  hssize_t npoints;
+  H5S_sel_type seltype;
+  hdsbool_t result = HDS_FALSE;
+  int nfilter;
+  int i;
+
+  if (locator->dataset_id <= 0 || locator->dataspace_id <= 0) return result;
+
+  dcpl = H5Dget_create_plist( locator->dataset_id );
+  if (dcpl < 0 || H5Pget_layout( dcpl ) != H5D_CHUNKED) goto CLEANUP;
+
+  job->rank = H5Pget_chunk( dcpl, DAT__MXDIM, job->cdims );
+  if (job->rank <= 0 ||
+      H5Sget_simple_extent_ndims( locator->dataspace_id ) != job->rank) {
+    goto CLEANUP;
+  }
+
+  /* Only deflate, and only if it can be done here */
+  nfilter = H5Pget_nfilters( dcpl );
+  if (nfilter == 1) {
+#if HDS1_HAVE_ZLIB
+    unsigned int flags;
+    unsigned int values[1] = { 0 };
+    size_t nvalues = 1;
+    if (H5Pget_filter2( dcpl, 0, &flags, &nvalues, values, 0, NULL,
+                        NULL ) != H5Z_FILTER_DEFLATE) goto CLEANUP;
+    job->level = (nvalues > 0 && values[0] > 0 ? values[0] : 1);
+#else
+    goto CLEANUP;
+#endif
+  } else if (nfilter != 0) {
+    goto CLEANUP;
+  }
+
+  /* No type conversion, and no variable length strings */
+  filetype = H5Dget_type( locator->dataset_id );
+  if (filetype < 0 || H5Tget_class( filetype ) == H5T_STRING ||
+      H5Tequal( filetype, h5type ) <= 0) goto CLEANUP;
+  job->elsize = H5Tget_size( filetype );
+
+  /* A single block of elements */
+  if (H5Sget_simple_extent_dims( locator->dataspace_id, dims, NULL ) < 0) {
+    goto CLEANUP;
+  }
+  seltype = H5Sget_select_type( locator->dataspace_id );
+  if (seltype == H5S_SEL_ALL) {
+    for (i = 0; i < job->rank; i++) {
+      job->start[i] = 0;
+      end[i] = dims[i] - 1;
+    }
+  } else if (seltype == H5S_SEL_HYPERSLABS) {
+    if (H5Sget_select_bounds( locator->dataspace_id, job->start, end ) < 0) {
+      goto CLEANUP;
+    }
+  } else {
+    goto CLEANUP;
+  }
+
+  /* Aligned with the chunks at both ends of every axis */
+  job->nchunk = 1;
+  job->chunkbytes = job->elsize;
+  for (i = 0; i < job->rank; i++) {
+    if (dims[i] == 0 || job->cdims[i] == 0) goto CLEANUP;
+    if (job->start[i] % job->cdims[i] != 0) goto CLEANUP;
+    if ((end[i] + 1) % job->cdims[i] != 0 && end[i] + 1 != dims[i]) {
+      goto CLEANUP;
+    }
+    job->count[i] = end[i] - job->start[i] + 1;
+    job->ngrid[i] = (job->count[i] + job->cdims[i] - 1) / job->cdims[i];
+    job->nchunk *= job->ngrid[i];
+    job->chunkbytes *= job->cdims[i];
+    nsel *= job->count[i];
+  }
+
+  npoints = H5Sget_select_npoints( locator->dataspace_id );
+  if (npoints < 0 || (hsize_t)npoints != nsel) goto CLEANUP;
+
+  result = HDS_TRUE;
+
+ CLEANUP:
+  if (filetype > 0) H5Tclose( filetype );
+  if (dcpl > 0) H5Pclose( dcpl );
+  return result;
+}
+
+/* Transfer chunks of "job" until none are left to start, or one fails */
+static void hds1ChunkRun( ChunkJob *job ) {
+  size_t ichunk;
+  hdsbool_t ok;
+
+  while (1) {
+    pthread_mutex_lock( &pool_mutex );
+    if (job->next >= job->nchunk || job->failed) {
+      /* Count anything not started as done so that the caller wakes */
+      job->ndone += job->nchunk - job->next;
+      job->next = job->nchunk;
+      if (job->maxhelper > 0) pthread_cond_broadcast( &job->done_cond );
+      pthread_mutex_unlock( &pool_mutex );
+      return;
+    }
+    ichunk = job->next++;
+    pthread_mutex_unlock( &pool_mutex );
+
+    ok = hds1ChunkOne( job, ichunk );
+
+    pthread_mutex_lock( &pool_mutex );
+    if (!ok) job->failed = HDS_TRUE;
+    job->ndone++;
+    if (job->maxhelper > 0 && job->ndone == job->nchunk) {
+      pthread_cond_broadcast( &job->done_cond );
+    }
+    pthread_mutex_unlock( &pool_mutex );
+  }
+}
+
+/* Transfer chunk "ichunk" of "job", counting in C order. Returns false if
+   this fails. */
+static hdsbool_t hds1ChunkOne( ChunkJob *job, size_t ichunk ) {
+  hsize_t offset[DAT__MXDIM];
+  hsize_t stored = 0;
+  unsigned char *chunk = NULL;
+  unsigned char *packed = NULL;
+  uint32_t mask = 0;
+  size_t idx = ichunk;
+  hdsbool_t result = HDS_FALSE;
+  int i;
+
+  for (i = job->rank - 1; i >= 0; i--) {
+    offset[i] = job->start[i] + (idx % job->ngrid[i]) * job->cdims[i];
+    idx /= job->ngrid[i];
+  }
+
+  chunk = malloc( job->chunkbytes );
+  if (!chunk) goto CLEANUP;
+
+  if (job->writing) {
+    size_t nbytes = job->chunkbytes;
+    unsigned char *out = chunk;
+
+    hds1ChunkCopy( job, offset, chunk, HDS_TRUE );
+
+#if HDS1_HAVE_ZLIB
+    /* Store the chunk uncompressed, marking the filter as skipped, if
+       compression does not make it smaller */
+    if (job->level > 0) {
+      uLongf plen = compressBound( job->chunkbytes );
+      packed = malloc( plen );
+      if (!packed) goto CLEANUP;
+      if (compress2( packed, &plen, chunk, job->chunkbytes,
+                     job->level ) == Z_OK && plen < job->chunkbytes) {
+        out = packed;
+        nbytes = plen;
+      } else {
+        mask = 1;
+      }
+    }
+#endif
+
+    if (H5Dwrite_chunk( job->dataset_id, H5P_DEFAULT, mask, offset, nbytes,
+                        out ) < 0) goto CLEANUP;
+
+  } else {
+    /* Chunks that have not been written hold the fill value, which is
+       left to H5Dread to supply */
+    if (H5Dget_chunk_storage_size( job->dataset_id, offset, &stored ) < 0 ||
+        stored == 0) goto CLEANUP;
+
+    if (job->level > 0) {
+      packed = malloc( stored );
+      if (!packed) goto CLEANUP;
+      if (H5Dread_chunk( job->dataset_id, H5P_DEFAULT, offset, &mask,
+                         packed ) < 0) goto CLEANUP;
+      if (mask & 1) {
+        if (stored != job->chunkbytes) goto CLEANUP;
+        memcpy( chunk, packed, stored );
+      } else {
+#if HDS1_HAVE_ZLIB
+        uLongf clen = job->chunkbytes;
+        if (uncompress( chunk, &clen, packed, stored ) != Z_OK ||
+            clen != job->chunkbytes) goto CLEANUP;
+#else
+        goto CLEANUP;
+#endif
+      }
+    } else {
+      if (stored != job->chunkbytes) goto CLEANUP;
+      if (H5Dread_chunk( job->dataset_id, H5P_DEFAULT, offset, &mask,
+                         chunk ) < 0) goto CLEANUP;
+    }
+
+    hds1ChunkCopy( job, offset, chunk, HDS_FALSE );
+  }
+
+  result = HDS_TRUE;
+
+ CLEANUP:
+  if (!result) H5Eclear2( H5E_DEFAULT );
+  if (packed) free( packed );
+  if (chunk) free( chunk );
+  return result;
+}
+
+/* Copy the part of the selection that lies in the chunk starting at
+   "offset" between the caller's buffer and "chunk", one row of the
+   fastest varying axis at a time. Parts of a chunk beyond the edge of
+   the array are zeroed when writing. */
+static void hds1ChunkCopy( ChunkJob *job, const hsize_t offset[],
+                           unsigned char *chunk, hdsbool_t tochunk ) {
+  hsize_t n[DAT__MXDIM];
+  hsize_t pos[DAT__MXDIM];
+  size_t rowbytes;
+  size_t coff;
+  size_t boff;
+  int last = job->rank - 1;
+  hdsbool_t partial = HDS_FALSE;
+  int i;
+
+  for (i = 0; i <= last; i++) {
+    n[i] = job->start[i] + job->count[i] - offset[i];
+    if (n[i] > job->cdims[i]) n[i] = job->cdims[i];
+    if (n[i] < job->cdims[i]) partial = HDS_TRUE;
+    pos[i] = 0;
+  }
+  if (tochunk && partial) memset( chunk, 0, job->chunkbytes );
+  rowbytes = n[last] * job->elsize;
+
+  while (1) {
+    coff = 0;
+    boff = 0;
+    for (i = 0; i <= last; i++) {
+      coff = coff * job->cdims[i] + (i < last ? pos[i] : 0);
+      boff = boff * job->count[i] + (offset[i] - job->start[i]) +
+        (i < last ? pos[i] : 0);
+    }
+    coff *= job->elsize;
+    boff *= job->elsize;
+    if (tochunk) {
+      memcpy( chunk + coff, job->buffer + boff, rowbytes );
+    } else {
+      memcpy( job->buffer + boff, chunk + coff, rowbytes );
+    }
+
+    /* Next row */
+    for (i = last - 1; i >= 0; i--) {
+      if (++pos[i] < n[i]) break;
+      pos[i] = 0;
+    }
+    if (i < 0) break;
+  }
+}
+
+/* Make sure that the pool has at least "nwanted" threads. Failure to
+   start a thread is not an error, since the caller does the work of any
+   that are missing. */
+static void hds1ChunkWorkers( int nwanted ) {
+  pthread_attr_t attr;
+  pthread_t thread;
+
+  pthread_mutex_lock( &pool_mutex );
+  if (nworker < nwanted) {
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    while (nworker < nwanted) {
+      if (pthread_create( &thread, &attr, hds1ChunkThread, NULL ) != 0) break;
+      nworker++;
+    }
+    pthread_attr_destroy( &attr );
+  }
+  pthread_mutex_unlock( &pool_mutex );
+}
+
+/* Main loop of each pool thread */
+static void *hds1ChunkThread( void *arg ) {
+  ChunkJob *job;
+
+  pthread_mutex_lock( &pool_mutex );
+  while (1) {
+    for (job = jobs; job; job = job->nextjob) {
+      if (job->next < job->nchunk && !job->failed &&
+          job->nhelper < job->maxhelper) break;
+    }
+    if (!job) {
+      pthread_cond_wait( &pool_cond, &pool_mutex );
+      continue;
+    }
+    job->nhelper++;
+    pthread_mutex_unlock( &pool_mutex );
+
+    hds1ChunkRun( job );
+
+    pthread_mutex_lock( &pool_mutex );
+    job->nhelper--;
+    if (job->nhelper == 0) pthread_cond_broadcast( &job->done_cond );
+  }
+
+  pthread_mutex_unlock( &pool_mutex );
+  return arg;
+}
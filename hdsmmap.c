@@ -0,0 +1,238 @@
+/* Single source file holding the address window in which primitives
+ * that are memory mapped directly from a container file are placed, and
+ * the allocation of large datMap buffers backed by huge pages.
+ *
+ * A mapped region has to be registered with CNF so that it can be used
+ * from Fortran, and registration fails if the low 32 bits of the address
+ * clash with those of a pointer that is already registered. Mapping at
+ * an address chosen by the kernel therefore needs an unknown number of
+ * mmap/munmap attempts. Instead, a single window smaller than 4GB is
+ * reserved (with no access) the first time it is needed and mappings are
+ * placed inside it with MAP_FIXED. No two addresses in the window share
+ * their low 32 bits, so mappings can never clash with each other and
+ * each map normally needs one system call. Releasing a mapping replaces
+ * it with inaccessible memory again so that the address space stays
+ * reserved.
+ *
+ * Use of the window is managed with one byte per page. Free space is
+ * searched for starting from where the last search ended, so addresses
+ * are not reused straight away.
+ *
+ * Buffers for large primitives that cannot be mapped from the file are
+ * mapped anonymously, on huge pages reserved by the system administrator
+ * if there are enough, or otherwise aligned to a huge page boundary and
+ * marked as suitable for transparent huge pages. Either way they are
+ * much too large to fit in the window, so they are registered with CNF
+ * directly.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+#include "f77.h"
+
+/* Size of the reserved window. Must be less than 4GB. */
+#define HDS1_WINDOW_BYTES ((size_t)1 << 30)
+
+static char *window = NULL;     /* Start of the window, NULL if unavailable */
+static size_t window_pages = 0; /* Number of pages in the window */
+static size_t pagesize = 0;     /* System page size */
+static unsigned char *inuse = NULL; /* Non-zero for each page in use */
+static size_t next_page = 0;    /* Where to start the next search */
+
+/* Size of a huge page */
+#define HDS1_HUGEPAGE_BYTES ((size_t)2 << 20)
+
+/* Number of buffers currently allocated by hds1HugeAlloc */
+static size_t nhuge = 0;
+
+/* Guards "inuse", "next_page" and "nhuge" */
+static pthread_mutex_t window_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Used to reserve the window exactly once */
+static pthread_once_t reserver = PTHREAD_ONCE_INIT;
+
+static void hds1ReserveWindow( void );
+
+/* Map "nbytes" of file "fd", starting at the page-aligned offset "off",
+   at a free address in the window. Returns the address of the mapping,
+   NULL if the window is not available or has no room (in which case the
+   caller should map elsewhere) or MAP_FAILED if mmap fails (with errno
+   set). */
+void *
+hds1WindowMap( size_t nbytes, int prot, int flags, int fd, off_t off ) {
+  size_t npage;
+  size_t first = 0;
+  size_t run = 0;
+  size_t checked;
+  size_t i;
+  void *mapped;
+
+  pthread_once( &reserver, hds1ReserveWindow );
+  if (!window || nbytes == 0) return NULL;
+
+  npage = (nbytes + pagesize - 1) / pagesize;
+  if (npage > window_pages) return NULL;
+
+  /* Find "npage" consecutive free pages, wrapping round at the end of
+     the window if necessary. A run cannot straddle the end. */
+  pthread_mutex_lock( &window_mutex );
+  i = next_page;
+  for (checked = 0; checked < window_pages + npage; checked++) {
+    if (i == window_pages) {
+      i = 0;
+      run = 0;
+    }
+    if (inuse[i]) {
+      run = 0;
+    } else {
+      if (run == 0) first = i;
+      if (++run == npage) break;
+    }
+    i++;
+  }
+  if (run < npage) {
+    pthread_mutex_unlock( &window_mutex );
+    return NULL;
+  }
+  memset( inuse + first, 1, npage );
+  next_page = first + npage;
+  pthread_mutex_unlock( &window_mutex );
+
+  mapped = mmap( window + first*pagesize, nbytes, prot, flags | MAP_FIXED,
+                 fd, off );
+  if (mapped == MAP_FAILED) {
+    pthread_mutex_lock( &window_mutex );
+    memset( inuse + first, 0, npage );
+    pthread_mutex_unlock( &window_mutex );
+  }
+  return mapped;
+}
+
+/* Unmap memory mapped by hds1WindowMap or by a plain mmap. Inside the
+   window the pages are made inaccessible again rather than being
+   returned to the system. Returns zero on success and -1 (with errno
+   set) on failure, like munmap. */
+int
+hds1Munmap( void *addr, size_t nbytes ) {
+  size_t first;
+  size_t npage;
+
+  pthread_once( &reserver, hds1ReserveWindow );
+  if (!window || (char *)addr < window ||
+      (char *)addr >= window + window_pages*pagesize) {
+    return munmap( addr, nbytes );
+  }
+
+  if (mmap( addr, nbytes, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+            -1, 0 ) == MAP_FAILED) return -1;
+
+  first = ((char *)addr - window) / pagesize;
+  npage = (nbytes + pagesize - 1) / pagesize;
+  pthread_mutex_lock( &window_mutex );
+  memset( inuse + first, 0, npage );
+  pthread_mutex_unlock( &window_mutex );
+  return 0;
+}
+
+/* Allocate a zeroed buffer of at least "nbytes" backed by huge pages,
+   and register it with CNF. Returns NULL if this is not possible, in
+   which case the caller should use cnfMalloc. The length of the buffer
+   is returned in "actbytes" and must be passed to hds1HugeFree. */
+void *
+hds1HugeAlloc( size_t nbytes, size_t *actbytes ) {
+  size_t len;
+  char *buf = MAP_FAILED;
+
+  len = (nbytes + HDS1_HUGEPAGE_BYTES - 1) & ~(HDS1_HUGEPAGE_BYTES - 1);
+  if (len == 0) return NULL;
+
+#ifdef MAP_HUGETLB
+  buf = mmap( NULL, len, PROT_READ | PROT_WRITE,
+              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+#endif
+
+  /* Otherwise map an extra huge page and trim both ends so that the
+     buffer is aligned for transparent huge pages */
+  if (buf == MAP_FAILED) {
+    char *raw;
+    size_t lead;
+    raw = mmap( NULL, len + HDS1_HUGEPAGE_BYTES, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if (raw == MAP_FAILED) return NULL;
+    lead = (HDS1_HUGEPAGE_BYTES - (uintptr_t)raw % HDS1_HUGEPAGE_BYTES) %
+      HDS1_HUGEPAGE_BYTES;
+    if (lead > 0) munmap( raw, lead );
+    munmap( raw + lead + len, HDS1_HUGEPAGE_BYTES - lead );
+    buf = raw + lead;
+#ifdef MADV_HUGEPAGE
+    (void)madvise( buf, len, MADV_HUGEPAGE );
+#endif
+  }
+
+  if (cnfRegp( buf ) != 1) {
+    munmap( buf, len );
+    return NULL;
+  }
+
+  pthread_mutex_lock( &window_mutex );
+  nhuge++;
+  pthread_mutex_unlock( &window_mutex );
+
+  *actbytes = len;
+  return buf;
+}
+
+/* Unregister and free a buffer allocated by hds1HugeAlloc. Returns zero
+   on success and -1 (with errno set) on failure, like munmap. */
+int
+hds1HugeFree( void *buf, size_t actbytes ) {
+  cnfUregp( buf );
+  pthread_mutex_lock( &window_mutex );
+  nhuge--;
+  pthread_mutex_unlock( &window_mutex );
+  return munmap( buf, actbytes );
+}
+
+/* Number of buffers currently allocated by hds1HugeAlloc */
+size_t
+hds1HugeCount( void ) {
+  size_t result;
+  pthread_mutex_lock( &window_mutex );
+  result = nhuge;
+  pthread_mutex_unlock( &window_mutex );
+  return result;
+}
+
+/* Reserve the window. If this fails mappings are placed by the kernel
+   as before. */
+static void hds1ReserveWindow( void ) {
+  void *reserved;
+
+  pagesize = sysconf( _SC_PAGESIZE );
+  window_pages = HDS1_WINDOW_BYTES / pagesize;
+
+  inuse = MEM_CALLOC( window_pages, 1 );
+  if (!inuse) return;
+
+  reserved = mmap( NULL, window_pages*pagesize, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+  if (reserved == MAP_FAILED) {
+    MEM_FREE( inuse );
+    inuse = NULL;
+    return;
+  }
+  window = reserved;
+}
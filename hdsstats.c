@@ -0,0 +1,319 @@
+/* Single source file holding the call counters and timings gathered
+ * when the STATS tuning parameter is set, and the routines used to
+ * record and report them.
+ *
+ * Each thread accumulates into its own block of counters, so recording
+ * an operation needs no locking. Blocks are never freed, so the counts
+ * from threads that have ended are still reported. A report adds up the
+ * blocks of all threads while they may still be being updated, so it
+ * can be very slightly out of date.
+ *
+ * Latencies are also recorded in a histogram with bins that double in
+ * width, the first holding operations that took less than a microsecond.
+ *
+ * "hds1StatsOn" starts out negative, meaning that the tuning environment
+ * has not been read yet, so that the first timed operation looks at it.
+ * Once read, it holds flags saying whether statistics are being gathered
+ * and whether operations are being traced (see hdstimeline.c), since both
+ * use the same timing points.
+ *
+ * This file also holds the run time metrics reported by hdsInfoI and
+ * hdsMetrics. These are always kept, regardless of STATS, so they are
+ * only updated by operations that are expensive anyway: creating and
+ * freeing Handles, mapping and unmapping primitives, converting data
+ * types and waiting for a Handle mutex that is held by another thread.
+ * They are guarded by a single mutex.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+/* Number of latency histogram bins */
+#define HDS1_STATS_NBIN 24
+
+/* Names of the operations, in the order of hds_stat_t */
+static const char *stat_names[HDS__STAT_MAX] = {
+  "datAnnul", "datBasic", "datCell", "datCopy", "datErase", "datFind",
+  "datGet", "datGetBatch", "datGetRegion", "datIndex", "datMap", "datNew",
+  "datPrefetch", "datPut", "datPutBatch", "datSlice", "datUnmap",
+  "hdsNew", "hdsOpen", "H5Dread", "H5Dwrite", "mmap", "convert",
+  "lockwait"
+};
+
+/* Counters for one operation */
+typedef struct StatCounter {
+  uint64_t ncalls;     /* Number of operations */
+  uint64_t nbytes;     /* Number of bytes transferred */
+  uint64_t total_ns;   /* Total time taken */
+  uint64_t max_ns;     /* Longest time taken */
+  uint64_t hist[HDS1_STATS_NBIN]; /* Histogram of times taken */
+} StatCounter;
+
+/* Counters for all operations performed by one thread */
+typedef struct ThreadStats {
+  StatCounter counters[HDS__STAT_MAX];
+  struct ThreadStats *next;
+} ThreadStats;
+
+int hds1StatsOn = -1;
+
+/* List of all the threads' counters. Protected by "stats_mutex". */
+static ThreadStats *all_stats = NULL;
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Key for each thread's own counters */
+static pthread_key_t stats_key;
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+
+/* Set once the report at exit has been arranged */
+static int atexit_done = 0;
+
+/* The run time metrics. Protected by "metrics_mutex". */
+static HdsMetrics metrics;
+static pthread_mutex_t metrics_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void hds1StatsMakeKey( void );
+static void hds1StatsAtExit( void );
+
+/* Return the current time in nanoseconds, or zero if statistics are not
+   being gathered. Used via HDS1_STATS_BEGIN. */
+uint64_t
+hds1StatsTime( void ) {
+  struct timespec ts;
+  uint64_t result;
+
+  /* The first time through, read the tuning environment */
+  if (hds1StatsOn < 0) {
+    hds1GetStats();
+    if (hds1StatsOn <= 0) return 0;
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  result = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+  return (result ? result : 1);
+}
+
+/* Record an operation of the given type on the object described by
+   "handle" that started at time "start", as returned by hds1StatsTime,
+   and transferred "nbytes" bytes. Used via HDS1_STATS_END. */
+void
+hds1StatsAdd( hds_stat_t stat, uint64_t start, size_t nbytes,
+              const Handle *handle ) {
+  hds1StatsSpan( stat, start, hds1StatsTime(), nbytes, handle );
+}
+
+/* Record an operation that took place between the times "start" and
+   "end". Used instead of hds1StatsAdd when the operation is recorded
+   some time after it ended. Must not be called while holding the mutex
+   of any Handle, since the timeline tracer locks each Handle in turn to
+   read its name. */
+void
+hds1StatsSpan( hds_stat_t stat, uint64_t start, uint64_t end, size_t nbytes,
+               const Handle *handle ) {
+  ThreadStats *tstats;
+  StatCounter *counter;
+  uint64_t elapsed;
+  uint64_t us;
+  int bin = 0;
+
+  if (stat < 0 || stat >= HDS__STAT_MAX) return;
+
+  if (hds1StatsOn & HDS__STATS_TRACE) {
+    hds1TraceAdd( stat_names[stat], start, end, nbytes, handle );
+  }
+  if (!(hds1StatsOn & HDS__STATS_COUNT)) return;
+
+  pthread_once( &key_once, hds1StatsMakeKey );
+  tstats = pthread_getspecific( stats_key );
+  if (!tstats) {
+    tstats = calloc( 1, sizeof(*tstats) );
+    if (!tstats) return;
+    pthread_setspecific( stats_key, tstats );
+    pthread_mutex_lock( &stats_mutex );
+    tstats->next = all_stats;
+    all_stats = tstats;
+    pthread_mutex_unlock( &stats_mutex );
+  }
+
+  elapsed = (end > start ? end - start : 0);
+
+  for (us = elapsed / 1000; us > 0 && bin < HDS1_STATS_NBIN - 1; us >>= 1) {
+    bin++;
+  }
+
+  counter = &(tstats->counters[stat]);
+  counter->ncalls++;
+  counter->nbytes += nbytes;
+  counter->total_ns += elapsed;
+  if (elapsed > counter->max_ns) counter->max_ns = elapsed;
+  counter->hist[bin]++;
+}
+
+/* Start or stop gathering statistics. Called when the STATS tuning
+   parameter is set, including when the tuning environment is first
+   read, which is also when tracing is started if requested. The first
+   time statistics are started, a report is arranged for when the
+   program exits. */
+void
+hds1StatsEnable( hdsbool_t enable ) {
+  hdsbool_t trace = hds1TraceStart();
+  pthread_mutex_lock( &stats_mutex );
+  hds1StatsOn = (enable ? HDS__STATS_COUNT : 0) |
+    (trace ? HDS__STATS_TRACE : 0);
+  if (enable && !atexit_done) {
+    atexit( hds1StatsAtExit );
+    atexit_done = 1;
+  }
+  pthread_mutex_unlock( &stats_mutex );
+}
+
+/* Write the statistics gathered so far, summed over all threads, to
+   standard output and return the total number of operations recorded.
+   If "reset" is true, all counters are then set to zero. */
+size_t
+hds1StatsShow( hdsbool_t reset ) {
+  StatCounter totals[HDS__STAT_MAX];
+  ThreadStats *tstats;
+  size_t ncalls = 0;
+  int nthread = 0;
+  int i;
+  int j;
+
+  memset( totals, 0, sizeof(totals) );
+
+  pthread_mutex_lock( &stats_mutex );
+  for (tstats = all_stats; tstats; tstats = tstats->next) {
+    nthread++;
+    for (i = 0; i < HDS__STAT_MAX; i++) {
+      StatCounter *counter = &(tstats->counters[i]);
+      totals[i].ncalls += counter->ncalls;
+      totals[i].nbytes += counter->nbytes;
+      totals[i].total_ns += counter->total_ns;
+      if (counter->max_ns > totals[i].max_ns) {
+        totals[i].max_ns = counter->max_ns;
+      }
+      for (j = 0; j < HDS1_STATS_NBIN; j++) {
+        totals[i].hist[j] += counter->hist[j];
+      }
+    }
+    if (reset) memset( tstats->counters, 0, sizeof(tstats->counters) );
+  }
+  pthread_mutex_unlock( &stats_mutex );
+
+  printf( "HDS statistics from %d thread%s:\n", nthread,
+          (nthread == 1 ? "" : "s") );
+  printf( "  %-14s %10s %14s %12s %12s %12s\n", "Operation", "Calls",
+          "Bytes", "Total(s)", "Mean(us)", "Max(us)" );
+  for (i = 0; i < HDS__STAT_MAX; i++) {
+    if (totals[i].ncalls == 0) continue;
+    ncalls += totals[i].ncalls;
+    printf( "  %-14s %10llu %14llu %12.6f %12.3f %12.3f\n", stat_names[i],
+            (unsigned long long)totals[i].ncalls,
+            (unsigned long long)totals[i].nbytes,
+            1.0E-9 * totals[i].total_ns,
+            1.0E-3 * totals[i].total_ns / totals[i].ncalls,
+            1.0E-3 * totals[i].max_ns );
+
+    /* Only the bins that are in use, labelled by their lower limit */
+    printf( "  %-14s", "" );
+    for (j = 0; j < HDS1_STATS_NBIN; j++) {
+      if (totals[i].hist[j] == 0) continue;
+      printf( " %s%lluus:%llu", (j == 0 ? "<" : ">="),
+              (unsigned long long)(j == 0 ? 1 : (1ULL << (j-1))),
+              (unsigned long long)totals[i].hist[j] );
+    }
+    printf( "\n" );
+  }
+
+  return ncalls;
+}
+
+/* Add "delta" to the number of Handles in existence */
+void
+hds1MetricsHandle( int delta ) {
+  pthread_mutex_lock( &metrics_mutex );
+  if (delta >= 0 || metrics.nhandle >= (size_t)(-delta)) {
+    metrics.nhandle += delta;
+  }
+  pthread_mutex_unlock( &metrics_mutex );
+}
+
+/* Record a primitive being mapped or unmapped. "type" is one of the
+   mapping types used by dat1CountIO, which calls this. */
+void
+hds1MetricsMap( hds_io_t type, size_t nbytes ) {
+  pthread_mutex_lock( &metrics_mutex );
+  if (type == HDS__IO_MMAP) {
+    metrics.nmmap++;
+    metrics.bytes_mmap += nbytes;
+  } else if (type == HDS__IO_UNMAP) {
+    metrics.bytes_mmap -= (nbytes < metrics.bytes_mmap ? nbytes :
+                           metrics.bytes_mmap);
+  } else if (type == HDS__IO_COPYMAP) {
+    metrics.ncopymap++;
+    metrics.bytes_copymap += nbytes;
+  } else if (type == HDS__IO_UNCOPYMAP) {
+    metrics.bytes_copymap -= (nbytes < metrics.bytes_copymap ? nbytes :
+                              metrics.bytes_copymap);
+  }
+  pthread_mutex_unlock( &metrics_mutex );
+}
+
+/* Record "nelem" elements being converted from type "from" to type "to" */
+void
+hds1MetricsConvert( hdstype_t from, hdstype_t to, size_t nelem ) {
+  if (from <= HDSTYPE_NONE || from >= HDSTYPE_STRUCTURE ||
+      to <= HDSTYPE_NONE || to >= HDSTYPE_STRUCTURE || from == to) return;
+  pthread_mutex_lock( &metrics_mutex );
+  metrics.nconvert[from][to] += nelem;
+  pthread_mutex_unlock( &metrics_mutex );
+}
+
+/* Return the current time in nanoseconds, for timing a wait that is
+   recorded by hds1MetricsLockWait */
+uint64_t
+hds1MetricsClock( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Record a wait for a Handle mutex that began at time "start", as
+   returned by hds1MetricsClock */
+void
+hds1MetricsLockWait( uint64_t start ) {
+  uint64_t now = hds1MetricsClock();
+  pthread_mutex_lock( &metrics_mutex );
+  metrics.nlockwait++;
+  metrics.lockwait_ns += (now > start ? now - start : 0);
+  pthread_mutex_unlock( &metrics_mutex );
+}
+
+/* Return a copy of the run time metrics */
+void
+hds1MetricsCopy( HdsMetrics *copy ) {
+  pthread_mutex_lock( &metrics_mutex );
+  *copy = metrics;
+  pthread_mutex_unlock( &metrics_mutex );
+}
+
+static void hds1StatsMakeKey( void ) {
+  pthread_key_create( &stats_key, NULL );
+}
+
+static void hds1StatsAtExit( void ) {
+  if (hds1StatsOn > 0 && (hds1StatsOn & HDS__STATS_COUNT)) {
+    hds1StatsShow( HDS_FALSE );
+  }
+}
@@ -0,0 +1,327 @@
+/* Single source file holding the optional tracer that records a timeline
+ * of HDS operations, enabled by setting the environment variable
+ * HDS_TRACE_FILE to the name of the file to write.
+ *
+ * Every operation timed by HDS1_STATS_BEGIN and HDS1_STATS_END (see
+ * hdsstats.c) is recorded as a single event giving its start time,
+ * duration, bytes transferred and the HDS path of the object concerned.
+ * The path is formed from the names in the Handle tree at the time of
+ * the event, without calling HDF5, and is truncated if it is very long.
+ * Each name is copied while holding the mutex of its Handle, since the
+ * object may be renamed by another thread.
+ *
+ * Each thread records into its own ring buffer, so recording needs no
+ * locking. When a ring is full the oldest events are overwritten. The
+ * number of events in each ring is given by the environment variable
+ * HDS_TRACE_EVENTS (16384 by default). When a thread ends its ring is
+ * shrunk to the events it holds and is kept, so that they are included
+ * in the trace, but only the rings of the most recent
+ * HDS1_TRACE_MAXENDED threads to end are kept.
+ *
+ * The events are written in the Chrome Trace Event format, which can be
+ * loaded into chrome://tracing or Perfetto, when the program exits and
+ * whenever hdsStop is called. Each write replaces the whole file. Threads
+ * may still be recording while the file is written, so the most recent
+ * events of a busy thread may be missing or incomplete.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "hdf5.h"
+#include "ems.h"
+#include "sae_par.h"
+#include "hds1.h"
+#include "dat1.h"
+#include "hds.h"
+#include "dat_err.h"
+
+/* Default number of events held for each thread */
+#define HDS1_TRACE_NEVENT 16384
+
+/* Number of threads that have ended whose events are kept */
+#define HDS1_TRACE_MAXENDED 64
+
+/* Longest object path recorded, including the terminator */
+#define HDS1_TRACE_SZPATH 96
+
+/* Deepest Handle tree searched for an object path */
+#define HDS1_TRACE_MAXLEV 32
+
+/* One operation */
+typedef struct TraceEvent {
+  const char *name;    /* Operation (a static string) */
+  uint64_t start;      /* Start time in nanoseconds */
+  uint64_t end;        /* End time in nanoseconds */
+  size_t nbytes;       /* Bytes transferred */
+  char path[HDS1_TRACE_SZPATH]; /* HDS path of the object, or empty */
+} TraceEvent;
+
+/* The events recorded by one thread */
+typedef struct TraceRing {
+  int tid;             /* Number identifying the thread in the trace */
+  size_t nevent;       /* Total number of events recorded */
+  size_t size;         /* Number of elements in "events" */
+  int ended;           /* Order in which the thread ended, or zero */
+  TraceEvent *events;
+  struct TraceRing *next;
+} TraceRing;
+
+/* Name of the output file, or NULL if tracing is not enabled */
+static char *trace_file = NULL;
+
+/* Time tracing started, used as the origin of the timeline */
+static uint64_t trace_origin = 0;
+
+/* Number of events held for each thread (HDS_TRACE_EVENTS) */
+static size_t trace_nevent = HDS1_TRACE_NEVENT;
+
+/* List of all the threads' rings, the number of threads seen and the
+   number that have ended. Protected by "trace_mutex", which also
+   serialises writing the file. */
+static TraceRing *all_rings = NULL;
+static int nthread = 0;
+static int nended = 0;
+static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Key for each thread's own ring */
+static pthread_key_t ring_key;
+
+/* Used to read the environment exactly once */
+static pthread_once_t trace_once = PTHREAD_ONCE_INIT;
+
+static void hds1TraceInit( void );
+static void hds1TracePath( const Handle *handle, char *path );
+static void hds1TraceAtExit( void );
+static void hds1TraceEnded( void *arg );
+
+/* Read HDS_TRACE_FILE the first time this is called and return true if
+   operations are to be traced. Called by hds1StatsEnable. */
+hdsbool_t
+hds1TraceStart( void ) {
+  pthread_once( &trace_once, hds1TraceInit );
+  return (trace_file != NULL);
+}
+
+/* Record an operation on the object described by "handle" (which may be
+   NULL) that took place between the times "start" and "end", as returned
+   by hds1StatsTime, and transferred "nbytes" bytes. Called by
+   hds1StatsAdd. */
+void
+hds1TraceAdd( const char *name, uint64_t start, uint64_t end, size_t nbytes,
+              const Handle *handle ) {
+  TraceRing *ring;
+  TraceEvent *event;
+
+  if (!trace_file) return;
+
+  ring = pthread_getspecific( ring_key );
+  if (!ring) {
+    ring = calloc( 1, sizeof(*ring) );
+    if (!ring) return;
+    ring->events = calloc( trace_nevent, sizeof(*(ring->events)) );
+    if (!ring->events) {
+      free( ring );
+      return;
+    }
+    ring->size = trace_nevent;
+    pthread_setspecific( ring_key, ring );
+    pthread_mutex_lock( &trace_mutex );
+    ring->tid = ++nthread;
+    ring->next = all_rings;
+    all_rings = ring;
+    pthread_mutex_unlock( &trace_mutex );
+  }
+
+  event = &(ring->events[ ring->nevent % ring->size ]);
+  event->name = name;
+  event->start = start;
+  event->end = end;
+  event->nbytes = nbytes;
+  hds1TracePath( handle, event->path );
+  ring->nevent++;
+}
+
+/* Write all the events recorded so far to the trace file. Does nothing
+   if tracing is not enabled. Errors are reported on standard error
+   since this may be called while the program exits. */
+void
+hds1TraceWrite( void ) {
+  TraceRing *ring;
+  TraceEvent *event;
+  FILE *fd;
+  const char *sep = "";
+  const char *c;
+  size_t first;
+  size_t i;
+  int pid;
+
+  if (!trace_file) return;
+
+  pthread_mutex_lock( &trace_mutex );
+  fd = fopen( trace_file, "w" );
+  if (!fd) {
+    pthread_mutex_unlock( &trace_mutex );
+    fprintf( stderr, "HDS: Unable to open trace file '%s'\n", trace_file );
+    return;
+  }
+
+  pid = (int)getpid();
+  fprintf( fd, "{\"traceEvents\":[" );
+  for (ring = all_rings; ring; ring = ring->next) {
+    fprintf( fd, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+             "\"tid\":%d,\"args\":{\"name\":\"HDS thread %d\"}}", sep, pid,
+             ring->tid, ring->tid );
+    sep = ",";
+
+    /* Oldest first */
+    first = (ring->nevent > ring->size ? ring->nevent - ring->size : 0);
+    for (i = first; i < ring->nevent; i++) {
+      event = &(ring->events[ i % ring->size ]);
+      fprintf( fd, ",\n{\"name\":\"%s\",\"cat\":\"hds\",\"ph\":\"X\","
+               "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+               "\"args\":{\"bytes\":%zu,\"object\":\"", event->name,
+               1.0E-3 * (event->start - trace_origin),
+               1.0E-3 * (event->end > event->start ?
+                         event->end - event->start : 0),
+               pid, ring->tid, event->nbytes );
+      for (c = event->path; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc( '\\', fd );
+        if ((unsigned char)*c >= ' ') fputc( *c, fd );
+      }
+      fprintf( fd, "\"}}" );
+    }
+  }
+  fprintf( fd, "\n],\"displayTimeUnit\":\"ns\"}\n" );
+
+  if (fclose( fd ) != 0) {
+    fprintf( stderr, "HDS: Error writing trace file '%s'\n", trace_file );
+  }
+  pthread_mutex_unlock( &trace_mutex );
+}
+
+static void hds1TraceInit( void ) {
+  const char *name = getenv( "HDS_TRACE_FILE" );
+  const char *nevent = getenv( "HDS_TRACE_EVENTS" );
+  long ival;
+
+  if (!name || !name[0]) return;
+  if (nevent) {
+    ival = strtol( nevent, NULL, 10 );
+    if (ival > 0) trace_nevent = ival;
+  }
+  if (pthread_key_create( &ring_key, hds1TraceEnded ) != 0) return;
+  trace_origin = hds1MetricsClock();
+  trace_file = strdup( name );
+  if (trace_file) atexit( hds1TraceAtExit );
+}
+
+/* Form the HDS path of the object described by "handle" in "path",
+   which has room for HDS1_TRACE_SZPATH characters. The Handle at the top
+   of the tree describes the file, and also the top level object unless
+   that has a Handle of its own. The name of the top level object is only
+   available if its path has already been cached by dat1HandlePath, so
+   otherwise the file name (without directory or extension) is used. A
+   cell of a structure array is appended without a dot, as in
+   dat1HandlePath. */
+static void hds1TracePath( const Handle *handle, char *path ) {
+  char names[HDS1_TRACE_MAXLEV][HDS1_TRACE_SZPATH];
+  hdsbool_t isroot[HDS1_TRACE_MAXLEV];
+  hdsbool_t iscached[HDS1_TRACE_MAXLEV];
+  hdsbool_t istop[HDS1_TRACE_MAXLEV];
+  const Handle *parent;
+  const char *name;
+  const char *dot;
+  size_t cellen = strlen( DAT__CELLNAME );
+  size_t used = 0;
+  int nlev = 0;
+  int len;
+  int i;
+
+  /* Copy what is needed from each Handle while it is locked, since a
+     rename in another thread frees the old name and path */
+  path[0] = '\0';
+  for ( ; handle && nlev < HDS1_TRACE_MAXLEV; handle = parent) {
+    pthread_mutex_lock( (pthread_mutex_t *)&(handle->mutex) );
+    parent = handle->parent;
+    isroot[nlev] = !parent;
+    iscached[nlev] = ( !parent && handle->path );
+    istop[nlev] = handle->toplevel;
+    name = ( iscached[nlev] ? handle->path : handle->name );
+    if (name) {
+      snprintf( names[nlev], HDS1_TRACE_SZPATH, "%s", name );
+    } else {
+      names[nlev][0] = '\0';
+    }
+    pthread_mutex_unlock( (pthread_mutex_t *)&(handle->mutex) );
+    nlev++;
+  }
+
+  for (i = nlev - 1; i >= 0 && used < HDS1_TRACE_SZPATH - 1; i--) {
+    name = names[i];
+    if (!name[0]) continue;
+    if (isroot[i]) {
+      if (i > 0 && istop[i-1]) continue;
+      if (!iscached[i]) {
+        if (strrchr( name, '/' )) name = strrchr( name, '/' ) + 1;
+        len = snprintf( path, HDS1_TRACE_SZPATH, "%.*s",
+                        (int)strcspn( name, "." ), name );
+        if (len < 0) break;
+        used = len;
+        continue;
+      }
+    }
+    if (!strncmp( name, DAT__CELLNAME "(", cellen + 1 )) {
+      name += cellen;
+      dot = "";
+    } else {
+      dot = (used ? "." : "");
+    }
+    len = snprintf( path + used, HDS1_TRACE_SZPATH - used, "%s%s", dot,
+                    name );
+    if (len < 0) break;
+    used += len;
+  }
+}
+
+/* Called when a thread that has recorded events ends. Its ring is shrunk
+   to hold just the events recorded, and the ring of the thread that
+   ended longest ago is freed if too many are being kept. */
+static void hds1TraceEnded( void *arg ) {
+  TraceRing *ring = arg;
+  TraceRing *oldest = NULL;
+  TraceRing **prev;
+  TraceEvent *events;
+
+  pthread_mutex_lock( &trace_mutex );
+  if (ring->nevent < ring->size) {
+    events = realloc( ring->events, ( ring->nevent > 0 ? ring->nevent : 1 ) *
+                      sizeof(*events) );
+    if (events) {
+      ring->events = events;
+      ring->size = ( ring->nevent > 0 ? ring->nevent : 1 );
+    }
+  }
+  ring->ended = ++nended;
+
+  for (prev = &all_rings; *prev; prev = &((*prev)->next)) {
+    if ((*prev)->ended > 0 && (*prev)->ended <= nended - HDS1_TRACE_MAXENDED) {
+      oldest = *prev;
+      *prev = oldest->next;
+      break;
+    }
+  }
+  pthread_mutex_unlock( &trace_mutex );
+
+  if (oldest) {
+    free( oldest->events );
+    free( oldest );
+  }
+}
+
+static void hds1TraceAtExit( void ) {
+  hds1TraceWrite();
+}
@@ -862,6 +862,103 @@ void hds1ShowFiles( hdsbool_t listfiles, hdsbool_t listlocs, int * status  ){
    UNLOCK_MUTEX;
 }
 
+/* -----------------------------------------------------------------
+   Report the data transferred to and from each registered file, together
+   with the size of the file and the state of its HDF5 caches. Used by
+   hdsShow("DATA"). HDF5 does not keep hit counts for the raw data chunk
+   cache, so only its configuration is shown. */
+
+void hds1ShowData( int * status ){
+
+/* Local Variables: */
+   HDSLoc *loc;
+   Handle *top;
+   HdsFile *hdsFile;
+   HdsFileIO io;
+   double hitrate;
+   double w0;
+   hid_t fapl_id;
+   hid_t file_id;
+   hid_t objid;
+   hsize_t filesize;
+   int mdc_nelmts;
+   int num_files;
+   size_t nslots;
+   size_t nbytes;
+
+/* Check inherited status */
+   if( *status != SAI__OK ) return;
+
+/* Lock the mutex that serialises access to the registry */
+   LOCK_MUTEX;
+
+/* Print the number of registered files. */
+   num_files = HASH_COUNT( hdsFiles );
+   printf("HDS data transfers: %d file%s\n", num_files,( num_files == 1 ? "" : "s"));
+
+/* Loop over all registered files. */
+   hdsFile = hdsFiles;
+   while( hdsFile && *status == SAI__OK ) {
+      printf( "File: %s\n", hdsFile->path );
+
+/* Find a locator with a handle, preferring a primary one. */
+      loc = hdsFile->primhead;
+      while( loc && !loc->handle ) loc = loc->prev;
+      if( !loc ) {
+         loc = hdsFile->sechead;
+         while( loc && !loc->handle ) loc = loc->prev;
+      }
+
+/* Take a copy of the totals from the top level handle. */
+      memset( &io, 0, sizeof(io) );
+      if( loc ) {
+         top = dat1TopHandle( loc->handle, status );
+         if( top ) {
+            pthread_mutex_lock( &(top->mutex) );
+            io = top->io;
+            pthread_mutex_unlock( &(top->mutex) );
+         }
+      }
+
+      printf( "   Reads: %zu (%zu bytes)  Writes: %zu (%zu bytes)\n",
+              io.nread, io.bytes_read, io.nwrite, io.bytes_written );
+      printf( "   Mapped: %zu bytes from the file, %zu bytes copied\n",
+              io.bytes_mmap, io.bytes_copymap );
+
+/* Ask HDF5 about the file itself. */
+      file_id = 0;
+      objid = ( loc ? dat1RetrieveIdentifier( loc, status ) : 0 );
+      if( objid > 0 ) file_id = H5Iget_file_id( objid );
+      if( file_id > 0 ) {
+         if( H5Fget_filesize( file_id, &filesize ) >= 0 ) {
+            printf( "   File size: %llu bytes\n", (unsigned long long)filesize );
+         }
+         if( H5Fget_mdc_hit_rate( file_id, &hitrate ) >= 0 ) {
+            printf( "   Metadata cache hit rate: %.3f\n", hitrate );
+         }
+         fapl_id = H5Fget_access_plist( file_id );
+         if( fapl_id > 0 ) {
+            if( H5Pget_cache( fapl_id, &mdc_nelmts, &nslots, &nbytes,
+                              &w0 ) >= 0 ) {
+               printf( "   Chunk cache: %zu slots, %zu bytes, w0=%.2f\n",
+                       nslots, nbytes, w0 );
+            }
+            H5Pclose( fapl_id );
+         }
+         H5Fclose( file_id );
+      }
+
+/* Ignore any HDF5 errors - this is only a report. */
+      H5Eclear2( H5E_DEFAULT );
+
+/* Move on to the next HdsFile structure. */
+      hdsFile = hdsFile->hh.next;
+   }
+
+/* Unlock the mutex that serialises access to the registry */
+   UNLOCK_MUTEX;
+}
+
 
 static int hds2CompareId( const void *a, const void *b ){
    hid_t *pa = (hid_t *) a;
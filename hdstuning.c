@@ -1,5 +1,12 @@
 #include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+#include <fnmatch.h>
+#include <unistd.h>
+
+#include "hdf5.h"
 
 #include "ems.h"
 #include "sae_par.h"
@@ -12,8 +19,9 @@
 
 /* Variable storing tuned state */
 
-/* Indicates that we have looked at the environment */
-static hdsbool_t HAVE_INITIALIZED_V5_TUNING = 0;
+/* Ensures that the environment is looked at only once, even if several
+   threads need a tuning parameter at the same time */
+static pthread_once_t HAVE_INITIALIZED_V5_TUNING = PTHREAD_ONCE_INIT;
 
 /* These are all the parameters that can be tuned along
    with their defaults. */
@@ -28,22 +36,149 @@ static hdsbool_t HDS_MAP = HDS_TRUE; /* Do mmap by default when possible */
 
 static hdsbool_t HDS_LOCKCHECK = HDS_TRUE; /* Perform locking checks by default */
 
+/* Should new container files store their metadata compactly in
+   filesystem-sized pages: 1 (yes), 0 (no) */
+
+static hdsbool_t HDS_COMPACT = HDS_FALSE; /* Use HDF5 default layout */
+
+/* Size of the HDF5 page buffer, in KiB, used when opening files
+   created with compact metadata. Zero disables the page buffer. */
+
+static int HDS_PAGEBUF = 0;
+
+/* Maximum memory, in MiB, that may be held by mapped data waiting to be
+   written in the background after datUnmap. Zero means datUnmap writes
+   the data before returning. */
+
+static int HDS_WRITEBEHIND = 0;
+
+/* Size, in MiB, at and above which datMap buffers that are not mapped
+   from the file are backed by huge pages. Zero disables huge pages. */
+
+static int HDS_HUGEPAGE = 0;
+
+/* Should call counts and timings be gathered: 1 (yes), 0 (no) */
+
+static hdsbool_t HDS_STATS = HDS_FALSE;
+
+/* Size, in KiB, of the chunks in which new primitives larger than this
+   are stored. Zero stores all primitives contiguously. */
+
+static int HDS_CHUNK = 0;
+
+/* Largest allowed chunk size, in KiB. HDF5 limits chunks to 4GiB. */
+#define HDS1_MAX_CHUNK (1024*1024)
+
+/* Deflate compression level (1-9) used for new chunked primitives. Zero
+   disables compression. */
+
+static int HDS_COMPRESS = 0;
+
+/* Size, in KiB, of the HDF5 chunk cache of each dataset. Zero uses the
+   HDF5 default. */
+
+static int HDS_CHUNKCACHE = 0;
+
+/* Initial size, in KiB, of the HDF5 metadata cache of each file. Zero
+   uses the HDF5 default. */
+
+static int HDS_MDCACHE = 0;
+
+/* Size, in KiB, of the HDF5 sieve buffer through which contiguous data
+   are read ahead and written. Zero uses the HDF5 default. */
+
+static int HDS_SIEVEBUF = 0;
+
+/* The HDS Classic parameters that have HDF5 equivalents. NBLOCKS is the
+   size of the transfer buffer, NCOM the expected number of components
+   in a structure and INAL the initial file allocation, the last two in
+   512-byte blocks. Zero uses the HDF5 defaults. */
+
+static int HDS_NBLOCKS = 0;
+static int HDS_NCOM = 0;
+static int HDS_INAL = 0;
+
+/* Number of contiguous pieces of a hyperslab selection that HDF5 works
+   on at once during a transfer. Zero uses the HDF5 default. */
+
+static int HDS_HYPERVEC = 0;
+
+/* Number of threads that read and write whole chunks of primitives
+   directly. Zero disables direct chunk transfers. Negative means one per
+   processor, up to HDS1_DEF_CHUNKIO. */
+
+static int HDS_CHUNKIO = 0;
+
+/* Default and largest number of direct chunk transfer threads */
+#define HDS1_DEF_CHUNKIO 8
+#define HDS1_MAX_CHUNKIO 64
+
+/* Tuning parameter values that apply only to container files with paths
+   matching a pattern, read from a tuning file. The tuning file is read
+   under pthread_once before any rule is used, and the rules do not
+   change afterwards, so they are not protected by a mutex. The last
+   matching rule wins. */
+
+typedef struct TuneRule {
+  char *glob;           /* Pattern matched against the absolute path */
+  const char *param;    /* Parameter name, from "file_params" */
+  int value;            /* Value to use */
+} TuneRule;
+
+static TuneRule *tune_rules = NULL;
+static size_t ntune_rules = 0;
+
+/* The parameters that may be given for individual container files */
+
+static const char *file_params[] = { "MAP", "CHUNK", "COMPRESS", "CHUNKCACHE",
+                                     "MDCACHE", "SIEVEBUF", "PAGEBUF",
+                                     "COMPACT", "NCOM", "INAL", NULL };
+
 /* A mutex used to serialise access to the getters and setters so that
    multiple threads do not try to access the global data simultaneously. */
 static pthread_mutex_t mutex1 = PTHREAD_MUTEX_INITIALIZER;
 #define LOCK_MUTEX pthread_mutex_lock( &mutex1 );
 #define UNLOCK_MUTEX pthread_mutex_unlock( &mutex1 );
 
-/* Parse tuning environment variables. Should only be called once the
-   first time a tuning parameter is required */
+/* Parse tuning environment variables. hds1InitTuneEnvironment is
+   called once, by hds1ReadTuneEnvironment, the first time a tuning
+   parameter is required */
 
 static void hds1SetShell( hds_shell_t shell);
 static void hds1SetUseMmap( hdsbool_t use_mmap );
 static void hds1SetLockCheck( hdsbool_t lock_check );
+static void hds1SetCompact( hdsbool_t compact );
+static void hds1SetPageBuf( int pagebuf );
+static void hds1SetWriteBehind( int writebehind );
+static void hds1SetHugePage( int hugepage );
+static void hds1SetStats( hdsbool_t stats );
+static void hds1SetChunk( int chunk );
+static void hds1SetCompress( int compress );
+static void hds1SetChunkCache( int chunkcache );
+static void hds1SetMdCache( int mdcache );
+static void hds1SetSieveBuf( int sievebuf );
+static void hds1SetNblocks( int nblocks );
+static void hds1SetNcom( int ncom );
+static void hds1SetInal( int inal );
+static void hds1SetHyperVec( int hypervec );
+static void hds1SetChunkIO( int chunkio );
+static int hds1SetTune( const char *param_str, int value, int *status );
+static void hds1ReadTuneFile( const char *path );
+static void hds1AddTuneRule( const char *glob, const char *param, int value );
+static void hds1InitTuneEnvironment( void );
 
 static void hds1ReadTuneEnvironment () {
+  pthread_once( &HAVE_INITIALIZED_V5_TUNING, hds1InitTuneEnvironment );
+}
+
+static void hds1InitTuneEnvironment () {
   int itemp = 0;
-  if (HAVE_INITIALIZED_V5_TUNING) return;
+  const char *tunefile = NULL;
+
+  /* Values from a tuning file come first so that they can be overridden
+     by individual environment variables */
+  tunefile = getenv( "HDS_TUNE_FILE" );
+  if (tunefile && tunefile[0]) hds1ReadTuneFile( tunefile );
 
   /* dat1Getenv solely knows about environment variables
      with integers and not about range checking so we do the range check
@@ -61,7 +196,212 @@ static void hds1ReadTuneEnvironment () {
   dat1Getenv( "HDS_LOCKCHECK", HDS_LOCKCHECK, &itemp );
   hds1SetLockCheck( itemp ? HDS_TRUE : HDS_FALSE );
 
-  HAVE_INITIALIZED_V5_TUNING = 1;
+  itemp = (HDS_COMPACT ? 1 : 0);
+  dat1Getenv( "HDS_COMPACT", HDS_COMPACT, &itemp );
+  hds1SetCompact( itemp ? HDS_TRUE : HDS_FALSE );
+
+  itemp = HDS_PAGEBUF;
+  dat1Getenv( "HDS_PAGEBUF", HDS_PAGEBUF, &itemp );
+  hds1SetPageBuf( itemp );
+
+  itemp = HDS_WRITEBEHIND;
+  dat1Getenv( "HDS_WRITEBEHIND", HDS_WRITEBEHIND, &itemp );
+  hds1SetWriteBehind( itemp );
+
+  itemp = HDS_HUGEPAGE;
+  dat1Getenv( "HDS_HUGEPAGE", HDS_HUGEPAGE, &itemp );
+  hds1SetHugePage( itemp );
+
+  itemp = (HDS_STATS ? 1 : 0);
+  dat1Getenv( "HDS_STATS", HDS_STATS, &itemp );
+  hds1SetStats( itemp ? HDS_TRUE : HDS_FALSE );
+
+  itemp = HDS_CHUNK;
+  dat1Getenv( "HDS_CHUNK", HDS_CHUNK, &itemp );
+  hds1SetChunk( itemp );
+
+  itemp = HDS_COMPRESS;
+  dat1Getenv( "HDS_COMPRESS", HDS_COMPRESS, &itemp );
+  hds1SetCompress( itemp );
+
+  itemp = HDS_CHUNKCACHE;
+  dat1Getenv( "HDS_CHUNKCACHE", HDS_CHUNKCACHE, &itemp );
+  hds1SetChunkCache( itemp );
+
+  itemp = HDS_MDCACHE;
+  dat1Getenv( "HDS_MDCACHE", HDS_MDCACHE, &itemp );
+  hds1SetMdCache( itemp );
+
+  itemp = HDS_SIEVEBUF;
+  dat1Getenv( "HDS_SIEVEBUF", HDS_SIEVEBUF, &itemp );
+  hds1SetSieveBuf( itemp );
+
+  itemp = HDS_NBLOCKS;
+  dat1Getenv( "HDS_NBLOCKS", HDS_NBLOCKS, &itemp );
+  hds1SetNblocks( itemp );
+
+  itemp = HDS_NCOM;
+  dat1Getenv( "HDS_NCOM", HDS_NCOM, &itemp );
+  hds1SetNcom( itemp );
+
+  itemp = HDS_INAL;
+  dat1Getenv( "HDS_INAL", HDS_INAL, &itemp );
+  hds1SetInal( itemp );
+
+  itemp = HDS_HYPERVEC;
+  dat1Getenv( "HDS_HYPERVEC", HDS_HYPERVEC, &itemp );
+  hds1SetHyperVec( itemp );
+
+  itemp = HDS_CHUNKIO;
+  dat1Getenv( "HDS_CHUNKIO", HDS_CHUNKIO, &itemp );
+  hds1SetChunkIO( itemp );
+}
+
+/* Apply the tuning parameters given in a file. Each line gives the name
+   of a parameter and an integer value, separated by spaces or an equals
+   sign. A line holding a pattern in square brackets starts a section
+   whose values apply only to container files with absolute paths that
+   match the pattern (see hds1TuneFile). Blank lines and anything
+   following a "#" are ignored, as are lines that cannot be understood,
+   since there is no way to report errors at this point. Files written
+   by "hdsBench io" have this form. */
+
+static void hds1ReadTuneFile( const char *path ) {
+  FILE *fd = NULL;
+  char line[1024];
+  char glob[1024];
+  char name[32];
+  char *cpnt;
+  char *endp;
+  size_t n;
+  long value;
+  int lstat = SAI__OK;
+
+  fd = fopen( path, "r" );
+  if (!fd) return;
+
+  glob[0] = '\0';
+  emsMark();
+  while (fgets( line, sizeof(line), fd )) {
+    cpnt = strchr( line, '#' );
+    if (cpnt) *cpnt = '\0';
+
+    /* Start of a section */
+    cpnt = line;
+    while (isspace( (unsigned char)*cpnt )) cpnt++;
+    if (*cpnt == '[') {
+      endp = strrchr( cpnt, ']' );
+      if (endp && endp > cpnt + 1) {
+        *endp = '\0';
+        strcpy( glob, cpnt + 1 );
+      }
+      continue;
+    }
+
+    /* Parameter name, in upper case as used by the per-file rules */
+    cpnt = line;
+    while (isspace( (unsigned char)*cpnt )) cpnt++;
+    n = 0;
+    while (isalnum( (unsigned char)*cpnt ) && n < sizeof(name) - 1) {
+      name[n++] = toupper( (unsigned char)*cpnt );
+      cpnt++;
+    }
+    name[n] = '\0';
+    if (n == 0) continue;
+
+    /* Separator and value */
+    while (isspace( (unsigned char)*cpnt ) || *cpnt == '=') cpnt++;
+    value = strtol( cpnt, &endp, 10 );
+    if (endp == cpnt) continue;
+
+    if (glob[0]) {
+      hds1AddTuneRule( glob, name, (int)value );
+    } else {
+      hds1SetTune( name, (int)value, &lstat );
+      if (lstat != SAI__OK) emsAnnul( &lstat );
+    }
+  }
+  emsRlse();
+
+  fclose( fd );
+}
+
+/* Record a value for a parameter that applies to container files with
+   paths matching "glob". Ignored if the parameter can not be given for
+   individual files. */
+
+static void hds1AddTuneRule( const char *glob, const char *param, int value ) {
+  TuneRule *newrules;
+  int i;
+
+  for (i = 0; file_params[i]; i++) {
+    if (strcmp( param, file_params[i] ) == 0) break;
+  }
+  if (!file_params[i]) return;
+
+  newrules = MEM_REALLOC( tune_rules, (ntune_rules + 1) * sizeof(*newrules) );
+  if (!newrules) return;
+  tune_rules = newrules;
+
+  tune_rules[ntune_rules].glob = MEM_MALLOC( strlen( glob ) + 1 );
+  if (!tune_rules[ntune_rules].glob) return;
+  strcpy( tune_rules[ntune_rules].glob, glob );
+  tune_rules[ntune_rules].param = file_params[i];
+
+  /* The same limits as the setters */
+  if (value < 0) value = 0;
+  if (strcmp( param, "CHUNK" ) == 0 && value > HDS1_MAX_CHUNK) {
+    value = HDS1_MAX_CHUNK;
+  } else if (strcmp( param, "COMPRESS" ) == 0 && value > 9) {
+    value = 9;
+  }
+  tune_rules[ntune_rules].value = value;
+  ntune_rules++;
+}
+
+/* Return the value of tuning parameter "param" that applies to the
+   container file "fname", given its global value "value". This is the
+   value from the last section of the tuning file with a pattern that
+   matches the absolute path of the file, or "value" if there is none.
+   The pattern is matched using fnmatch without flags, so "*" matches
+   any number of directory levels. */
+
+int hds1TuneFile( const char *fname, const char *param, int value ) {
+  char cwd[1024];
+  char *abspath = NULL;
+  size_t i;
+
+  hds1ReadTuneEnvironment();
+  if (ntune_rules == 0 || !fname || !fname[0]) return value;
+
+  if (fname[0] != '/' && getcwd( cwd, sizeof(cwd) )) {
+    abspath = MEM_MALLOC( strlen( cwd ) + strlen( fname ) + 2 );
+    if (!abspath) return value;
+    sprintf( abspath, "%s/%s", cwd, fname );
+  }
+
+  for (i = 0; i < ntune_rules; i++) {
+    if (strcmp( tune_rules[i].param, param ) == 0 &&
+        fnmatch( tune_rules[i].glob, (abspath ? abspath : fname), 0 ) == 0) {
+      value = tune_rules[i].value;
+    }
+  }
+
+  if (abspath) MEM_FREE( abspath );
+  return value;
+}
+
+/* As hds1TuneFile, but for the container file holding HDF5 object
+   "objid". The file name is only looked up if it might be needed. */
+
+int hds1TuneObject( hid_t objid, const char *param, int value ) {
+  char fname[1024];
+
+  hds1ReadTuneEnvironment();
+  if (ntune_rules == 0) return value;
+
+  if (H5Fget_name( objid, fname, sizeof(fname) ) <= 0) return value;
+  return hds1TuneFile( fname, param, value );
 }
 
 
@@ -98,8 +438,101 @@ static void hds1ReadTuneEnvironment () {
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Supports MAP and SHELL tuning parameters
-*     - Other HDS Classic tuning parameters are ignored.
+*     - Supports MAP, SHELL, LOCKCHECK, COMPACT, PAGEBUF, WRITEBEHIND,
+*       HUGEPAGE, STATS, CHUNK, COMPRESS, CHUNKCACHE, MDCACHE, SIEVEBUF,
+*       NBLOCKS, NCOM, INAL, HYPERVEC and CHUNKIO tuning parameters
+*     - Parameter names are not case sensitive, as in hdsGtune.
+*     - COMPACT: if non-zero, new container files are created with their
+*       metadata packed into filesystem-sized pages and with compact
+*       group and attribute storage. Files created this way need HDF5
+*       1.10 or later to read them.
+*     - PAGEBUF: size in KiB of the HDF5 page buffer used when opening
+*       a container file created with COMPACT set. Zero (the default)
+*       disables the page buffer. Ignored for other files.
+*     - WRITEBEHIND: maximum memory in MiB that may be held by mapped
+*       data that datUnmap has handed to a background thread to be
+*       written. Zero (the default) means datUnmap writes the data
+*       itself before returning. See hdsSync.
+*     - HUGEPAGE: size in MiB at and above which datMap buffers that are
+*       not memory mapped from the file are backed by huge pages. Zero
+*       (the default) disables huge pages. The number of such buffers
+*       in use is returned by hdsInfoI topic HUGEPAGES.
+*     - STATS: if non-zero, the number of calls, bytes transferred and
+*       time taken are recorded for the main HDS routines and for
+*       internal stages such as HDF5 reads and writes. They are
+*       reported when the program exits, by hdsStop, or on demand by
+*       hdsInfoI topic STATS.
+*     - CHUNK: size in KiB of the chunks in which new primitives larger
+*       than this are stored. Each chunk holds whole rows or planes of
+*       the array where possible. Zero (the default) stores primitives
+*       contiguously. Chunked primitives cannot be memory mapped from the
+*       file, but may be faster to read in pieces. The largest allowed
+*       value is 1048576 (1GiB).
+*     - COMPRESS: deflate (gzip) compression level, 1 to 9, used for new
+*       primitives that are stored in chunks (see CHUNK). Zero (the
+*       default) disables compression.
+*     - CHUNKCACHE: size in KiB of the HDF5 cache of chunks kept for each
+*       dataset in a file when it is opened. Zero (the default) uses the
+*       HDF5 default of 1MiB.
+*     - MDCACHE: initial size in KiB of the HDF5 metadata cache of a file
+*       when it is opened. Zero (the default) uses the HDF5 default.
+*     - SIEVEBUF: size in KiB of the HDF5 sieve buffer of a file when it
+*       is opened. Reads of small pieces of contiguous primitives read
+*       ahead this much of the file. Zero (the default) uses the HDF5
+*       default of 64KiB.
+*     - NBLOCKS: size of the buffer in which HDF5 converts data types
+*       during transfers, in 512-byte blocks. Larger buffers let large
+*       arrays that need type conversion be read and written in fewer
+*       pieces. Values below 128 are raised to 128 (64KiB) so that any
+*       HDS type fits. Zero (the default) uses the HDF5 default of 1MiB.
+*     - HYPERVEC: the number of contiguous pieces of a slice or other
+*       selection that HDF5 handles at once during a transfer. Zero (the
+*       default) uses the HDF5 default of 1024.
+*     - CHUNKIO: the number of threads used to read and write the chunks
+*       of primitives stored in chunks (see CHUNK) directly, compressing
+*       and decompressing them (see COMPRESS) in parallel. This is done
+*       when whole chunks are transferred without type conversion by
+*       datGet, datPut, datMap and datUnmap. Zero (the default) leaves
+*       all chunk transfers to HDF5. A negative value uses one thread per
+*       processor, up to 8, so setting HDS_CHUNKIO to -1 in the
+*       environment is the simplest way to enable direct transfers. The
+*       threads are started when first needed and remain until the
+*       program exits. The largest allowed value is 64.
+*     - NCOM: the expected number of components in new structures, which
+*       is used to size their link storage. Zero (the default) uses the
+*       HDF5 default.
+*     - INAL: the initial file allocation, in 512-byte blocks. New
+*       container files allocate space for metadata in blocks of this
+*       size. Zero (the default) uses the HDF5 default of 2KiB.
+*     - Other HDS Classic tuning parameters (MAXW, SYSL, WAIT and 64BIT)
+*       are ignored.
+*     - The initial values of the parameters are read from environment
+*       variables with names formed by prefixing "HDS_" to the parameter
+*       name (e.g. HDS_MAP). Before these, if the environment variable
+*       HDS_TUNE_FILE is set to the name of a file, parameter values are
+*       read from that file. Each line of the file gives a parameter
+*       name and value, separated by spaces or "=", and "#" starts a
+*       comment. The "io" mode of the hdsBench program writes such a
+*       file holding the values that work best on the local system.
+*       These are only defaults: they are read before the first value
+*       is set by hdsTune and never replace it.
+*     - A tuning file may also give values that apply only to some
+*       container files. A line holding a pattern in square brackets,
+*       e.g. "[/data/scratch*]", starts a section whose values apply to
+*       files with absolute paths that match the pattern, in the sense
+*       of fnmatch without flags (so that "*" also matches "/"). The
+*       last matching value is used. Only MAP, CHUNK, COMPRESS,
+*       CHUNKCACHE, MDCACHE, SIEVEBUF, PAGEBUF, COMPACT, NCOM and INAL
+*       may be given in a section. They take effect when a file is
+*       created or opened, when a primitive is mapped and when a new
+*       object is created, and override the values set by hdsTune.
+*     - Setting the environment variable HDS_TRACE_FILE (which is not
+*       a tuning parameter) to a file name records a timeline of the
+*       same routines and stages, including waits for objects locked
+*       by other threads, for every thread. It is written to the file
+*       in Chrome Trace Event format when the program exits or hdsStop
+*       is called. The environment variable HDS_TRACE_EVENTS sets the
+*       number of events kept for each thread (default 16384).
 
 *  History:
 *     2014-09-10 (TIMJ):
@@ -152,6 +585,20 @@ hdsTune(const char *param_str, int  value, int  *status) {
 
   if (*status != SAI__OK) return *status;
 
+  /* Apply the environment and any tuning file first, so that they do
+     not later replace the value given here */
+  hds1ReadTuneEnvironment();
+
+  return hds1SetTune( param_str, value, status );
+}
+
+/* Set a tuning parameter without first reading the environment. Used by
+   hdsTune and for the values in a tuning file. */
+
+static int hds1SetTune( const char *param_str, int value, int *status ) {
+
+  if (*status != SAI__OK) return *status;
+
   /* HDS supports options:
      - MAP: Mapping mode
      - INAL: Initial file allocation
@@ -163,31 +610,56 @@ hdsTune(const char *param_str, int  value, int  *status) {
      - SYSL: System wide locking flag
      - WAIT: Wait for locked files
 
-     INAL, MAXW, NBLOCKS, NCOM, SYSL and WAIT are all irrelevant.
+     MAXW, SYSL and WAIT are all irrelevant. INAL, NBLOCKS and NCOM
+     are mapped on to the nearest HDF5 equivalents.
 
      64BIT will have no effect as we are using whatever HDF5 gives us.
 
-     Only currently support SHELL and MAP.
-
-     Ignore the ones that are irrelevant. Warn about those that
-     might become relevant.
+     Ignore the ones that are irrelevant.
 
   */
 
-  if (strncmp( param_str, "INAL", 4 ) == 0 ||
-      strncmp( param_str, "64BIT", 5 ) == 0 ||
-      strncmp( param_str, "MAXW", 4 ) == 0 ||
-      strncmp( param_str, "NBLO", 4 ) == 0 ||
-      strncmp( param_str, "NCOM", 4 ) == 0 ||
-      strncmp( param_str, "SYSL", 4 ) == 0 ||
-      strncmp( param_str, "WAIT", 4 ) == 0 ) {
+  if (strncasecmp( param_str, "64BIT", 5 ) == 0 ||
+      strncasecmp( param_str, "MAXW", 4 ) == 0 ||
+      strncasecmp( param_str, "SYSL", 4 ) == 0 ||
+      strncasecmp( param_str, "WAIT", 4 ) == 0 ) {
     /* Irrelevant for HDF5 */
-  } else if (strncmp( param_str, "MAP", 3) == 0 ) {
+  } else if (strncasecmp( param_str, "INAL", 4 ) == 0) {
+    hds1SetInal( value );
+  } else if (strncasecmp( param_str, "NBLO", 4 ) == 0) {
+    hds1SetNblocks( value );
+  } else if (strncasecmp( param_str, "NCOM", 4 ) == 0) {
+    hds1SetNcom( value );
+  } else if (strncasecmp( param_str, "MAP", 3) == 0 ) {
     hds1SetUseMmap( value ? HDS_TRUE : HDS_FALSE );
-  } else if (strncmp( param_str, "LOCKCHECK", 9) == 0 ) {
+  } else if (strncasecmp( param_str, "LOCKCHECK", 9) == 0 ) {
     hds1SetLockCheck( value ? HDS_TRUE : HDS_FALSE );
-  } else if (strncmp( param_str, "SHEL", 4) == 0) {
+  } else if (strncasecmp( param_str, "SHEL", 4) == 0) {
     hds1SetShell( value );
+  } else if (strncasecmp( param_str, "COMPACT", 7) == 0) {
+    hds1SetCompact( value ? HDS_TRUE : HDS_FALSE );
+  } else if (strncasecmp( param_str, "PAGEBUF", 7) == 0) {
+    hds1SetPageBuf( value );
+  } else if (strncasecmp( param_str, "WRITEBEHIND", 11) == 0) {
+    hds1SetWriteBehind( value );
+  } else if (strncasecmp( param_str, "HUGEPAGE", 8) == 0) {
+    hds1SetHugePage( value );
+  } else if (strncasecmp( param_str, "STATS", 5) == 0) {
+    hds1SetStats( value ? HDS_TRUE : HDS_FALSE );
+  } else if (strncasecmp( param_str, "CHUNKCACHE", 10) == 0) {
+    hds1SetChunkCache( value );
+  } else if (strncasecmp( param_str, "CHUNKIO", 7) == 0) {
+    hds1SetChunkIO( value );
+  } else if (strncasecmp( param_str, "CHUNK", 5) == 0) {
+    hds1SetChunk( value );
+  } else if (strncasecmp( param_str, "COMPRESS", 8) == 0) {
+    hds1SetCompress( value );
+  } else if (strncasecmp( param_str, "MDCACHE", 7) == 0) {
+    hds1SetMdCache( value );
+  } else if (strncasecmp( param_str, "SIEVEBUF", 8) == 0) {
+    hds1SetSieveBuf( value );
+  } else if (strncasecmp( param_str, "HYPERVEC", 8) == 0) {
+    hds1SetHyperVec( value );
   } else {
     *status = DAT__NAMIN;
     emsRepf("hdsTune_1", "hdsTune: Unknown tuning parameter '%s'",
@@ -232,7 +704,11 @@ hdsTune(const char *param_str, int  value, int  *status) {
 *     {enter_new_authors_here}
 
 *  Notes:
-*     - Supports MAP and SHELL options.
+*     - Supports MAP, SHELL, LOCKCHECK, COMPACT, PAGEBUF, WRITEBEHIND,
+*       HUGEPAGE, STATS, CHUNK, COMPRESS, CHUNKCACHE, MDCACHE, SIEVEBUF,
+*       NBLOCKS, NCOM, INAL, HYPERVEC and CHUNKIO options.
+*     - The values returned are the global values. Values given for
+*       individual container files in a tuning file are not included.
 *     - The SHELL tuning parameter does not use public
 *       constants but declares that (-1=no shell, 0=sh, 2=csh, 3=tcsh).
 *       This implementation only understands -1 and 0.
@@ -295,6 +771,36 @@ hdsGtune(const char *param_str, int *value, int *status) {
     *value = hds1GetUseMmap();
   } else if (strncasecmp(param_str, "LOCKCHECK", 9) == 0) {
     *value = hds1GetLockCheck();
+  } else if (strncasecmp(param_str, "COMPACT", 7) == 0) {
+    *value = hds1GetCompact();
+  } else if (strncasecmp(param_str, "PAGEBUF", 7) == 0) {
+    *value = hds1GetPageBuf();
+  } else if (strncasecmp(param_str, "WRITEBEHIND", 11) == 0) {
+    *value = hds1GetWriteBehind();
+  } else if (strncasecmp(param_str, "HUGEPAGE", 8) == 0) {
+    *value = hds1GetHugePage();
+  } else if (strncasecmp(param_str, "STATS", 5) == 0) {
+    *value = hds1GetStats();
+  } else if (strncasecmp(param_str, "CHUNKCACHE", 10) == 0) {
+    *value = hds1GetChunkCache();
+  } else if (strncasecmp(param_str, "CHUNKIO", 7) == 0) {
+    *value = hds1GetChunkIO();
+  } else if (strncasecmp(param_str, "CHUNK", 5) == 0) {
+    *value = hds1GetChunk();
+  } else if (strncasecmp(param_str, "COMPRESS", 8) == 0) {
+    *value = hds1GetCompress();
+  } else if (strncasecmp(param_str, "MDCACHE", 7) == 0) {
+    *value = hds1GetMdCache();
+  } else if (strncasecmp(param_str, "SIEVEBUF", 8) == 0) {
+    *value = hds1GetSieveBuf();
+  } else if (strncasecmp(param_str, "NBLO", 4) == 0) {
+    *value = hds1GetNblocks();
+  } else if (strncasecmp(param_str, "NCOM", 4) == 0) {
+    *value = hds1GetNcom();
+  } else if (strncasecmp(param_str, "INAL", 4) == 0) {
+    *value = hds1GetInal();
+  } else if (strncasecmp(param_str, "HYPERVEC", 8) == 0) {
+    *value = hds1GetHyperVec();
   } else {
     *status = DAT__NOTIM;
     emsRep("hdsGtune", "hdsGtune: Not yet implemented for HDF5",
@@ -360,3 +866,285 @@ static void hds1SetShell( hds_shell_t shell) {
   UNLOCK_MUTEX
   return;
 }
+
+hdsbool_t hds1GetCompact() {
+  hdsbool_t result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_COMPACT;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetCompact( hdsbool_t compact ) {
+  LOCK_MUTEX
+  HDS_COMPACT = compact;
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetPageBuf() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_PAGEBUF;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetPageBuf( int pagebuf ) {
+  /* Negative values disable the page buffer */
+  LOCK_MUTEX
+  HDS_PAGEBUF = ( pagebuf > 0 ? pagebuf : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetWriteBehind() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_WRITEBEHIND;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetWriteBehind( int writebehind ) {
+  /* Negative values disable write-behind */
+  LOCK_MUTEX
+  HDS_WRITEBEHIND = ( writebehind > 0 ? writebehind : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetHugePage() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_HUGEPAGE;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetHugePage( int hugepage ) {
+  /* Negative values disable huge pages */
+  LOCK_MUTEX
+  HDS_HUGEPAGE = ( hugepage > 0 ? hugepage : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+hdsbool_t hds1GetStats() {
+  hdsbool_t result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_STATS;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetStats( hdsbool_t stats ) {
+  LOCK_MUTEX
+  HDS_STATS = stats;
+  UNLOCK_MUTEX
+  hds1StatsEnable( stats );
+  return;
+}
+
+int hds1GetChunk() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_CHUNK;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetChunk( int chunk ) {
+  /* Negative values store primitives contiguously */
+  LOCK_MUTEX
+  if (chunk > HDS1_MAX_CHUNK) {
+    HDS_CHUNK = HDS1_MAX_CHUNK;
+  } else {
+    HDS_CHUNK = ( chunk > 0 ? chunk : 0 );
+  }
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetCompress() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_COMPRESS;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetCompress( int compress ) {
+  /* Negative values disable compression; the deflate maximum is 9 */
+  LOCK_MUTEX
+  if (compress > 9) {
+    HDS_COMPRESS = 9;
+  } else {
+    HDS_COMPRESS = ( compress > 0 ? compress : 0 );
+  }
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetChunkCache() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_CHUNKCACHE;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetChunkCache( int chunkcache ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_CHUNKCACHE = ( chunkcache > 0 ? chunkcache : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetMdCache() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_MDCACHE;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetMdCache( int mdcache ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_MDCACHE = ( mdcache > 0 ? mdcache : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetSieveBuf() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_SIEVEBUF;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetSieveBuf( int sievebuf ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_SIEVEBUF = ( sievebuf > 0 ? sievebuf : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetNblocks() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_NBLOCKS;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetNblocks( int nblocks ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_NBLOCKS = ( nblocks > 0 ? nblocks : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetNcom() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_NCOM;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetNcom( int ncom ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_NCOM = ( ncom > 0 ? ncom : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetInal() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_INAL;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetInal( int inal ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_INAL = ( inal > 0 ? inal : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetHyperVec() {
+  int result;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_HYPERVEC;
+  UNLOCK_MUTEX;
+  return result;
+}
+
+static void hds1SetHyperVec( int hypervec ) {
+  /* Negative values use the HDF5 default */
+  LOCK_MUTEX
+  HDS_HYPERVEC = ( hypervec > 0 ? hypervec : 0 );
+  UNLOCK_MUTEX
+  return;
+}
+
+int hds1GetChunkIO() {
+  int result;
+  long nproc;
+  /* Ensure that defaults have been read */
+  hds1ReadTuneEnvironment();
+  LOCK_MUTEX;
+  result = HDS_CHUNKIO;
+  UNLOCK_MUTEX;
+  if (result < 0) {
+    nproc = sysconf( _SC_NPROCESSORS_ONLN );
+    result = ( nproc < 1 ? 1 : nproc > HDS1_DEF_CHUNKIO ? HDS1_DEF_CHUNKIO : nproc );
+  }
+  return result;
+}
+
+static void hds1SetChunkIO( int chunkio ) {
+  /* Negative values use one thread per processor */
+  LOCK_MUTEX
+  HDS_CHUNKIO = ( chunkio > HDS1_MAX_CHUNKIO ? HDS1_MAX_CHUNKIO : chunkio );
+  UNLOCK_MUTEX
+  return;
+}
@@ -382,6 +382,28 @@ int main (int argc, char ** argv ) {
 	   "#define HDS_BOOL_FORMAT \"%s\"\n\n",
 	   "int", "d");
 
+  /* Callback used by datIterate. Uses "struct LOC" since the HDSLoc
+     typedef is hidden while building the library itself. */
+  fprintf( OutputFile,
+           "/* Callback function invoked by datIterate for each component */\n"
+           "struct LOC;\n"
+           "typedef int (*datIterFunc)( const struct LOC *locator, const char *name,\n"
+           "                            hdsbool_t isstruc, const char *type_str,\n"
+           "                            struct LOC *comploc, void *data, int *status );\n\n");
+
+  /* One entry in the list of components used by datGetBatch and
+     datPutBatch. */
+  fprintf( OutputFile,
+           "/* Describes one component read or written by datGetBatch/datPutBatch */\n"
+           "typedef struct HDSBatchItem {\n"
+           "  const char *name;    /* Name of the component */\n"
+           "  const char *type;    /* HDS type of the values in memory */\n"
+           "  int ndim;            /* Number of dimensions (0 for a scalar) */\n"
+           "  const hdsdim *dims;  /* Dimensions of the component */\n"
+           "  void *values;        /* Values to write, or buffer to receive them */\n"
+           "  int status;          /* Returned status for this component */\n"
+           "} HDSBatchItem;\n\n");
+
   fprintf(OutputFile,
 	  "#endif /* _INCLUDED */\n\n");
   fprintf(POutputFile,